@@ -0,0 +1,330 @@
+#include "difference_ntt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <limits.h>
+
+// 两个NTT模数，原根均为3；单个模数不够时用中国剩余定理合并，乘积约7.9·10^16
+#define MOD1 469762049u     // 7·2^26 + 1
+#define MOD2 167772161u     // 5·2^25 + 1
+#define PRIMITIVE_ROOT 3u
+
+// 记录错误信息
+static void set_error(char *error, size_t error_size, const char *format, ...) {
+    if (!error || error_size == 0) return;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+}
+
+static inline uint32_t mul_mod(uint32_t a, uint32_t b, uint32_t mod) {
+    return (uint32_t)((uint64_t)a * b % mod);
+}
+
+static uint32_t pow_mod(uint32_t base, uint64_t exp, uint32_t mod) {
+    uint32_t result = 1;
+    while (exp > 0) {
+        if (exp & 1) result = mul_mod(result, base, mod);
+        base = mul_mod(base, base, mod);
+        exp >>= 1;
+    }
+    return result;
+}
+
+// 蒙哥马利乘法的参数（R = 2^32），变换内部的数都以a·R mod p的形式保存，乘法不需要除法
+typedef struct {
+    uint32_t mod;
+    uint32_t neg_inv;       // -p⁻¹ mod 2^32
+    uint32_t r2;            // R² mod p，用于转入蒙哥马利形式
+} Montgomery;
+
+static void montgomery_init(Montgomery *m, uint32_t mod) {
+    // 牛顿迭代求p⁻¹ mod 2^32，每次迭代正确位数翻倍
+    uint32_t inv = mod;
+    for (int i = 0; i < 4; i++) inv *= 2 - mod * inv;
+    m->mod = mod;
+    m->neg_inv = (uint32_t)0 - inv;
+    uint64_t r = ((uint64_t)1 << 32) % mod;
+    m->r2 = (uint32_t)(r * r % mod);
+}
+
+// t·R⁻¹ mod p，要求t < p·2^32
+static inline uint32_t montgomery_reduce(const Montgomery *m, uint64_t t) {
+    uint32_t q = (uint32_t)t * m->neg_inv;
+    uint32_t r = (uint32_t)((t + (uint64_t)q * m->mod) >> 32);
+    return r >= m->mod ? r - m->mod : r;
+}
+
+static inline uint32_t montgomery_mul(const Montgomery *m, uint32_t a, uint32_t b) {
+    return montgomery_reduce(m, (uint64_t)a * b);
+}
+
+static inline uint32_t montgomery_from(const Montgomery *m, uint32_t a) {
+    return montgomery_mul(m, a, m->r2);
+}
+
+static inline uint32_t montgomery_to_int(const Montgomery *m, uint32_t a) {
+    return montgomery_reduce(m, a);
+}
+
+/**
+ * 预计算各层蝶形运算的单位根
+ * 参数：
+ *   roots: 长度n，roots[half + k] = w_len^k（len = 2·half，k < half），蒙哥马利形式
+ * 说明：
+ * 每层用到的单位根在表中连续存放，蝶形运算时顺序读取
+ */
+static void fill_roots(const Montgomery *m, uint32_t *roots, size_t n) {
+    for (size_t half = 1; half < n; half <<= 1) {
+        uint32_t w = montgomery_from(m, pow_mod(PRIMITIVE_ROOT, (m->mod - 1) / (2 * half), m->mod));
+        uint32_t wk = montgomery_from(m, 1);
+        for (size_t k = 0; k < half; k++) {
+            roots[half + k] = wk;
+            wk = montgomery_mul(m, wk, w);
+        }
+    }
+}
+
+/**
+ * 原地数论正变换 X[k] = Σ a[j]·w^(jk)，w = g^((p-1)/n)
+ * 参数：
+ *   a: 长度为n的数组（n为2的幂），蒙哥马利形式
+ * 算法原理：
+ * 迭代的Cooley-Tukey蝶形运算：先做位逆序置换，再自底向上合并长度为2、4……n的子变换
+ * 时间复杂度：O(n log n)
+ */
+static void ntt(const Montgomery *m, uint32_t *a, const uint32_t *roots, size_t n) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            uint32_t t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+    }
+
+    uint32_t mod = m->mod;
+    for (size_t half = 1; half < n; half <<= 1) {
+        const uint32_t *w = roots + half;
+        for (size_t i = 0; i < n; i += 2 * half) {
+            for (size_t k = 0; k < half; k++) {
+                uint32_t u = a[i + k];
+                uint32_t v = montgomery_mul(m, a[i + k + half], w[k]);
+                uint32_t sum = u + v;
+                a[i + k] = sum >= mod ? sum - mod : sum;
+                a[i + k + half] = u >= v ? u - v : u + mod - v;
+            }
+        }
+    }
+}
+
+/**
+ * 在一个模数下计算指示向量的自相关 c[d] = Σ x[t]·x[t+d]，d = 0..range
+ * 参数：
+ *   indicator: 长度range+1，indicator[v]为值min+v在A中的出现次数
+ *   work, roots: 长度为n的工作区，n不小于2·range+1
+ *   out: 输出c[d] mod p
+ * 算法原理：
+ * 把x与其逆序x'[v] = x[range-v]做卷积，(x*x')[range+d] = c[d]（n ≥ 2·range+1时没有回绕）。
+ * x'的变换无需单独计算：X'[k] = w^(k·range)·X[n-k]，
+ * 因此只做一次正变换，逐项乘积Y[k] = X[k]·X[n-k]·w^(k·range)，再做一次逆变换；
+ * 逆变换用正变换实现：结果下标取反（k → n-k）并除以n
+ */
+static void autocorrelate(uint32_t mod, const uint32_t *indicator, int range,
+                          uint32_t *work, uint32_t *roots, size_t n, uint32_t *out) {
+    Montgomery m;
+    montgomery_init(&m, mod);
+    fill_roots(&m, roots, n);
+
+    memset(work, 0, n * sizeof(uint32_t));
+    for (int v = 0; v <= range; v++) work[v] = montgomery_from(&m, indicator[v] % mod);
+    ntt(&m, work, roots, n);
+
+    // s = w^range；Y[k] = P·s^k，Y[n-k] = P·s^(-k)，其中P = X[k]·X[n-k]对两者相同
+    uint32_t root = pow_mod(PRIMITIVE_ROOT, (mod - 1) / n, mod);
+    uint32_t s_plain = pow_mod(root, (uint64_t)range, mod);
+    uint32_t s = montgomery_from(&m, s_plain);
+    uint32_t s_inv = montgomery_from(&m, pow_mod(s_plain, mod - 2, mod));
+    uint32_t sk = s, sk_inv = s_inv;
+    work[0] = montgomery_mul(&m, work[0], work[0]);
+    size_t k = 1;
+    for (; k < n - k; k++) {
+        uint32_t product = montgomery_mul(&m, work[k], work[n - k]);
+        work[k] = montgomery_mul(&m, product, sk);
+        work[n - k] = montgomery_mul(&m, product, sk_inv);
+        sk = montgomery_mul(&m, sk, s);
+        sk_inv = montgomery_mul(&m, sk_inv, s_inv);
+    }
+    if (k == n - k) {
+        work[k] = montgomery_mul(&m, montgomery_mul(&m, work[k], work[k]), sk);
+    }
+
+    ntt(&m, work, roots, n);
+    uint32_t inv_n = montgomery_from(&m, pow_mod((uint32_t)(n % mod), mod - 2, mod));
+    for (int d = 0; d <= range; d++) {
+        size_t index = (n - ((size_t)range + (size_t)d)) & (n - 1);
+        out[d] = montgomery_to_int(&m, montgomery_mul(&m, work[index], inv_n));
+    }
+}
+
+// A的点数与值域是否在NTT能精确处理的范围内
+bool difference_ntt_supported(const int *A, int N) {
+    if (!A || N < 2 || N > DIFFERENCE_NTT_MAX_POINTS) return false;
+    int lo = A[0], hi = A[0];
+    for (int i = 1; i < N; i++) {
+        if (A[i] < lo) lo = A[i];
+        if (A[i] > hi) hi = A[i];
+    }
+    return (long long)hi - lo <= DIFFERENCE_NTT_MAX_RANGE;
+}
+
+/**
+ * 用卷积计算A的差值直方图
+ * 参数：
+ *   A, N: 数列及其长度，不要求有序，可以有重复的点
+ *   hist: 输出，调用者用difference_histogram_free释放
+ *   error, error_size: 失败时写入错误信息
+ * 返回值：
+ *   成功返回0，失败返回-1（点数或值域超出限制、或内存不足）
+ * 算法原理：
+ * 1. 差值的多重集就是A的指示向量x（x[v]为值v的出现次数）的自相关：
+ *    c[d] = Σ x[v]·x[v+d] 恰为差为d的有序点对数，d>0时即为无序点对数；
+ *    c[0] = Σ x[v]² 包含N个点与自身的配对，无序点对数为(c[0]-N)/2
+ * 2. 自相关的每一项都不超过N²，N²小于第一个模数时一次变换即为精确值，
+ *    否则再在第二个模数下计算，用中国剩余定理合并；
+ *    两个模数之积约为7.9·10^16，点数超过DIFFERENCE_NTT_MAX_POINTS时N²可能越界，直接拒绝
+ * 时间复杂度：O(N + R log R)，R为值域，与点对个数N(N-1)/2无关
+ */
+int difference_histogram(const int *A, int N, DifferenceHistogram *hist,
+                         char *error, size_t error_size) {
+    memset(hist, 0, sizeof(*hist));
+    if (!A || N < 2) {
+        set_error(error, error_size, "至少需要两个数才能产生差值");
+        return -1;
+    }
+    if (!difference_ntt_supported(A, N)) {
+        set_error(error, error_size, "数列超过%d个点或值域超过%d，无法用卷积精确计算差值",
+                  DIFFERENCE_NTT_MAX_POINTS, DIFFERENCE_NTT_MAX_RANGE);
+        return -1;
+    }
+
+    int lo = A[0], hi = A[0];
+    for (int i = 1; i < N; i++) {
+        if (A[i] < lo) lo = A[i];
+        if (A[i] > hi) hi = A[i];
+    }
+    int range = hi - lo;
+    size_t n = 1;
+    while (n < 2 * (size_t)range + 1) n <<= 1;
+
+    bool two_moduli = (unsigned long long)N * (unsigned long long)N >= MOD1;
+    uint32_t *indicator = calloc((size_t)range + 1, sizeof(uint32_t));
+    uint32_t *work = malloc(n * sizeof(uint32_t));
+    uint32_t *roots = malloc(n * sizeof(uint32_t));
+    uint32_t *c1 = malloc(((size_t)range + 1) * sizeof(uint32_t));
+    uint32_t *c2 = two_moduli ? malloc(((size_t)range + 1) * sizeof(uint32_t)) : NULL;
+    hist->counts = malloc(((size_t)range + 1) * sizeof(long long));
+    int status = -1;
+    if (!indicator || !work || !roots || !c1 || (two_moduli && !c2) || !hist->counts) {
+        set_error(error, error_size, "内存分配失败");
+        goto cleanup;
+    }
+
+    for (int i = 0; i < N; i++) indicator[A[i] - lo]++;
+
+    autocorrelate(MOD1, indicator, range, work, roots, n, c1);
+    if (two_moduli) {
+        autocorrelate(MOD2, indicator, range, work, roots, n, c2);
+        // x ≡ c1 (mod MOD1)，x ≡ c2 (mod MOD2)：x = c1 + MOD1·((c2 - c1)·MOD1⁻¹ mod MOD2)
+        uint32_t inv = pow_mod(MOD1 % MOD2, MOD2 - 2, MOD2);
+        for (int d = 0; d <= range; d++) {
+            uint32_t r1 = c1[d] % MOD2;
+            uint32_t diff = c2[d] >= r1 ? c2[d] - r1 : c2[d] + MOD2 - r1;
+            hist->counts[d] = (long long)c1[d] + (long long)MOD1 * mul_mod(diff, inv, MOD2);
+        }
+    } else {
+        for (int d = 0; d <= range; d++) hist->counts[d] = c1[d];
+    }
+    hist->counts[0] = (hist->counts[0] - N) / 2;
+    hist->range = range;
+    hist->total = (long long)N * (N - 1) / 2;
+    status = 0;
+
+cleanup:
+    free(indicator);
+    free(work);
+    free(roots);
+    free(c1);
+    free(c2);
+    if (status != 0) difference_histogram_free(hist);
+    return status;
+}
+
+void difference_histogram_free(DifferenceHistogram *hist) {
+    free(hist->counts);
+    hist->counts = NULL;
+    hist->range = 0;
+    hist->total = 0;
+}
+
+/**
+ * 把直方图展开为升序的D序列
+ * 参数：
+ *   D: 输出数组
+ *   capacity: D的容量
+ * 返回值：
+ *   写入的元素个数；容量不足时只写入前capacity个
+ * 时间复杂度：O(R + |D|)，不需要再排序
+ */
+long long difference_histogram_expand(const DifferenceHistogram *hist, int *D, long long capacity) {
+    long long k = 0;
+    for (int d = 0; d <= hist->range && k < capacity; d++) {
+        for (long long c = hist->counts[d]; c > 0 && k < capacity; c--) {
+            D[k++] = d;
+        }
+    }
+    return k;
+}
+
+/**
+ * 用一次卷积检验A的差值多重集是否恰为D
+ * 参数：
+ *   A, N: 候选数列
+ *   D, D_size: 差值序列（顺序任意，按绝对值比较）
+ *   valid: 输出检验结果
+ * 返回值：
+ *   成功完成检验返回0（无论是否通过），值域过大或内存不足返回-1
+ * 算法原理：
+ * D中的差值取绝对值（构造D的结果在A无序时含负数）；
+ * 个数不是N(N-1)/2、或有差值的绝对值大于R时直接判为不通过；
+ * 否则统计D中各差值的次数，与A的差值直方图逐项比较
+ * 时间复杂度：O(N + |D| + R log R)
+ */
+int difference_validate(const int *A, int N, const int *D, int D_size, bool *valid,
+                        char *error, size_t error_size) {
+    *valid = false;
+    if (!D || D_size < 0 || (long long)D_size != (long long)N * (N - 1) / 2) return 0;
+
+    DifferenceHistogram hist;
+    if (difference_histogram(A, N, &hist, error, error_size) != 0) return -1;
+
+    // 逐个从直方图中扣除D的差值，全部恰好扣完即通过
+    bool match = true;
+    // 与收费站重构（turnpike.c的build_distance_set）相同，负的差值按绝对值计
+    for (int i = 0; i < D_size && match; i++) {
+        long long d = llabs((long long)D[i]);
+        if (d > hist.range || hist.counts[d] == 0) {
+            match = false;
+        } else {
+            hist.counts[d]--;
+        }
+    }
+    *valid = match;
+    difference_histogram_free(&hist);
+    return 0;
+}
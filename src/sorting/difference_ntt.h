@@ -0,0 +1,32 @@
+#ifndef DIFFERENCE_NTT_H
+#define DIFFERENCE_NTT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// 数论变换的最大长度；自相关需要长度不小于2R+1，因此值域R最大为2^24-1
+#define DIFFERENCE_NTT_MAX_LOG 25
+#define DIFFERENCE_NTT_MAX_RANGE ((1 << (DIFFERENCE_NTT_MAX_LOG - 1)) - 1)
+// 自相关各项不超过N²，须小于两个模数之积（约7.9·10^16），超过该点数时改用直接计算
+#define DIFFERENCE_NTT_MAX_POINTS 200000000
+
+/**
+ * 差值直方图：counts[d]为|A[i]-A[j]|（i≠j的无序点对）等于d的次数，d = 0..range
+ * 值域range = max(A) - min(A)，总次数为N(N-1)/2
+ */
+typedef struct {
+    long long *counts;
+    int range;
+    long long total;
+} DifferenceHistogram;
+
+// 函数声明
+bool difference_ntt_supported(const int *A, int N);
+int difference_histogram(const int *A, int N, DifferenceHistogram *hist,
+                         char *error, size_t error_size);
+void difference_histogram_free(DifferenceHistogram *hist);
+long long difference_histogram_expand(const DifferenceHistogram *hist, int *D, long long capacity);
+int difference_validate(const int *A, int N, const int *D, int D_size, bool *valid,
+                        char *error, size_t error_size);
+
+#endif
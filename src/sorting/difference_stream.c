@@ -0,0 +1,287 @@
+#include "difference_stream.h"
+#include "radix_sort.h"
+#include "sort_kernels.h"
+#include "difference_ntt.h"
+#include "../utils/int_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+
+// 写文件的缓冲区大小（字节）
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+// 记录错误信息
+static void set_error(char *error, size_t error_size, const char *format, ...) {
+    if (!error || error_size == 0) return;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+}
+
+// 第r行当前的键：差值（A已升序，差值在[0, 2^32)内）放在高32位，行号放在低32位
+static inline uint64_t row_key(const DifferenceStream *stream, int r) {
+    int j = stream->next[r];
+    if (j < 0) return DIFFERENCE_STREAM_DONE;
+    uint64_t value = (uint64_t)((long long)stream->points[r + 1] - stream->points[j]);
+    return value << 32 | (uint64_t)r;
+}
+
+/**
+ * 初始化差值流
+ * 参数：
+ *   stream: 差值流
+ *   A, N: 数列及其长度，不要求有序，也不要求首项为0
+ *   error, error_size: 失败时写入错误信息
+ * 返回值：
+ *   成功返回0，失败返回-1
+ * 算法原理：
+ * 1. 复制A并排序；第r行从左端点r（相邻两点之差，该行最小值）开始，
+ *    每次取出后左端点左移一位，差值随之增大，左端点越过0时该行取完
+ * 2. 败者树的结点直接保存打包后的键而不是来源下标：一次无符号比较即按（差值, 行号）排序，
+ *    重赛时用min/max交换，没有难以预测的分支，也不必再间接读取各行的键。
+ *    相等的差值无法区分，不需要utils/loser_tree.h那样的稳定顺序
+ */
+int difference_stream_init(DifferenceStream *stream, const int *A, int N,
+                           char *error, size_t error_size) {
+    memset(stream, 0, sizeof(*stream));
+    if (!A || N < 2) {
+        set_error(error, error_size, "至少需要两个数才能产生差值");
+        return -1;
+    }
+
+    int k = N - 1;
+    stream->rows = k;
+    stream->total = (long long)N * (N - 1) / 2;
+    stream->winner = DIFFERENCE_STREAM_DONE;
+    stream->points = malloc((size_t)N * sizeof(int));
+    stream->next = malloc((size_t)k * sizeof(int));
+    stream->losers = malloc((size_t)k * sizeof(uint64_t));
+    // 建树时各结点的胜者，叶子r位于k+r，结点n的子结点为2n和2n+1
+    uint64_t *winners = malloc(2 * (size_t)k * sizeof(uint64_t));
+    if (!stream->points || !stream->next || !stream->losers || !winners) {
+        free(winners);
+        difference_stream_free(stream);
+        set_error(error, error_size, "内存分配失败");
+        return -1;
+    }
+
+    memcpy(stream->points, A, (size_t)N * sizeof(int));
+    if (!radix_sort_i32(stream->points, (size_t)N)) {
+        sort_i32(stream->points, (size_t)N);
+    }
+
+    for (int r = 0; r < k; r++) {
+        stream->next[r] = r;
+        winners[k + r] = row_key(stream, r);
+    }
+    for (int n = k - 1; n >= 1; n--) {
+        uint64_t a = winners[2 * n], b = winners[2 * n + 1];
+        winners[n] = a < b ? a : b;
+        stream->losers[n] = a < b ? b : a;
+    }
+    stream->winner = winners[1];    // k为1时winners[1]就是唯一的叶子
+    free(winners);
+    return 0;
+}
+
+/**
+ * 取出下一个差值
+ * 返回值：
+ *   成功返回true，全部差值取完返回false
+ * 时间复杂度：O(log N)
+ */
+bool difference_stream_next(DifferenceStream *stream, long long *value) {
+    uint64_t w = stream->winner;
+    if (w == DIFFERENCE_STREAM_DONE) return false;
+
+    *value = (long long)(w >> 32);
+    stream->emitted++;
+
+    // 冠军行的下一个键沿叶子到根的路径重赛
+    int r = (int)(uint32_t)w;
+    stream->next[r]--;
+    w = row_key(stream, r);
+    uint64_t *losers = stream->losers;
+    for (int n = (r + stream->rows) >> 1; n >= 1; n >>= 1) {
+        uint64_t other = losers[n];
+        losers[n] = other < w ? w : other;
+        w = other < w ? other : w;
+    }
+    stream->winner = w;
+    return true;
+}
+
+void difference_stream_free(DifferenceStream *stream) {
+    free(stream->points);
+    free(stream->next);
+    free(stream->losers);
+    stream->points = NULL;
+    stream->next = NULL;
+    stream->losers = NULL;
+    stream->winner = DIFFERENCE_STREAM_DONE;
+}
+
+/**
+ * 按升序对每个差值调用callback
+ * 参数：
+ *   emitted: 输出已传给callback的差值个数，可为NULL
+ * 返回值：
+ *   成功（包括callback提前停止）返回0，失败返回-1
+ */
+int difference_stream_foreach(const int *A, int N, DifferenceCallback callback, void *user_data,
+                              long long *emitted, char *error, size_t error_size) {
+    DifferenceStream stream;
+    if (difference_stream_init(&stream, A, N, error, error_size) != 0) return -1;
+
+    long long value;
+    while (difference_stream_next(&stream, &value) && callback(user_data, value)) {
+    }
+
+    if (emitted) *emitted = stream.emitted;
+    difference_stream_free(&stream);
+    return 0;
+}
+
+// 带缓冲的文本输出，每行一个差值
+typedef struct {
+    FILE *file;
+    char *buffer;
+    size_t used;
+    long long count;
+} OutputWriter;
+
+// 报告进度，已取消时返回false
+static bool report_progress(const DifferenceProgress *progress, long long done, long long total) {
+    if (!progress) return true;
+    if (progress->report) progress->report(progress->user_data, done, total);
+    return !(progress->cancel && atomic_load(progress->cancel));
+}
+
+static int writer_put(OutputWriter *writer, long long value) {
+    if (writer->used + INT64_FORMAT_MAX_CHARS + 1 > OUTPUT_BUFFER_SIZE) {
+        if (fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) return -1;
+        writer->used = 0;
+    }
+    char *end = int_format_int64(writer->buffer + writer->used, value);
+    *end++ = '\n';
+    writer->used = (size_t)(end - writer->buffer);
+    writer->count++;
+    return 0;
+}
+
+static int writer_flush(OutputWriter *writer) {
+    if (writer->used > 0 && fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        return -1;
+    }
+    writer->used = 0;
+    return 0;
+}
+
+// 值域不超过差值个数时用卷积直方图（O(R log R)）代替逐个归并（O(N² log N)）
+static bool prefer_histogram(const int *A, int N) {
+    if (!difference_ntt_supported(A, N)) return false;
+    int lo = A[0], hi = A[0];
+    for (int i = 1; i < N; i++) {
+        if (A[i] < lo) lo = A[i];
+        if (A[i] > hi) hi = A[i];
+    }
+    return (long long)hi - lo <= (long long)N * (N - 1) / 2;
+}
+
+/**
+ * 把排序后的D序列写入文本文件，每行一个差值
+ * 参数：
+ *   path: 输出文件路径
+ *   progress: 进度报告与取消标志，可为NULL
+ *   written: 输出写入的差值个数，可为NULL
+ * 返回值：
+ *   成功返回0，失败或被取消返回-1；此时path处原有的文件保持不变
+ * 说明：
+ * 输出格式与大文件集合运算的文本输入相同；N=10^5时约有5·10^9个差值，
+ * 内存只占O(N)加一个输出缓冲区。值域R较小时先用卷积求出各差值的次数（见difference_ntt.c），
+ * 再按次数依次写出，内存为O(R)，N很大也只需O(N + R log R)的计算。
+ * 先写到同目录的path.partial，全部写完后改名为path
+ */
+int difference_stream_to_file(const int *A, int N, const char *path,
+                              const DifferenceProgress *progress, long long *written,
+                              char *error, size_t error_size) {
+    DifferenceStream stream = { .winner = DIFFERENCE_STREAM_DONE };
+    DifferenceHistogram hist = {0};
+    bool use_histogram = A && N >= 2 && prefer_histogram(A, N);
+    if (use_histogram) {
+        if (difference_histogram(A, N, &hist, error, error_size) != 0) return -1;
+    } else if (difference_stream_init(&stream, A, N, error, error_size) != 0) {
+        return -1;
+    }
+
+    int status = -1;
+    OutputWriter writer = {0};
+    size_t path_length = strlen(path);
+    char *temp_path = malloc(path_length + sizeof(".partial"));
+    writer.buffer = malloc(OUTPUT_BUFFER_SIZE);
+    if (!temp_path || !writer.buffer) {
+        set_error(error, error_size, "内存分配失败");
+        goto cleanup;
+    }
+    memcpy(temp_path, path, path_length);
+    memcpy(temp_path + path_length, ".partial", sizeof(".partial"));
+    writer.file = fopen(temp_path, "wb");
+    if (!writer.file) {
+        set_error(error, error_size, "无法创建输出文件 %s：%s", temp_path, strerror(errno));
+        goto cleanup;
+    }
+
+    long long total = (long long)N * (N - 1) / 2;
+    if (!report_progress(progress, 0, total)) goto cancelled;
+    if (use_histogram) {
+        for (int d = 0; d <= hist.range; d++) {
+            for (long long c = hist.counts[d]; c > 0; c--) {
+                if (writer_put(&writer, d) != 0) goto write_failed;
+                if ((writer.count & (DIFFERENCE_PROGRESS_STEP - 1)) == 0 &&
+                    !report_progress(progress, writer.count, total)) goto cancelled;
+            }
+        }
+    } else {
+        long long value;
+        while (difference_stream_next(&stream, &value)) {
+            if (writer_put(&writer, value) != 0) goto write_failed;
+            if ((writer.count & (DIFFERENCE_PROGRESS_STEP - 1)) == 0 &&
+                !report_progress(progress, writer.count, total)) goto cancelled;
+        }
+    }
+    if (writer_flush(&writer) != 0) goto write_failed;
+    report_progress(progress, writer.count, total);
+
+    if (written) *written = writer.count;
+    status = 0;
+    goto cleanup;
+
+write_failed:
+    set_error(error, error_size, "写入输出文件失败：%s", strerror(errno));
+    goto cleanup;
+
+cancelled:
+    set_error(error, error_size, "导出已取消");
+
+cleanup:
+    if (writer.file && fclose(writer.file) != 0 && status == 0) {
+        set_error(error, error_size, "写入输出文件失败：%s", strerror(errno));
+        status = -1;
+    }
+    if (writer.file && status == 0 && rename(temp_path, path) != 0) {
+        set_error(error, error_size, "无法写入输出文件 %s：%s", path, strerror(errno));
+        status = -1;
+    }
+    // 不留下写了一半的临时文件，原有的输出文件不受影响
+    if (writer.file && status != 0) {
+        remove(temp_path);
+    }
+    free(temp_path);
+    free(writer.buffer);
+    difference_histogram_free(&hist);
+    difference_stream_free(&stream);
+    return status;
+}
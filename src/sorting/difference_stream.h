@@ -0,0 +1,52 @@
+#ifndef DIFFERENCE_STREAM_H
+#define DIFFERENCE_STREAM_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+/**
+ * 按升序逐个产生数列A的全部两两差值（即排序后的D序列），不保存D本身
+ * A升序排列后，第i行差值A[i]-A[j]（j从i-1递减到0）本身有序，
+ * 用败者树对N-1行做多路归并，内存为O(N)
+ */
+typedef struct {
+    int *points;            // 升序排列的A
+    int *next;              // next[r]：第r行（右端点为points[r+1]）下一个差值的左端点下标
+    int rows;
+    uint64_t *losers;       // losers[1..rows-1]：各内部结点的败者，高32位为差值、低32位为行号
+    uint64_t winner;        // 当前冠军，全部取完时为DIFFERENCE_STREAM_DONE
+    long long total;        // 差值总数N(N-1)/2
+    long long emitted;      // 已产生的差值个数
+} DifferenceStream;
+
+// 已取完的行的键，大于任何差值
+#define DIFFERENCE_STREAM_DONE UINT64_MAX
+
+// 每产生一个差值调用一次；返回false时停止
+typedef bool (*DifferenceCallback)(void *user_data, long long value);
+
+// 写文件时的进度报告与取消
+// 每写出DIFFERENCE_PROGRESS_STEP个差值调用一次report并检查cancel；
+// report在写文件的线程中调用，需由调用者转交给界面线程
+typedef struct {
+    atomic_bool *cancel;    // 置位后尽快停止，不留下未写完的文件，可为NULL
+    void (*report)(void *user_data, long long done, long long total);   // 可为NULL
+    void *user_data;
+} DifferenceProgress;
+
+#define DIFFERENCE_PROGRESS_STEP (1LL << 22)
+
+// 函数声明
+int difference_stream_init(DifferenceStream *stream, const int *A, int N,
+                           char *error, size_t error_size);
+bool difference_stream_next(DifferenceStream *stream, long long *value);
+void difference_stream_free(DifferenceStream *stream);
+int difference_stream_foreach(const int *A, int N, DifferenceCallback callback, void *user_data,
+                              long long *emitted, char *error, size_t error_size);
+int difference_stream_to_file(const int *A, int N, const char *path,
+                              const DifferenceProgress *progress, long long *written,
+                              char *error, size_t error_size);
+
+#endif
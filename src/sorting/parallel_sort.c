@@ -0,0 +1,186 @@
+#include "parallel_sort.h"
+#include "radix_sort.h"
+#include "sort_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// 一次并行排序的共享状态；每个线程先处理输入的一段，再处理一个桶
+typedef struct {
+    int *arr;
+    int *buffer;                // 分桶后的元素，与arr等长
+    size_t size;
+    int threads;
+    int splitters[PARALLEL_SORT_MAX_THREADS - 1];
+    // counts[t][b]：第t段中落入第b个桶的元素个数；前缀和之后变为第t段写入第b个桶的起点
+    size_t counts[PARALLEL_SORT_MAX_THREADS][PARALLEL_SORT_MAX_THREADS];
+    size_t bucket_start[PARALLEL_SORT_MAX_THREADS + 1];
+} SortJob;
+
+typedef struct {
+    SortJob *job;
+    int index;
+} SortTask;
+
+// 本机可用的处理器个数
+int parallel_sort_default_threads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    if (cpus > PARALLEL_SORT_MAX_THREADS) return PARALLEL_SORT_MAX_THREADS;
+    return (int)cpus;
+}
+
+// 单线程排序，基数排序的缓冲区分配失败时退回原地的内省排序
+static void sort_sequential(int *arr, size_t size) {
+    if (!radix_sort_i32(arr, size)) {
+        sort_i32(arr, size);
+    }
+}
+
+// value所属的桶：小于它的分割值个数（分割值升序，二分查找）
+static inline int bucket_of(const SortJob *job, int value) {
+    int lo = 0, hi = job->threads - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (job->splitters[mid] < value) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// 第t段输入的下标区间
+static inline void segment_bounds(const SortJob *job, int t, size_t *start, size_t *end) {
+    *start = job->size * (size_t)t / (size_t)job->threads;
+    *end = job->size * (size_t)(t + 1) / (size_t)job->threads;
+}
+
+// 第一阶段：统计本段各桶的元素个数
+static void* count_phase(void *arg) {
+    SortTask *task = arg;
+    SortJob *job = task->job;
+    size_t *count = job->counts[task->index];
+    size_t start, end;
+    segment_bounds(job, task->index, &start, &end);
+    for (size_t i = start; i < end; i++) {
+        count[bucket_of(job, job->arr[i])]++;
+    }
+    return NULL;
+}
+
+// 第二阶段：把本段元素分配到各桶中本段独占的位置
+static void* scatter_phase(void *arg) {
+    SortTask *task = arg;
+    SortJob *job = task->job;
+    size_t *offset = job->counts[task->index];
+    size_t start, end;
+    segment_bounds(job, task->index, &start, &end);
+    for (size_t i = start; i < end; i++) {
+        int value = job->arr[i];
+        job->buffer[offset[bucket_of(job, value)]++] = value;
+    }
+    return NULL;
+}
+
+// 第三阶段：排序一个桶并写回原数组的相同位置
+static void* sort_phase(void *arg) {
+    SortTask *task = arg;
+    SortJob *job = task->job;
+    size_t start = job->bucket_start[task->index];
+    size_t size = job->bucket_start[task->index + 1] - start;
+    sort_sequential(job->buffer + start, size);
+    memcpy(job->arr + start, job->buffer + start, size * sizeof(int));
+    return NULL;
+}
+
+// 在threads个线程上执行同一阶段；第0个任务在当前线程上执行，线程创建失败的任务也在当前线程上补做
+static void run_phase(void *(*phase)(void*), SortTask *tasks, int threads) {
+    pthread_t workers[PARALLEL_SORT_MAX_THREADS];
+    bool started[PARALLEL_SORT_MAX_THREADS];
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&workers[t], NULL, phase, &tasks[t]) == 0;
+    }
+    phase(&tasks[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(workers[t], NULL);
+        } else {
+            phase(&tasks[t]);
+        }
+    }
+}
+
+// 等间隔抽样并排序，取分位点作为threads-1个分割值
+static void choose_splitters(SortJob *job) {
+    int samples[PARALLEL_SORT_MAX_THREADS * PARALLEL_SORT_OVERSAMPLE];
+    int count = job->threads * PARALLEL_SORT_OVERSAMPLE;
+    for (int i = 0; i < count; i++) {
+        samples[i] = job->arr[job->size * (size_t)i / (size_t)count];
+    }
+    sort_i32(samples, (size_t)count);
+    for (int b = 1; b < job->threads; b++) {
+        job->splitters[b - 1] = samples[b * PARALLEL_SORT_OVERSAMPLE];
+    }
+}
+
+/**
+ * 多线程样本排序
+ * 参数：
+ *   arr: 待排序数组
+ *   size: 元素个数
+ *   threads: 线程数，小于等于1或元素少于PARALLEL_SORT_MIN_SIZE时单线程排序
+ * 算法原理：
+ * 1. 抽样选出threads-1个分割值，把值域分成threads个桶
+ * 2. 每个线程统计输入中一段的各桶元素个数；按（桶, 段）顺序求前缀和后，
+ *    每段在每个桶中都有独占的写入区间，各线程无需同步即可并行分配
+ * 3. 各桶值域互不相交且按顺序排列，每个线程对一个桶做基数排序后写回原位置
+ * 排序结果与单线程完全相同；内存不足时退回单线程排序
+ * 时间复杂度：O(n/threads)，外加O(threads²)的前缀和
+ */
+void parallel_sort_ints(int *arr, size_t size, int threads) {
+    if (threads > PARALLEL_SORT_MAX_THREADS) threads = PARALLEL_SORT_MAX_THREADS;
+    if (threads <= 1 || size < PARALLEL_SORT_MIN_SIZE) {
+        sort_sequential(arr, size);
+        return;
+    }
+
+    SortJob *job = calloc(1, sizeof(SortJob));
+    int *buffer = malloc(size * sizeof(int));
+    if (!job || !buffer) {
+        free(job);
+        free(buffer);
+        sort_sequential(arr, size);
+        return;
+    }
+
+    job->arr = arr;
+    job->buffer = buffer;
+    job->size = size;
+    job->threads = threads;
+    choose_splitters(job);
+
+    SortTask tasks[PARALLEL_SORT_MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        tasks[t] = (SortTask){ job, t };
+    }
+
+    run_phase(count_phase, tasks, threads);
+
+    size_t sum = 0;
+    for (int b = 0; b < threads; b++) {
+        job->bucket_start[b] = sum;
+        for (int t = 0; t < threads; t++) {
+            size_t c = job->counts[t][b];
+            job->counts[t][b] = sum;
+            sum += c;
+        }
+    }
+    job->bucket_start[threads] = sum;
+
+    run_phase(scatter_phase, tasks, threads);
+    run_phase(sort_phase, tasks, threads);
+
+    free(buffer);
+    free(job);
+}
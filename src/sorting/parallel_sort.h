@@ -0,0 +1,17 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <stddef.h>
+
+// 最多使用的工作线程数
+#define PARALLEL_SORT_MAX_THREADS 64
+// 元素少于该值时线程开销不划算，直接单线程排序
+#define PARALLEL_SORT_MIN_SIZE (1 << 18)
+// 每个线程贡献的样本数，越多分桶越均匀
+#define PARALLEL_SORT_OVERSAMPLE 64
+
+// 函数声明
+int parallel_sort_default_threads(void);
+void parallel_sort_ints(int *arr, size_t size, int threads);
+
+#endif
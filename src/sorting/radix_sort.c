@@ -0,0 +1,153 @@
+#include "radix_sort.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_MASK (RADIX_BUCKETS - 1)
+#define RADIX_PASSES_32 ((32 + RADIX_BITS - 1) / RADIX_BITS)
+#define RADIX_PASSES_64 ((64 + RADIX_BITS - 1) / RADIX_BITS)
+
+// 插入排序，用于小数组
+void insertion_sort_i32(int32_t *arr, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        int32_t value = arr[i];
+        size_t j = i;
+        while (j > 0 && arr[j - 1] > value) {
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        arr[j] = value;
+    }
+}
+
+static void insertion_sort_i64(int64_t *arr, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        int64_t value = arr[i];
+        size_t j = i;
+        while (j > 0 && arr[j - 1] > value) {
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        arr[j] = value;
+    }
+}
+
+// 把一趟的计数转换为各桶的起始位置；所有元素落在同一个桶时返回false（该趟可以跳过）
+static bool prefix_offsets(size_t *count, size_t size) {
+    size_t sum = 0;
+    for (int d = 0; d < RADIX_BUCKETS; d++) {
+        if (count[d] == size) return false;
+        size_t c = count[d];
+        count[d] = sum;
+        sum += c;
+    }
+    return true;
+}
+
+/**
+ * 对32位有符号整数做LSD基数排序
+ * 参数：
+ *   arr: 待排序数组
+ *   size: 元素个数
+ * 返回值：
+ *   成功返回true；临时缓冲区分配失败时返回false，数组保持原样
+ * 算法原理：
+ * 1. 翻转符号位，使有符号整数的顺序与无符号整数一致，最后再翻转回来
+ * 2. 预扫描一遍，同时统计所有趟（每趟11位）的桶计数
+ * 3. 从低位到高位逐趟稳定分配；某一趟所有元素都落在同一个桶时（如小值域
+ *    数据的高位）该趟不改变顺序，直接跳过
+ * 4. 小数组改用插入排序
+ * 时间复杂度：O(n)，至多3趟分配，不做任何比较
+ */
+bool radix_sort_i32(int32_t *arr, size_t size) {
+    if (size < RADIX_MIN_SIZE) {
+        insertion_sort_i32(arr, size);
+        return true;
+    }
+
+    uint32_t *buffer = malloc(size * sizeof(uint32_t));
+    size_t (*count)[RADIX_BUCKETS] = calloc(RADIX_PASSES_32, sizeof(*count));
+    if (!buffer || !count) {
+        free(buffer);
+        free(count);
+        return false;
+    }
+
+    uint32_t *src = (uint32_t*)arr;
+    for (size_t i = 0; i < size; i++) {
+        uint32_t key = src[i] ^ 0x80000000u;
+        src[i] = key;
+        for (int p = 0; p < RADIX_PASSES_32; p++) {
+            count[p][(key >> (p * RADIX_BITS)) & RADIX_MASK]++;
+        }
+    }
+
+    uint32_t *dst = buffer;
+    for (int p = 0; p < RADIX_PASSES_32; p++) {
+        size_t *offset = count[p];
+        if (!prefix_offsets(offset, size)) continue;
+        int shift = p * RADIX_BITS;
+        for (size_t i = 0; i < size; i++) {
+            uint32_t key = src[i];
+            dst[offset[(key >> shift) & RADIX_MASK]++] = key;
+        }
+        uint32_t *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    // 结果可能在临时缓冲区中，翻转符号位的同时复制回原数组
+    uint32_t *out = (uint32_t*)arr;
+    for (size_t i = 0; i < size; i++) {
+        out[i] = src[i] ^ 0x80000000u;
+    }
+    free(buffer);
+    free(count);
+    return true;
+}
+
+// 64位有符号整数的LSD基数排序，做法与radix_sort_i32相同，至多6趟
+bool radix_sort_i64(int64_t *arr, size_t size) {
+    if (size < RADIX_MIN_SIZE) {
+        insertion_sort_i64(arr, size);
+        return true;
+    }
+
+    uint64_t *buffer = malloc(size * sizeof(uint64_t));
+    size_t (*count)[RADIX_BUCKETS] = calloc(RADIX_PASSES_64, sizeof(*count));
+    if (!buffer || !count) {
+        free(buffer);
+        free(count);
+        return false;
+    }
+
+    uint64_t *src = (uint64_t*)arr;
+    for (size_t i = 0; i < size; i++) {
+        uint64_t key = src[i] ^ 0x8000000000000000ULL;
+        src[i] = key;
+        for (int p = 0; p < RADIX_PASSES_64; p++) {
+            count[p][(key >> (p * RADIX_BITS)) & RADIX_MASK]++;
+        }
+    }
+
+    uint64_t *dst = buffer;
+    for (int p = 0; p < RADIX_PASSES_64; p++) {
+        size_t *offset = count[p];
+        if (!prefix_offsets(offset, size)) continue;
+        int shift = p * RADIX_BITS;
+        for (size_t i = 0; i < size; i++) {
+            uint64_t key = src[i];
+            dst[offset[(key >> shift) & RADIX_MASK]++] = key;
+        }
+        uint64_t *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    uint64_t *out = (uint64_t*)arr;
+    for (size_t i = 0; i < size; i++) {
+        out[i] = src[i] ^ 0x8000000000000000ULL;
+    }
+    free(buffer);
+    free(count);
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 每趟按11位分桶：32位整数3趟，64位整数6趟
+#define RADIX_BITS 11
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+// 元素少于该值时插入排序更快
+#define RADIX_MIN_SIZE 64
+
+// 函数声明
+void insertion_sort_i32(int32_t *arr, size_t size);
+bool radix_sort_i32(int32_t *arr, size_t size);
+bool radix_sort_i64(int64_t *arr, size_t size);
+
+#endif
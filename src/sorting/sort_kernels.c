@@ -0,0 +1,41 @@
+#include "sort_kernels.h"
+
+// 各类型的排序内核，比较直接内联展开（模板见sort_template.h）
+
+#define SORT_NAME sort_i32
+#define SORT_TYPE int32_t
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_LINKAGE
+#include "sort_template.h"
+
+// 差值、外部文件中的整数等均为long long
+#define SORT_NAME sort_i64
+#define SORT_TYPE long long
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_LINKAGE
+#include "sort_template.h"
+
+#define SORT_NAME sort_u32
+#define SORT_TYPE uint32_t
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_LINKAGE
+#include "sort_template.h"
+
+#define SORT_NAME sort_u64
+#define SORT_TYPE uint64_t
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_LINKAGE
+#include "sort_template.h"
+
+// NaN排在最后，使比较仍为严格弱序（否则划分的哨兵可能失效）
+#define SORT_NAME sort_f64
+#define SORT_TYPE double
+#define SORT_LESS(a, b) ((a) < (b) || ((b) != (b) && (a) == (a)))
+#define SORT_LINKAGE
+#include "sort_template.h"
+
+#define SORT_NAME sort_pairs
+#define SORT_TYPE SortPair
+#define SORT_LESS(a, b) ((a).key < (b).key)
+#define SORT_LINKAGE
+#include "sort_template.h"
@@ -0,0 +1,21 @@
+#ifndef SORT_KERNELS_H
+#define SORT_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 键值对：按key排序，value随之移动
+typedef struct {
+    long long key;
+    long long value;
+} SortPair;
+
+// 函数声明（由sort_template.h生成的内省排序，原地、不稳定）
+void sort_i32(int32_t *arr, size_t size);
+void sort_i64(long long *arr, size_t size);
+void sort_u32(uint32_t *arr, size_t size);
+void sort_u64(uint64_t *arr, size_t size);
+void sort_f64(double *arr, size_t size);
+void sort_pairs(SortPair *arr, size_t size);
+
+#endif
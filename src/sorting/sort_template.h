@@ -0,0 +1,205 @@
+/**
+ * 类型特化的排序内核模板（内省排序）
+ * 用法：定义以下宏后包含本文件，生成 static void SORT_NAME(SORT_TYPE *arr, size_t size)
+ *   SORT_NAME: 生成的函数名
+ *   SORT_TYPE: 元素类型
+ *   SORT_LESS(a, b): 元素a应排在b之前时为真（a、b为元素值），须为严格弱序
+ * 可选：
+ *   SORT_LINKAGE: 生成函数的链接属性，默认为static
+ * 比较直接展开在循环中，没有qsort的函数指针调用和void*拷贝，可以对结构体等原生类型原地排序；
+ * 划分为无分支的Lomuto划分，随机数据上比分支预测失败频繁的Hoare划分快得多。
+ * 本文件没有包含保护，同一翻译单元中可多次包含以生成多个内核，每次包含后上述宏均被取消定义
+ * 排序不稳定
+ */
+
+#include <stddef.h>
+
+#if !defined(SORT_NAME) || !defined(SORT_TYPE) || !defined(SORT_LESS)
+#error "包含sort_template.h前须定义SORT_NAME、SORT_TYPE和SORT_LESS"
+#endif
+
+#ifndef SORT_LINKAGE
+#define SORT_LINKAGE static
+#endif
+
+#ifndef SORT_TEMPLATE_COMMON
+#define SORT_TEMPLATE_COMMON
+// 区间不超过该长度时改用插入排序
+#define SORT_INSERTION_THRESHOLD 24
+#define SORT_CONCAT_(a, b) a##b
+#define SORT_CONCAT(a, b) SORT_CONCAT_(a, b)
+#endif
+
+#define SORT_FN(suffix) SORT_CONCAT(SORT_NAME, suffix)
+
+// 插入排序，用于短区间
+static inline void SORT_FN(_insertion)(SORT_TYPE *arr, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        SORT_TYPE value = arr[i];
+        size_t j = i;
+        while (j > 0 && SORT_LESS(value, arr[j - 1])) {
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        arr[j] = value;
+    }
+}
+
+// 大顶堆的下沉
+static void SORT_FN(_sift_down)(SORT_TYPE *arr, size_t root, size_t size) {
+    SORT_TYPE value = arr[root];
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= size) break;
+        if (child + 1 < size && SORT_LESS(arr[child], arr[child + 1])) child++;
+        if (!SORT_LESS(value, arr[child])) break;
+        arr[root] = arr[child];
+        root = child;
+    }
+    arr[root] = value;
+}
+
+// 堆排序，递归过深时保证O(n log n)
+static void SORT_FN(_heapsort)(SORT_TYPE *arr, size_t size) {
+    for (size_t i = size / 2; i > 0; i--) {
+        SORT_FN(_sift_down)(arr, i - 1, size);
+    }
+    for (size_t end = size - 1; end > 0; end--) {
+        SORT_TYPE top = arr[0];
+        arr[0] = arr[end];
+        arr[end] = top;
+        SORT_FN(_sift_down)(arr, 0, end);
+    }
+}
+
+// 把三个位置的元素排成升序
+static inline void SORT_FN(_sort3)(SORT_TYPE *a, SORT_TYPE *b, SORT_TYPE *c) {
+    SORT_TYPE t;
+    if (SORT_LESS(*b, *a)) { t = *a; *a = *b; *b = t; }
+    if (SORT_LESS(*c, *b)) { t = *b; *b = *c; *c = t; }
+    if (SORT_LESS(*b, *a)) { t = *a; *a = *b; *b = t; }
+}
+
+static inline void SORT_FN(_swap)(SORT_TYPE *a, SORT_TYPE *b) {
+    SORT_TYPE t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/**
+ * 无分支的Lomuto划分：把arr[0, size)中满足条件的元素移到前部
+ * 参数：
+ *   below: 为true时条件为“小于pivot”，为false时为“不大于pivot”
+ * 返回值：
+ *   满足条件的元素个数
+ * 算法原理：
+ * 不变式为[0, lt)满足条件、[lt, j)不满足。每一步无条件地把arr[lt]搬到j、
+ * 把arr[j]放到lt，再按比较结果决定lt是否加一；循环体没有分支，
+ * 比较结果随机时不会像Hoare划分那样频繁预测失败
+ */
+static inline size_t SORT_FN(_partition)(SORT_TYPE *arr, size_t size, SORT_TYPE pivot, int below) {
+    size_t lt = 0;
+    if (below) {
+        for (size_t j = 0; j < size; j++) {
+            SORT_TYPE x = arr[j];
+            size_t take = SORT_LESS(x, pivot);
+            arr[j] = arr[lt];
+            arr[lt] = x;
+            lt += take;
+        }
+    } else {
+        for (size_t j = 0; j < size; j++) {
+            SORT_TYPE x = arr[j];
+            size_t take = !SORT_LESS(pivot, x);
+            arr[j] = arr[lt];
+            arr[lt] = x;
+            lt += take;
+        }
+    }
+    return lt;
+}
+
+// 划分很不均衡时交换几个元素，打破有规律的输入
+static inline void SORT_FN(_break_patterns)(SORT_TYPE *arr, size_t size) {
+    if (size < SORT_INSERTION_THRESHOLD) return;
+    SORT_FN(_swap)(&arr[0], &arr[size / 4]);
+    SORT_FN(_swap)(&arr[size - 1], &arr[size - size / 4]);
+}
+
+/**
+ * 内省排序主循环（pdqsort风格）
+ * 参数：
+ *   bad_allowed: 还允许出现的不均衡划分次数，用完后改用堆排序
+ *   has_pred: arr[-1]是上层的枢轴，区间内所有元素都不小于它
+ * 算法原理：
+ * 1. 长区间用九数取中（三组三数取中再取中）选枢轴，短区间三数取中，枢轴换到arr[0]
+ * 2. 若枢轴与前驱arr[-1]相等，则区间内不大于枢轴的元素都与它相等，
+ *    划分出来后直接跳过，大量重复键时总代价为O(n)
+ * 3. 否则按“小于枢轴”划分后把枢轴放到分界处
+ * 4. 较短一侧小于n/8时视为不均衡：打乱几个元素，次数用完时改用堆排序，最坏O(n log n)
+ * 5. 对较短的一侧递归、较长的一侧循环，栈深度为O(log n)；短区间用插入排序
+ */
+static void SORT_FN(_loop)(SORT_TYPE *arr, size_t size, int bad_allowed, int has_pred) {
+    while (size > SORT_INSERTION_THRESHOLD) {
+        size_t half = size / 2;
+        if (size > 128) {
+            SORT_FN(_sort3)(&arr[0], &arr[half], &arr[size - 1]);
+            SORT_FN(_sort3)(&arr[1], &arr[half - 1], &arr[size - 2]);
+            SORT_FN(_sort3)(&arr[2], &arr[half + 1], &arr[size - 3]);
+            SORT_FN(_sort3)(&arr[half - 1], &arr[half], &arr[half + 1]);
+        } else {
+            SORT_FN(_sort3)(&arr[1], &arr[half], &arr[size - 1]);
+        }
+        SORT_FN(_swap)(&arr[0], &arr[half]);
+        SORT_TYPE pivot = arr[0];
+        SORT_TYPE *rest = arr + 1;
+
+        if (has_pred && !SORT_LESS(arr[-1], pivot)) {
+            size_t equal = SORT_FN(_partition)(rest, size - 1, pivot, 0);
+            arr += equal + 1;
+            size -= equal + 1;
+            continue;
+        }
+
+        size_t left = SORT_FN(_partition)(rest, size - 1, pivot, 1);
+        size_t right = size - 1 - left;
+        // 枢轴与最后一个小于它的元素交换，落在分界位置arr[left]
+        if (left > 0) {
+            arr[0] = rest[left - 1];
+            rest[left - 1] = pivot;
+        }
+
+        if (left < size / 8 || right < size / 8) {
+            if (--bad_allowed == 0) {
+                SORT_FN(_heapsort)(arr, size);
+                return;
+            }
+            SORT_FN(_break_patterns)(arr, left);
+            SORT_FN(_break_patterns)(arr + left + 1, right);
+        }
+
+        if (left < right) {
+            SORT_FN(_loop)(arr, left, bad_allowed, has_pred);
+            arr += left + 1;
+            size = right;
+            has_pred = 1;
+        } else {
+            SORT_FN(_loop)(arr + left + 1, right, bad_allowed, 1);
+            size = left;
+        }
+    }
+    SORT_FN(_insertion)(arr, size);
+}
+
+SORT_LINKAGE void SORT_NAME(SORT_TYPE *arr, size_t size) {
+    if (size < 2) return;
+    int bad_allowed = 1;
+    for (size_t n = size; n > 1; n >>= 1) bad_allowed++;
+    SORT_FN(_loop)(arr, size, bad_allowed, 0);
+}
+
+#undef SORT_FN
+#undef SORT_NAME
+#undef SORT_TYPE
+#undef SORT_LESS
+#undef SORT_LINKAGE
@@ -1,23 +1,35 @@
 #include "sorting.h"
+#include "radix_sort.h"
+#include "sort_kernels.h"
+#include "parallel_sort.h"
+#include "turnpike.h"
+#include "turnpike_bench.h"
+#include "difference_stream.h"
+#include "difference_ntt.h"
 #include "../utils/error_handler.h"
+#include "../utils/int_parser.h"
+#include "../utils/int_format.h"
+#include "../utils/background_task.h"
+#include "../utils/file_chooser.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <limits.h>
 #define _GNU_SOURCE
 
 static GtkWidget *text_view_input;
 static GtkWidget *text_view_output;
+static GtkWidget *enumerate_check;     // 构造A时列出全部解
+
+// 重构A的搜索节点上限，避免病态输入使界面长时间无响应
+#define TURNPIKE_MAX_NODES 50000000LL
+// 枚举全部解时最多列出的解数
+#define TURNPIKE_MAX_LISTED 100
 
 // 函数声明
-static int compare_ints(const void* a, const void* b);
 static char* array_to_string(const int arr[], int size);
 
-// 比较函数用于qsort
-static int compare_ints(const void* a, const void* b) {
-    return (*(int*)a - *(int*)b);
-}
-
 // 从A构造D
 void construct_D_from_A(const int* A, int N, int* D, int* D_size) {
     if (!A || !D || !D_size || N <= 0) {
@@ -31,118 +43,195 @@ void construct_D_from_A(const int* A, int N, int* D, int* D_size) {
         return;
     }
 
-    if (N > MAX_ARRAY_SIZE) {
-        handle_error(NULL, ERROR_BUFFER_OVERFLOW, "输入数组过大");
+    // 计算D序列的大小，D的容量由调用者按d_sequence_size分配
+    long long expected_size = d_sequence_size(N);
+    if (expected_size > INT_MAX) {
+        handle_error(NULL, ERROR_BUFFER_OVERFLOW, "结果数组将超出最大限制");
         return;
     }
 
-    // 计算D序列的大小
-    int expected_size = (N * (N - 1)) / 2;
-    if (expected_size > MAX_ARRAY_SIZE) {
-        handle_error(NULL, ERROR_BUFFER_OVERFLOW, "结果数组将超出最大限制");
-        return;
+    // A非递减且值域不超过差值个数时，用卷积求差值直方图后直接展开为有序的D
+    bool ascending = true;
+    for (int i = 1; i < N && ascending; i++) {
+        ascending = A[i - 1] <= A[i];
+    }
+    if (ascending && (long long)A[N - 1] - A[0] <= expected_size && difference_ntt_supported(A, N)) {
+        DifferenceHistogram hist;
+        char message[256];
+        if (difference_histogram(A, N, &hist, message, sizeof(message)) == 0) {
+            *D_size = (int)difference_histogram_expand(&hist, D, expected_size);
+            difference_histogram_free(&hist);
+            return;
+        }
     }
 
     int k = 0;
-    for (int i = 1; i < N && k < MAX_ARRAY_SIZE; i++) {
-        for (int j = 0; j < i && k < MAX_ARRAY_SIZE; j++) {
+    for (int i = 1; i < N; i++) {
+        for (int j = 0; j < i; j++) {
             D[k++] = A[i] - A[j];
         }
     }
     *D_size = k;
 
-    // 使用快速排序
+    // N(N-1)/2个差值的排序占绝大部分时间，较大时多线程排序
     sort_array(D, k);
 }
 
-// 从D构造A
-void construct_A_from_D(const int* D, int D_size, int* A, int* A_size) {
-    if (!D || !A || !A_size || D_size <= 0) {
-        handle_error(NULL, ERROR_INVALID_INPUT, "无效的输入参数");
-        return;
-    }
+// 找到第一个解时复制到A并停止搜索
+static bool copy_first_solution(void *user_data, const int *points, int n) {
+    memcpy(user_data, points, (size_t)n * sizeof(int));
+    return false;
+}
 
-    if (D_size > MAX_ARRAY_SIZE) {
-        handle_error(NULL, ERROR_BUFFER_OVERFLOW, "输入数组过大");
-        return;
+// 搜索未找到解时的错误信息
+static const char* no_solution_message(const TurnpikeStats *stats) {
+    if (stats->cancelled) return "已取消构造A";
+    return stats->exhausted ? "搜索超过节点上限，未能构造A序列"
+                            : "无法构造有效的A序列：输入的D序列不是有效的差分序列";
+}
+
+/**
+ * 搜索D的第一个重构，不调用任何GTK函数，可在工作线程中运行
+ * 参数：
+ *   D, D_size: 两两差值的多重集
+ *   A: 输出数组，容量至少为D_size + 1
+ *   cancel: 取消标志，可为NULL
+ *   code, message, message_size: 失败时的错误类型与描述
+ * 返回值：
+ *   成功返回A的长度，失败返回0
+ */
+static int solve_first_A(const int *D, int D_size, int *A, atomic_bool *cancel,
+                         ErrorCode *code, char *message, size_t message_size) {
+    TurnpikeStats stats;
+    *code = ERROR_INVALID_INPUT;
+    if (turnpike_solve_parallel(D, D_size, copy_first_solution, A, TURNPIKE_MAX_NODES,
+                                parallel_sort_default_threads(), cancel, &stats,
+                                message, message_size) != 0) {
+        return 0;
+    }
+    if (stats.solutions == 0) {
+        g_strlcpy(message, no_solution_message(&stats), message_size);
+        return 0;
     }
 
-    // 创建查找表
-    int min_val = D[0], max_val = D[0];
-    for (int i = 1; i < D_size; i++) {
-        if (D[i] < min_val) min_val = D[i];
-        if (D[i] > max_val) max_val = D[i];
+    // 值域允许时用一次卷积复核A的差值多重集与D相同
+    bool valid = true;
+    char detail[256];
+    if (difference_ntt_supported(A, stats.n) &&
+        difference_validate(A, stats.n, D, D_size, &valid, detail, sizeof(detail)) == 0 && !valid) {
+        *code = ERROR_INVALID_OPERATION;
+        g_strlcpy(message, "重构结果未通过差值校验", message_size);
+        return 0;
     }
+    return stats.n;
+}
 
-    int range = max_val - min_val + 1;
-    char* exists = calloc(range, sizeof(char));
-    if (!exists) {
-        handle_error(NULL, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+/**
+ * 从D构造A
+ * 参数：
+ *   D, D_size: 两两差值的多重集，个数须为N(N-1)/2
+ *   A: 输出数组，容量至少为D_size + 1
+ *   A_size: 输出A的长度，失败时为0
+ * 算法原理：
+ * 使用工作窃取的多线程回溯收费站重构（见turnpike.c），考虑差值的重数；
+ * 结果为升序、首项为0的数列，与其镜像只输出一个；值域不大时再用一次卷积校验结果
+ */
+void construct_A_from_D(const int* D, int D_size, int* A, int* A_size) {
+    if (!D || !A || !A_size || D_size <= 0) {
+        handle_error(NULL, ERROR_INVALID_INPUT, "无效的输入参数");
         return;
     }
 
-    // 标记所有存在的差值
-    for (int i = 0; i < D_size; i++) {
-        exists[D[i] - min_val] = 1;
+    ErrorCode code;
+    char message[256];
+    *A_size = solve_first_A(D, D_size, A, NULL, &code, message, sizeof(message));
+    if (*A_size == 0) {
+        handle_error(NULL, code, message);
     }
+}
 
-    // A[0] = 0
-    A[0] = 0;
-    *A_size = 1;
-    
-    // 从D中选择合适的数构造A
-    for (int i = 0; i < D_size && *A_size < MAX_ARRAY_SIZE; i++) {
-        int candidate = D[i];
-        int valid = 1;
-        
-        // 检查是否可以将candidate添加到A中
-        for (int j = 0; j < *A_size && valid; j++) {
-            int diff = abs(candidate - A[j]);
-            if (diff < range && !exists[diff - min_val]) {
-                valid = 0;
-                break;
-            }
-        }
-        
-        if (valid) {
-            A[*A_size] = candidate;
-            (*A_size)++;
-            
-            if (*A_size >= MAX_ARRAY_SIZE) {
-                break;
-            }
-        }
+// 枚举全部解时的输出
+typedef struct {
+    GString *text;
+    int listed;
+} SolutionList;
+
+// 把每个解追加为输出中的一行，达到上限后停止
+static bool append_solution(void *user_data, const int *points, int n) {
+    SolutionList *list = user_data;
+    char *line = array_to_string(points, n);
+    if (!line) return false;
+    g_string_append_printf(list->text, "解%d：%s\n", list->listed + 1, line);
+    free(line);
+    return ++list->listed < TURNPIKE_MAX_LISTED;
+}
+
+/**
+ * 枚举D的全部重构，不调用任何GTK函数，可在工作线程中运行
+ * 返回值：
+ *   每行一个解的文本，调用者用g_free释放；失败时返回NULL并给出错误描述
+ */
+static gchar* enumerate_A_solutions(const int *D, int D_size, atomic_bool *cancel,
+                                    char *message, size_t message_size) {
+    SolutionList list = { g_string_new(NULL), 0 };
+    TurnpikeStats stats;
+    if (turnpike_solve_parallel(D, D_size, append_solution, &list, TURNPIKE_MAX_NODES,
+                                parallel_sort_default_threads(), cancel, &stats,
+                                message, message_size) != 0) {
+        g_string_free(list.text, TRUE);
+        return NULL;
+    }
+    if (stats.solutions == 0) {
+        g_string_free(list.text, TRUE);
+        g_strlcpy(message, no_solution_message(&stats), message_size);
+        return NULL;
     }
 
-    free(exists);
+    bool stopped = list.listed >= TURNPIKE_MAX_LISTED || stats.exhausted || stats.cancelled;
+    g_string_append_printf(list.text, "共%s%lld个解（互为镜像的解只列出一个），搜索%lld个节点%s",
+                           stopped ? "至少" : "", stats.solutions, stats.nodes,
+                           stats.cancelled ? "，已取消" : "");
+    return g_string_free(list.text, FALSE);
+}
 
-    // 检查是否成功构造了A序列
-    if (*A_size == 1) {
-        handle_error(NULL, ERROR_INVALID_INPUT, "无法构造有效的A序列：输入的D序列不是有效的差分序列");
-    }
+// A有N个数时D序列的长度N(N-1)/2
+long long d_sequence_size(int N) {
+    return (long long)N * (N - 1) / 2;
 }
 
-// 重命名函数并确保它是静态的
-static int parse_array_numbers(const char* input, int* numbers, int* count) {
-    char* input_copy = g_strdup(input);
-    char* token = strtok(input_copy, " ,\n");
-    *count = 0;
-    
-    while (token != NULL && *count < 100) {
-        // 检查是否为有效数字
-        for (int i = 0; token[i]; i++) {
-            if (!isdigit(token[i]) && token[i] != '-') {
-                free(input_copy);
-                return 0;  // 解析失败
-            }
-        }
-        numbers[*count] = atoi(token);
-        (*count)++;
-        token = strtok(NULL, " ,\n");
+/**
+ * 解析输入的数列，失败时抛出带出错位置的错误
+ * 参数：
+ *   error_ctx: 错误上下文
+ *   input: 以空格或逗号分隔的整数
+ *   numbers: 输出数组（调用者用free释放），按输入长度可能包含的最多整数个数一次分配
+ *   count: 解析出的整数个数
+ * 算法原理：
+ * 使用共享的向量化整数解析器，一次解析全部数字，不再限制数字个数
+ */
+static void parse_array_numbers(ErrorContext *error_ctx, const char* input, int** numbers, int* count) {
+    size_t length = strlen(input);
+    size_t capacity = int_parse_max_tokens(length);
+    if (capacity > INT_MAX) {
+        THROW(error_ctx, ERROR_BUFFER_OVERFLOW, "输入的数字过多");
     }
+    *numbers = malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    if (!*numbers) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    
+    size_t pos = 0;
+    size_t parsed = 0;
+    IntParseStatus status = int_parse_batch(input, length, &pos, *numbers, capacity, &parsed);
+    *count = (int)parsed;
     
-    free(input_copy);
-    return 1;  // 解析成功
+    if (status != INT_PARSE_OK) {
+        char message[256];
+        g_snprintf(message, sizeof(message), "无效的输入格式 - 第%ld个字符处%s",
+                   g_utf8_pointer_to_offset(input, input + pos) + 1,
+                   int_parse_status_string(status));
+        THROW(error_ctx, ERROR_INVALID_INPUT, message);
+    }
 }
 
 // 构造D的回调函数
@@ -171,39 +260,42 @@ static void on_construct_D_clicked(GtkWidget *widget, gpointer data) {
             THROW(&error_ctx, ERROR_INVALID_INPUT, "请输入要处理的数列");
         }
         
-        numbers = malloc(MAX_NUMBERS * sizeof(int));
-        result = malloc(MAX_NUMBERS * sizeof(int));
-        
-        if (!numbers || !result) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
-        }
-        
         int count;
-        if (!parse_array_numbers(input_text, numbers, &count)) {
-            THROW(&error_ctx, ERROR_INVALID_INPUT, "无效的输入格式 - 请输入用空格或逗号分隔的数字");
-        }
+        parse_array_numbers(&error_ctx, input_text, &numbers, &count);
         
         if (count < 2) {
             THROW(&error_ctx, ERROR_INVALID_INPUT, "请至少输入两个数字");
         }
         
+        long long D_capacity = d_sequence_size(count);
+        if (D_capacity > INT_MAX) {
+            THROW(&error_ctx, ERROR_BUFFER_OVERFLOW, "结果数组将超出最大限制");
+        }
+        result = malloc((size_t)D_capacity * sizeof(int));
+        if (!result) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        
         // 检查第一个数是否为0
         if (numbers[0] != 0) {
             THROW(&error_ctx, ERROR_INVALID_INPUT, "A序列的第一个数必须为0");
         }
         
         // 计算D序列
-        int D_size;
+        int D_size = 0;
         construct_D_from_A(numbers, count, result, &D_size);
         
-        // 显示结果
-        result_str = array_to_string(result, D_size);
-        if (!result_str) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        // D_size为0时construct_D_from_A已经报告了错误
+        if (D_size > 0) {
+            // 显示结果
+            result_str = array_to_string(result, D_size);
+            if (!result_str) {
+                THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+            }
+            
+            GtkTextBuffer *output_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
+            gtk_text_buffer_set_text(output_buffer, result_str, -1);
         }
-        
-        GtkTextBuffer *output_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
-        gtk_text_buffer_set_text(output_buffer, result_str, -1);
     }
     CATCH(&error_ctx) {
         handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
@@ -216,17 +308,98 @@ static void on_construct_D_clicked(GtkWidget *widget, gpointer data) {
     });
 }
 
-// 构造A的回调函数
+// 在输出框中显示文本
+static void set_output_text(const char *text) {
+    GtkTextBuffer *output_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
+    gtk_text_buffer_set_text(output_buffer, text, -1);
+}
+
+// 后台构造A的任务：搜索在工作线程中进行，结果经g_idle_add回到主线程显示
+typedef struct {
+    int *numbers;
+    int count;
+    bool enumerate;                 // 列出全部解
+    GtkWidget *button;              // 搜索期间作为取消按钮
+    atomic_bool cancel;             // 传给turnpike_solve_parallel的停止标志
+    gchar *text;                    // 成功时的输出
+    ErrorCode code;
+    char message[256];
+} ConstructJob;
+
+static ConstructJob *construct_job = NULL;     // 同一时间只有一个构造任务
+
+// 工作线程：搜索并生成输出文本
+static void construct_work(gpointer data) {
+    ConstructJob *job = data;
+    job->code = ERROR_INVALID_INPUT;
+    if (job->enumerate) {
+        job->text = enumerate_A_solutions(job->numbers, job->count, &job->cancel,
+                                          job->message, sizeof(job->message));
+        return;
+    }
+
+    // A的点数n满足n(n-1)/2 = count，不超过count + 1
+    int *result = malloc(((size_t)job->count + 1) * sizeof(int));
+    if (!result) {
+        job->code = ERROR_MEMORY_ALLOCATION;
+        g_strlcpy(job->message, "内存分配失败", sizeof(job->message));
+        return;
+    }
+    int A_size = solve_first_A(job->numbers, job->count, result, &job->cancel,
+                               &job->code, job->message, sizeof(job->message));
+    if (A_size > 0) {
+        char *line = array_to_string(result, A_size);
+        if (line) {
+            job->text = g_strdup(line);
+            free(line);
+        } else {
+            job->code = ERROR_MEMORY_ALLOCATION;
+            g_strlcpy(job->message, "无法生成结果字符串", sizeof(job->message));
+        }
+    }
+    free(result);
+}
+
+// 主线程：显示结果，恢复按钮并释放任务
+static gboolean construct_finished_idle(gpointer data) {
+    ConstructJob *job = data;
+    gtk_button_set_label(GTK_BUTTON(job->button), "构造A");
+    gtk_widget_set_sensitive(enumerate_check, TRUE);
+    construct_job = NULL;
+
+    if (job->text) {
+        set_output_text(job->text);
+    } else if (atomic_load(&job->cancel)) {
+        set_output_text("已取消构造A");
+    } else {
+        handle_error(gtk_widget_get_toplevel(job->button), job->code, job->message);
+    }
+    free(job->numbers);
+    g_free(job->text);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * 构造A的回调函数
+ * 说明：
+ * 回溯搜索最多可达TURNPIKE_MAX_NODES个节点，在工作线程中运行，界面保持响应；
+ * 搜索期间按钮变为“取消”，再次点击即置位停止标志，
+ * “列出全部解”在搜索期间不可修改
+ */
 static void on_construct_A_clicked(GtkWidget *widget, gpointer data) {
     (void)data;
     
+    if (construct_job) {
+        atomic_store(&construct_job->cancel, true);
+        return;
+    }
+    
     ErrorContext error_ctx;
     init_error_context(&error_ctx);
     
     char *input_text = NULL;
-    char *result_str = NULL;
     int *numbers = NULL;
-    int *result = NULL;
     
     TRY(&error_ctx) {
         GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input));
@@ -242,40 +415,186 @@ static void on_construct_A_clicked(GtkWidget *widget, gpointer data) {
             THROW(&error_ctx, ERROR_INVALID_INPUT, "请输入要处理的数列");
         }
         
-        numbers = malloc(MAX_NUMBERS * sizeof(int));
-        result = malloc(MAX_NUMBERS * sizeof(int));
-        
-        if (!numbers || !result) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
-        }
-        
         int count;
-        if (!parse_array_numbers(input_text, numbers, &count)) {
-            THROW(&error_ctx, ERROR_INVALID_INPUT, "无效的输入格式 - 请输入用空格或逗号分隔的数字");
-        }
+        parse_array_numbers(&error_ctx, input_text, &numbers, &count);
         
         if (count < 1) {
             THROW(&error_ctx, ERROR_INVALID_INPUT, "请至少输入一个数字");
         }
         
-        // 计算A序列
-        int A_size;
-        construct_A_from_D(numbers, count, result, &A_size);
+        ConstructJob *job = g_new0(ConstructJob, 1);
+        job->numbers = numbers;
+        job->count = count;
+        job->enumerate = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(enumerate_check));
+        job->button = widget;
+        atomic_init(&job->cancel, false);
+        if (!background_task_start(construct_work, construct_finished_idle, job)) {
+            g_free(job);
+            THROW(&error_ctx, ERROR_SYSTEM, "无法创建搜索线程");
+        }
+        // 数列已交给任务，由任务结束时释放
+        numbers = NULL;
+        construct_job = job;
+        gtk_button_set_label(GTK_BUTTON(widget), "取消构造");
+        gtk_widget_set_sensitive(enumerate_check, FALSE);
+        set_output_text("正在构造A…");
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        g_free(input_text);
+        free(numbers);
+    });
+}
+
+// 后台导出D的任务：写文件在工作线程中进行，界面更新经g_idle_add回到主线程
+typedef struct {
+    int *numbers;
+    int count;
+    gchar *out_path;
+    GtkWidget *button;              // 导出期间作为取消按钮
+    atomic_bool cancel;
+    atomic_bool progress_queued;    // 已有一个尚未执行的进度回调
+    atomic_llong done;
+    long long total;
+    long long written;
+    int status;
+    double seconds;
+    char message[256];
+} ExportJob;
+
+static ExportJob *export_job = NULL;   // 同一时间只有一个导出任务
+
+static void free_export_job(ExportJob *job) {
+    free(job->numbers);
+    g_free(job->out_path);
+    g_free(job);
+}
+
+// 主线程：显示导出进度
+static gboolean export_progress_idle(gpointer data) {
+    ExportJob *job = data;
+    atomic_store(&job->progress_queued, false);
+    long long done = atomic_load(&job->done);
+    double percent = job->total > 0 ? 100.0 * (double)done / (double)job->total : 100.0;
+    gchar *text = g_strdup_printf("正在导出D序列到：%s\n已写入 %lld / %lld 个差值（%.1f%%），再次点击按钮可取消",
+                                  job->out_path, done, job->total, percent);
+    set_output_text(text);
+    g_free(text);
+    return G_SOURCE_REMOVE;
+}
+
+// 工作线程：记录进度，同一时间最多排队一个界面回调
+static void export_report(void *user_data, long long done, long long total) {
+    (void)total;
+    ExportJob *job = user_data;
+    atomic_store(&job->done, done);
+    if (!atomic_exchange(&job->progress_queued, true)) {
+        g_idle_add(export_progress_idle, job);
+    }
+}
+
+// 主线程：导出结束，显示结果并释放任务；排在所有进度回调之后执行
+static gboolean export_finished_idle(gpointer data) {
+    ExportJob *job = data;
+    gtk_button_set_label(GTK_BUTTON(job->button), "导出D到文件");
+    export_job = NULL;
+    
+    if (job->status == 0) {
+        gchar *display = g_strdup_printf("D序列已按升序写入：%s\n共 %lld 个差值，耗时 %.2f 秒",
+                                         job->out_path, job->written, job->seconds);
+        set_output_text(display);
+        g_free(display);
+    } else if (atomic_load(&job->cancel)) {
+        set_output_text("导出已取消，未保留输出文件");
+    } else {
+        handle_error(gtk_widget_get_toplevel(job->button), ERROR_SYSTEM, job->message);
+    }
+    free_export_job(job);
+    return G_SOURCE_REMOVE;
+}
+
+// 工作线程：写文件
+static void export_work(gpointer data) {
+    ExportJob *job = data;
+    DifferenceProgress progress = { &job->cancel, export_report, job };
+    gint64 begin = g_get_monotonic_time();
+    job->status = difference_stream_to_file(job->numbers, job->count, job->out_path, &progress,
+                                            &job->written, job->message, sizeof(job->message));
+    job->seconds = (double)(g_get_monotonic_time() - begin) / 1e6;
+}
+
+/**
+ * 把A的排序后D序列流式写入文件
+ * 参数：
+ *   widget: GTK部件指针
+ *   data: 用户数据（未使用）
+ * 算法原理：
+ * 差值按升序逐个产生（见difference_stream.c），不在内存中保存D，
+ * 内存占用为O(N)，N=10^5（约5·10^9个差值）也能处理；输出框只显示统计信息。
+ * 写文件在工作线程中进行，界面保持响应；导出期间再次点击按钮即取消
+ */
+static void on_export_D_clicked(GtkWidget *widget, gpointer data) {
+    (void)data;
+    
+    if (export_job) {
+        atomic_store(&export_job->cancel, true);
+        return;
+    }
+    
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    char *input_text = NULL;
+    int *numbers = NULL;
+    gchar *out_path = NULL;
+    
+    TRY(&error_ctx) {
+        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input));
+        if (!buffer) {
+            THROW(&error_ctx, ERROR_INVALID_OPERATION, "无法获取输入缓冲区");
+        }
         
-        // 检查结果的第一个数是否为0
-        if (A_size > 0 && result[0] != 0) {
-            // 如果第一个数不是0，说明这个D序列不是有效的差分序列
-            THROW(&error_ctx, ERROR_INVALID_INPUT, "无法构造有效的A序列：输入的D序列不是有效的差分序列（A序列必须从0开始）");
+        GtkTextIter start, end;
+        gtk_text_buffer_get_bounds(buffer, &start, &end);
+        input_text = gtk_text_buffer_get_text(buffer, &start, &end, FALSE);
+        
+        if (!input_text || strlen(input_text) == 0) {
+            THROW(&error_ctx, ERROR_INVALID_INPUT, "请输入要处理的数列");
         }
         
-        // 显示结果
-        result_str = array_to_string(result, A_size);
-        if (!result_str) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        int count;
+        parse_array_numbers(&error_ctx, input_text, &numbers, &count);
+        
+        if (count < 2) {
+            THROW(&error_ctx, ERROR_INVALID_INPUT, "请至少输入两个数字");
+        }
+        if (numbers[0] != 0) {
+            THROW(&error_ctx, ERROR_INVALID_INPUT, "A序列的第一个数必须为0");
         }
         
-        GtkTextBuffer *output_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
-        gtk_text_buffer_set_text(output_buffer, result_str, -1);
+        // 用户取消保存时不做任何操作
+        out_path = choose_output_file(gtk_widget_get_toplevel(widget), "保存D序列");
+        if (out_path) {
+            ExportJob *job = g_new0(ExportJob, 1);
+            job->numbers = numbers;
+            job->count = count;
+            job->out_path = out_path;
+            job->button = widget;
+            job->total = (long long)count * (count - 1) / 2;
+            
+            if (!background_task_start(export_work, export_finished_idle, job)) {
+                g_free(job);
+                THROW(&error_ctx, ERROR_SYSTEM, "无法创建导出线程");
+            }
+            // 数列与路径已交给任务，由任务结束时释放
+            numbers = NULL;
+            out_path = NULL;
+            export_job = job;
+            gtk_button_set_label(GTK_BUTTON(widget), "取消导出");
+            set_output_text("正在导出D序列…");
+        }
     }
     CATCH(&error_ctx) {
         handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
@@ -283,11 +602,17 @@ static void on_construct_A_clicked(GtkWidget *widget, gpointer data) {
     FINALLY({
         g_free(input_text);
         free(numbers);
-        free(result);
-        free(result_str);
+        g_free(out_path);
     });
 }
 
+// 运行收费站重构的并行性能测试并显示报告；测试期间按钮不可用，界面保持响应
+static void on_benchmark_clicked(GtkWidget *widget, gpointer data) {
+    (void)data;
+    background_report_start(widget, turnpike_benchmark_report, parallel_sort_default_threads(),
+                            set_output_text, "正在运行性能测试…");
+}
+
 GtkWidget* create_sorting_page(void) {
     GtkWidget *page = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
     gtk_container_set_border_width(GTK_CONTAINER(page), 15);
@@ -299,8 +624,8 @@ GtkWidget* create_sorting_page(void) {
 
     // 创建说明文本
     GtkWidget *description = gtk_label_new(
-        "1. 构造D：输入数列A（A[0]=0），计算D[i,j] = A[i]-A[j]\n"
-        "2. 构造A：输入数列D，重构可能的数列A"
+        "1. 构造D：输入数列A（A[0]=0），计算D[i,j] = A[i]-A[j]；数列较长时可按升序流式导出到文件\n"
+        "2. 构造A：输入数列D（N(N-1)/2个差值），多线程回溯重构数列A，可列出全部解"
     );
     gtk_box_pack_start(GTK_BOX(page), description, FALSE, FALSE, 5);
 
@@ -322,12 +647,20 @@ GtkWidget* create_sorting_page(void) {
     gtk_box_pack_start(GTK_BOX(page), button_box, FALSE, FALSE, 5);
 
     GtkWidget *construct_d_button = gtk_button_new_with_label("构造D");
+    GtkWidget *export_d_button = gtk_button_new_with_label("导出D到文件");
     GtkWidget *construct_a_button = gtk_button_new_with_label("构造A");
     gtk_box_pack_start(GTK_BOX(button_box), construct_d_button, TRUE, TRUE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), export_d_button, TRUE, TRUE, 5);
     gtk_box_pack_start(GTK_BOX(button_box), construct_a_button, TRUE, TRUE, 5);
+    enumerate_check = gtk_check_button_new_with_label("列出全部解");
+    gtk_box_pack_start(GTK_BOX(button_box), enumerate_check, FALSE, FALSE, 5);
+    GtkWidget *benchmark_button = gtk_button_new_with_label("性能测试");
+    gtk_box_pack_start(GTK_BOX(button_box), benchmark_button, TRUE, TRUE, 5);
 
     g_signal_connect(construct_d_button, "clicked", G_CALLBACK(on_construct_D_clicked), NULL);
+    g_signal_connect(export_d_button, "clicked", G_CALLBACK(on_export_D_clicked), NULL);
     g_signal_connect(construct_a_button, "clicked", G_CALLBACK(on_construct_A_clicked), NULL);
+    g_signal_connect(benchmark_button, "clicked", G_CALLBACK(on_benchmark_clicked), NULL);
 
     // 创建输出区域
     GtkWidget *output_frame = gtk_frame_new("输出结果");
@@ -346,27 +679,29 @@ GtkWidget* create_sorting_page(void) {
     return page;
 }
 
-// 排序数组 - 使用快速排序
+/**
+ * 排序数组
+ * 算法原理：
+ * 使用LSD基数排序（小数组内部改用插入排序），不做比较，时间复杂度O(n)；
+ * 元素不少于PARALLEL_SORT_MIN_SIZE时改用多线程样本排序，结果相同；
+ * 临时缓冲区分配失败时退回原地的内省排序（见sort_template.h）
+ */
 void sort_array(int* arr, int size) {
     if (!arr || size <= 0) return;
-    qsort(arr, size, sizeof(int), compare_ints);
+    if (size >= PARALLEL_SORT_MIN_SIZE) {
+        parallel_sort_ints(arr, (size_t)size, parallel_sort_default_threads());
+    } else if (!radix_sort_i32(arr, (size_t)size)) {
+        sort_i32(arr, (size_t)size);
+    }
 }
 
-// 将数组转换为字符串
+// 将数组转换为字符串，按上界一次分配后顺序写入
 static char* array_to_string(const int arr[], int size) {
     if (!arr || size <= 0) return NULL;
     
-    char* result = malloc(size * 12 + 1);  // 每个数字最多10位，加上逗号和空格
+    char* result = malloc(int_format_bound((size_t)size, 2));
     if (!result) return NULL;
     
-    result[0] = '\0';
-    for (int i = 0; i < size; i++) {
-        char temp[12];
-        snprintf(temp, sizeof(temp), "%d", arr[i]);
-        strcat(result, temp);
-        if (i < size - 1) {
-            strcat(result, ", ");
-        }
-    }
+    int_format_join(result, arr, (size_t)size, ", ");
     return result;
 }
@@ -0,0 +1,608 @@
+#include "turnpike.h"
+#include "radix_sort.h"
+#include "sort_kernels.h"
+#include "../utils/xxhash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+// 距离多重集：升序的不同距离及各自剩余的个数，哈希表把距离映射到下标
+typedef struct {
+    int *values;
+    int *counts;
+    int distinct;
+    int32_t *table;             // 开放寻址，存放下标，-1表示空槽
+    size_t mask;
+} DistanceSet;
+
+// 一个待搜索的子树：从根（两端点）依次放置的点，最后一个点尚未检验
+typedef struct {
+    int *points;
+    int count;
+} SearchTask;
+
+// 工作线程的任务双端队列：本线程从尾部压入和弹出，其他线程从头部窃取
+typedef struct {
+    SearchTask *items;
+    int head;
+    int tail;
+    int capacity;
+    pthread_mutex_t lock;
+} TaskDeque;
+
+// 所有工作线程共享的只读输入与同步状态
+typedef struct {
+    DistanceSet set;            // counts为删去最大距离后的初始计数，各线程复制一份
+    int n;
+    int width;
+    TurnpikeCallback callback;
+    void *user_data;
+    long long max_nodes;
+    atomic_bool *cancel;        // 调用者的取消标志，可为NULL
+    TurnpikeStats *stats;
+    pthread_mutex_t lock;       // 保护stats->solutions、seen与回调
+    uint64_t *seen;             // 已报告解的哈希值（开放寻址，0表示空槽）
+    size_t seen_count;
+    size_t seen_mask;
+    atomic_bool stop;           // 找到所需的解、回调要求停止、达到节点上限或被取消
+    atomic_llong nodes;
+    TaskDeque *deques;          // 每个工作线程一个；单线程搜索时为NULL
+    int threads;
+    atomic_int idle;            // 正在寻找任务的线程数，大于0时才拆分子树
+    atomic_llong pending;       // 已创建但尚未完成的任务数，为0时搜索结束
+} Shared;
+
+// 一个工作线程的搜索状态：独立的距离计数与已放置的点
+typedef struct {
+    Shared *shared;
+    int *counts;
+    int top;                    // 剩余距离中最大者的下标（其上方的计数都为0）
+    int *points;                // 已放置的点，按放置顺序
+    int placed;
+    int *solution;              // 回调用的升序副本
+    long long local_nodes;      // 尚未累加到共享计数的节点数
+    int index;                  // 工作线程编号
+} Search;
+
+static void set_error(char *error, size_t error_size, const char *format, ...) {
+    if (!error || error_size == 0) return;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+}
+
+static inline size_t hash_int(int value) {
+    return (size_t)(((uint32_t)value * 0x9E3779B1u) >> 7);
+}
+
+// 距离value在多重集中的下标，不存在时返回-1
+static inline int distance_index(const DistanceSet *set, int value) {
+    for (size_t slot = hash_int(value) & set->mask; ; slot = (slot + 1) & set->mask) {
+        int32_t index = set->table[slot];
+        if (index < 0 || set->values[index] == value) return index;
+    }
+}
+
+/**
+ * 由点数求距离个数的反函数
+ * 参数：
+ *   distance_count: 距离个数m
+ * 返回值：
+ *   满足n(n-1)/2 = m的点数n，不存在时返回-1
+ */
+int turnpike_point_count(long long distance_count) {
+    if (distance_count < 0) return -1;
+    long long n = (long long)((1.0 + sqrt(1.0 + 8.0 * (double)distance_count)) / 2.0);
+    // 浮点开方可能差1，向两侧各检查一次
+    for (long long k = n > 1 ? n - 1 : 1; k <= n + 1; k++) {
+        if (k * (k - 1) / 2 == distance_count) return k <= INT_MAX ? (int)k : -1;
+    }
+    return -1;
+}
+
+// 取绝对值、排序并统计重数，建立距离到下标的哈希表
+static bool build_distance_set(DistanceSet *set, const int *distances, int count) {
+    int *sorted = malloc((size_t)count * sizeof(int) + 1);
+    if (!sorted) return false;
+    for (int i = 0; i < count; i++) {
+        sorted[i] = abs(distances[i]);
+    }
+    if (!radix_sort_i32(sorted, (size_t)count)) {
+        sort_i32(sorted, (size_t)count);
+    }
+
+    int distinct = 0;
+    for (int i = 0; i < count; i++) {
+        if (i == 0 || sorted[i] != sorted[i - 1]) distinct++;
+    }
+
+    size_t table_size = 1;
+    while (table_size < (size_t)distinct * 2) {
+        table_size *= 2;
+    }
+    set->values = malloc((size_t)distinct * sizeof(int) + 1);
+    set->counts = malloc((size_t)distinct * sizeof(int) + 1);
+    set->table = malloc(table_size * sizeof(int32_t));
+    if (!set->values || !set->counts || !set->table) {
+        free(sorted);
+        return false;
+    }
+
+    set->distinct = 0;
+    for (int i = 0; i < count; i++) {
+        if (i == 0 || sorted[i] != sorted[i - 1]) {
+            set->values[set->distinct] = sorted[i];
+            set->counts[set->distinct] = 0;
+            set->distinct++;
+        }
+        set->counts[set->distinct - 1]++;
+    }
+    free(sorted);
+
+    set->mask = table_size - 1;
+    memset(set->table, 0xFF, table_size * sizeof(int32_t));
+    for (int i = 0; i < set->distinct; i++) {
+        size_t slot = hash_int(set->values[i]) & set->mask;
+        while (set->table[slot] >= 0) {
+            slot = (slot + 1) & set->mask;
+        }
+        set->table[slot] = i;
+    }
+    return true;
+}
+
+static void free_distance_set(DistanceSet *set) {
+    free(set->values);
+    free(set->counts);
+    free(set->table);
+}
+
+// 把x到points[0..upto)的距离放回多重集，撤销try_place对这些距离的删除
+static inline void restore_distances(Search *s, int x, int upto) {
+    for (int i = 0; i < upto; i++) {
+        s->counts[distance_index(&s->shared->set, abs(x - s->points[i]))]++;
+    }
+}
+
+/**
+ * 尝试在位置x放置一个点
+ * 返回值：
+ *   x到所有已放置点的距离都在剩余多重集中时删除这些距离并返回true；
+ *   否则恢复已删除的距离并返回false
+ */
+static bool try_place(Search *s, int x) {
+    for (int i = 0; i < s->placed; i++) {
+        int index = distance_index(&s->shared->set, abs(x - s->points[i]));
+        if (index < 0 || s->counts[index] == 0) {
+            restore_distances(s, x, i);
+            return false;
+        }
+        s->counts[index]--;
+    }
+    s->points[s->placed++] = x;
+    return true;
+}
+
+// 记录一个解的哈希值，已出现过时返回false；表满一半时加倍（内存不足时不再去重）
+static bool remember_solution(Shared *sh, uint64_t hash) {
+    hash |= 1;
+    if ((sh->seen_count + 1) * 2 > sh->seen_mask + 1) {
+        size_t size = (sh->seen_mask + 1) * 2;
+        uint64_t *table = calloc(size, sizeof(uint64_t));
+        if (!table) return true;
+        for (size_t i = 0; i <= sh->seen_mask; i++) {
+            if (!sh->seen[i]) continue;
+            size_t slot = sh->seen[i] & (size - 1);
+            while (table[slot]) slot = (slot + 1) & (size - 1);
+            table[slot] = sh->seen[i];
+        }
+        free(sh->seen);
+        sh->seen = table;
+        sh->seen_mask = size - 1;
+    }
+
+    size_t slot = hash & sh->seen_mask;
+    for (; sh->seen[slot]; slot = (slot + 1) & sh->seen_mask) {
+        if (sh->seen[slot] == hash) return false;
+    }
+    sh->seen[slot] = hash;
+    sh->seen_count++;
+    return true;
+}
+
+/**
+ * 报告一个解，返回是否继续搜索
+ * 说明：
+ * y与width-y都是解中的点时，两种放置顺序会得到同一个点集；
+ * 解及其镜像规范化为同一个升序点列后按哈希去重。多个线程的解在锁内逐个报告
+ */
+static bool report_solution(Search *s) {
+    Shared *sh = s->shared;
+    int n = sh->n;
+    int *sol = s->solution;
+    memcpy(sol, s->points, (size_t)n * sizeof(int));
+    insertion_sort_i32(sol, (size_t)n);
+
+    // 解与其镜像取字典序较小者，使互为镜像的两个解只报告一次
+    int i = 0;
+    while (i < n && sol[i] == sh->width - sol[n - 1 - i]) i++;
+    if (i < n && sh->width - sol[n - 1 - i] < sol[i]) {
+        for (int l = 0, r = n - 1; l <= r; l++, r--) {
+            int left = sol[l];
+            sol[l] = sh->width - sol[r];
+            sol[r] = sh->width - left;
+        }
+    }
+
+    uint64_t hash = xxh64(sol, (size_t)n * sizeof(int), 0);
+    bool go_on = true;
+    pthread_mutex_lock(&sh->lock);
+    if (!atomic_load(&sh->stop) && remember_solution(sh, hash)) {
+        sh->stats->solutions++;
+        go_on = sh->callback && sh->callback(sh->user_data, sol, n);
+        if (!go_on) atomic_store(&sh->stop, true);
+    }
+    pthread_mutex_unlock(&sh->lock);
+    return go_on;
+}
+
+// 把本线程的节点数累加到共享计数，超过上限时通知所有线程停止
+static void flush_nodes(Search *s) {
+    Shared *sh = s->shared;
+    long long total = atomic_fetch_add(&sh->nodes, s->local_nodes) + s->local_nodes;
+    s->local_nodes = 0;
+    if (total > sh->max_nodes) {
+        atomic_store(&sh->stop, true);
+        pthread_mutex_lock(&sh->lock);
+        sh->stats->exhausted = true;
+        pthread_mutex_unlock(&sh->lock);
+    }
+    if (sh->cancel && atomic_load_explicit(sh->cancel, memory_order_relaxed)) {
+        atomic_store(&sh->stop, true);
+        pthread_mutex_lock(&sh->lock);
+        sh->stats->cancelled = true;
+        pthread_mutex_unlock(&sh->lock);
+    }
+}
+
+// 在本线程的队列尾部压入一个任务（任务的点列随之转交给队列）；内存不足时返回false
+static bool push_task(Shared *sh, int worker, SearchTask task) {
+    TaskDeque *dq = &sh->deques[worker];
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail == dq->capacity && dq->head > 0) {
+        memmove(dq->items, dq->items + dq->head, (size_t)(dq->tail - dq->head) * sizeof(SearchTask));
+        dq->tail -= dq->head;
+        dq->head = 0;
+    }
+    if (dq->tail == dq->capacity) {
+        int capacity = dq->capacity ? dq->capacity * 2 : 64;
+        SearchTask *items = realloc(dq->items, (size_t)capacity * sizeof(SearchTask));
+        if (!items) {
+            pthread_mutex_unlock(&dq->lock);
+            return false;
+        }
+        dq->items = items;
+        dq->capacity = capacity;
+    }
+    atomic_fetch_add(&sh->pending, 1);
+    dq->items[dq->tail++] = task;
+    pthread_mutex_unlock(&dq->lock);
+    return true;
+}
+
+// 把“当前已放置的点 + 另一种放置x”拆分为任务，失败时返回false，由调用者自己搜索该子树
+static bool split_task(Search *s, int x) {
+    // 两端点对每个任务都相同，不必记录
+    int count = s->placed - 2;
+    SearchTask task = { malloc((size_t)(count + 1) * sizeof(int)), count + 1 };
+    if (!task.points) return false;
+    memcpy(task.points, s->points + 2, (size_t)count * sizeof(int));
+    task.points[count] = x;
+    if (!push_task(s->shared, s->index, task)) {
+        free(task.points);
+        return false;
+    }
+    return true;
+}
+
+// 从队列中取出一个任务：from_tail为true时取最新的（本线程），否则取最旧的（窃取）
+static bool take_task(TaskDeque *dq, bool from_tail, SearchTask *task) {
+    pthread_mutex_lock(&dq->lock);
+    bool found = dq->head < dq->tail;
+    if (found) {
+        *task = from_tail ? dq->items[--dq->tail] : dq->items[dq->head++];
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+/**
+ * 回溯搜索
+ * 返回值：
+ *   需要继续搜索时返回true（回调要求停止或达到节点上限时返回false）
+ * 算法原理：
+ * 剩余距离中最大的一个y必然是某个未放置点到左端点0或右端点width的距离，
+ * 因此新点只可能在y或width-y处；两种位置各试一次，失败则恢复删除的距离。
+ * 并行搜索时，若有线程空闲，第二种位置作为任务压入本线程的队列供其窃取
+ */
+static bool search(Search *s) {
+    Shared *sh = s->shared;
+    if (++s->local_nodes >= 1024) {
+        flush_nodes(s);
+    }
+    if (atomic_load_explicit(&sh->stop, memory_order_relaxed)) {
+        return false;
+    }
+    if (s->placed == sh->n) {
+        return report_solution(s);
+    }
+
+    int saved_top = s->top;
+    while (s->top >= 0 && s->counts[s->top] == 0) {
+        s->top--;
+    }
+    int y = sh->set.values[s->top];
+    bool go_on = true;
+
+    // 只放了两个端点时，两种位置互为镜像，只试一种
+    int candidates[2] = { y, sh->width - y };
+    int tries = s->placed == 2 || candidates[0] == candidates[1] ? 1 : 2;
+    if (tries == 2 && sh->deques && atomic_load_explicit(&sh->idle, memory_order_relaxed) > 0 &&
+        split_task(s, candidates[1])) {
+        tries = 1;
+    }
+    for (int c = 0; c < tries && go_on; c++) {
+        if (try_place(s, candidates[c])) {
+            go_on = search(s);
+            s->placed--;
+            restore_distances(s, candidates[c], s->placed);
+        }
+    }
+
+    s->top = saved_top;
+    return go_on;
+}
+
+// 从两端点出发重放任务中的点，再搜索其子树；结束后状态恢复为只有两端点
+static void run_task(Search *s, const SearchTask *task) {
+    bool valid = true;
+    for (int i = 0; i < task->count && valid; i++) {
+        valid = try_place(s, task->points[i]);
+    }
+    if (valid) {
+        search(s);
+    }
+    while (s->placed > 2) {
+        s->placed--;
+        restore_distances(s, s->points[s->placed], s->placed);
+    }
+}
+
+/**
+ * 工作线程主循环
+ * 算法原理：
+ * 先取本线程队列尾部的任务（深度优先，局部性好），为空时从其他线程队列头部窃取
+ * 最旧的任务（靠近根，子树最大）；pending为0说明所有任务都已完成
+ */
+static void* search_worker(void *arg) {
+    Search *s = arg;
+    Shared *sh = s->shared;
+    bool idle = false;
+
+    for (;;) {
+        SearchTask task;
+        bool found = take_task(&sh->deques[s->index], true, &task);
+        for (int k = 1; !found && k < sh->threads; k++) {
+            found = take_task(&sh->deques[(s->index + k) % sh->threads], false, &task);
+        }
+
+        if (!found) {
+            if (atomic_load(&sh->pending) == 0) break;
+            if (!idle) {
+                idle = true;
+                atomic_fetch_add(&sh->idle, 1);
+            }
+            sched_yield();
+            continue;
+        }
+        if (idle) {
+            idle = false;
+            atomic_fetch_sub(&sh->idle, 1);
+        }
+
+        if (!atomic_load(&sh->stop)) {
+            run_task(s, &task);
+        }
+        free(task.points);
+        atomic_fetch_sub(&sh->pending, 1);
+    }
+
+    if (idle) atomic_fetch_sub(&sh->idle, 1);
+    flush_nodes(s);
+    return NULL;
+}
+
+// 为一个工作线程分配独立的搜索状态，初始只放置两端点
+static bool init_search(Search *s, Shared *sh, int index) {
+    memset(s, 0, sizeof(*s));
+    s->shared = sh;
+    s->index = index;
+    s->top = sh->set.distinct - 1;
+    s->counts = malloc((size_t)sh->set.distinct * sizeof(int) + 1);
+    s->points = malloc((size_t)sh->n * sizeof(int));
+    s->solution = malloc((size_t)sh->n * sizeof(int));
+    if (!s->counts || !s->points || !s->solution) return false;
+
+    memcpy(s->counts, sh->set.counts, (size_t)sh->set.distinct * sizeof(int));
+    s->points[s->placed++] = 0;
+    if (sh->n > 1) {
+        s->points[s->placed++] = sh->width;
+    }
+    return true;
+}
+
+static void free_search(Search *s) {
+    free(s->counts);
+    free(s->points);
+    free(s->solution);
+}
+
+/**
+ * 多线程工作窃取搜索
+ * 说明：
+ * 每个线程有自己的距离计数与放置序列，任务只记录从根到子树的放置序列，
+ * 取到任务后在本线程的状态上重放；线程创建失败时由已启动的线程完成全部任务
+ */
+static bool search_parallel(Shared *sh, int threads) {
+    Search *workers = calloc((size_t)threads, sizeof(Search));
+    TaskDeque *deques = calloc((size_t)threads, sizeof(TaskDeque));
+    pthread_t *ids = malloc((size_t)threads * sizeof(pthread_t));
+    bool *started = calloc((size_t)threads, sizeof(bool));
+    bool ok = workers && deques && ids && started;
+    for (int t = 0; deques && t < threads; t++) {
+        pthread_mutex_init(&deques[t].lock, NULL);
+    }
+    for (int t = 0; ok && t < threads; t++) {
+        ok = init_search(&workers[t], sh, t);
+    }
+
+    if (ok) {
+        // 根任务：只有两端点，放置序列为空
+        sh->deques = deques;
+        sh->threads = threads;
+        SearchTask root = { malloc(sizeof(int)), 0 };
+        ok = root.points && push_task(sh, 0, root);
+        if (!ok) free(root.points);
+    }
+    if (ok) {
+        for (int t = 1; t < threads; t++) {
+            started[t] = pthread_create(&ids[t], NULL, search_worker, &workers[t]) == 0;
+        }
+        search_worker(&workers[0]);
+        for (int t = 1; t < threads; t++) {
+            if (started[t]) pthread_join(ids[t], NULL);
+        }
+    }
+
+    for (int t = 0; deques && t < threads; t++) {
+        for (int i = deques[t].head; i < deques[t].tail; i++) {
+            free(deques[t].items[i].points);
+        }
+        free(deques[t].items);
+        pthread_mutex_destroy(&deques[t].lock);
+    }
+    for (int t = 0; workers && t < threads; t++) {
+        free_search(&workers[t]);
+    }
+    sh->deques = NULL;
+    free(workers);
+    free(deques);
+    free(ids);
+    free(started);
+    return ok;
+}
+
+/**
+ * 由两两距离的多重集重构点集（收费站问题 / partial digest）
+ * 参数：
+ *   distances, count: 距离多重集，取绝对值，顺序任意，个数须为n(n-1)/2
+ *   callback, user_data: 每个解调用一次，为NULL时找到第一个解即停止
+ *   max_nodes: 搜索节点上限，防止病态输入使界面长时间无响应
+ *   threads: 工作线程数，小于等于1时在当前线程上搜索
+ *   cancel: 取消标志，可为NULL；每搜索约1024个节点检查一次，置位后尽快停止
+ *   stats: 搜索统计
+ *   error, error_size: 失败时的错误信息
+ * 返回值：
+ *   输入有效返回0（是否有解见stats->solutions），否则返回-1
+ * 算法原理：
+ * 1. 距离排序后记为“不同距离 + 重数”，哈希表把距离映射到下标，
+ *    删除与恢复一个距离都是O(1)的计数增减
+ * 2. 最大距离确定两端点0与width；此后每层取剩余的最大距离y，新点只能在y或width-y处，
+ *    它到已放置各点的距离必须都还在多重集中，否则立即剪枝
+ * 3. 回溯时由撤下的点重新算出它到其余各点的距离并放回多重集，
+ *    不保存undo栈，每个线程的额外内存只有O(n)
+ * 4. 多线程时两种放置分支通过工作窃取分散到各线程，找到所需的解后全部线程立即停止
+ * 互为镜像的解（x -> width - x）只报告一个，同一点集经不同放置顺序得到时也只报告一次
+ * 时间复杂度：对绝大多数输入接近O(n² log n)，最坏情况为指数级（由节点上限截断）
+ */
+int turnpike_solve_parallel(const int *distances, int count, TurnpikeCallback callback, void *user_data,
+                            long long max_nodes, int threads, atomic_bool *cancel, TurnpikeStats *stats,
+                            char *error, size_t error_size) {
+    memset(stats, 0, sizeof(*stats));
+    int n = turnpike_point_count(count);
+    if (n < 0) {
+        set_error(error, error_size, "距离个数%d不是n(n-1)/2的形式", count);
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (distances[i] == INT_MIN) {
+            set_error(error, error_size, "距离超出范围");
+            return -1;
+        }
+    }
+    stats->n = n;
+    if (threads > TURNPIKE_MAX_THREADS) threads = TURNPIKE_MAX_THREADS;
+
+    Shared sh = {
+        .n = n,
+        .callback = callback,
+        .user_data = user_data,
+        .max_nodes = max_nodes,
+        .cancel = cancel,
+        .stats = stats,
+        .seen_mask = 7
+    };
+    pthread_mutex_init(&sh.lock, NULL);
+    atomic_init(&sh.stop, false);
+    atomic_init(&sh.nodes, 0);
+    atomic_init(&sh.idle, 0);
+    atomic_init(&sh.pending, 0);
+    sh.seen = calloc(sh.seen_mask + 1, sizeof(uint64_t));
+
+    bool ok = sh.seen && build_distance_set(&sh.set, distances, count);
+    if (ok && n > 1) {
+        // 最大距离是两端点之间的距离
+        sh.width = sh.set.values[sh.set.distinct - 1];
+        sh.set.counts[sh.set.distinct - 1]--;
+    }
+
+    if (ok && (threads <= 1 || n <= 3)) {
+        Search s;
+        ok = init_search(&s, &sh, 0);
+        if (ok) {
+            if (n == 1) {
+                report_solution(&s);
+            } else {
+                search(&s);
+            }
+            flush_nodes(&s);
+        }
+        free_search(&s);
+    } else if (ok) {
+        ok = search_parallel(&sh, threads);
+    }
+    if (!ok) {
+        set_error(error, error_size, "内存分配失败");
+    }
+    stats->nodes = atomic_load(&sh.nodes);
+
+    pthread_mutex_destroy(&sh.lock);
+    free(sh.seen);
+    free_distance_set(&sh.set);
+    return ok ? 0 : -1;
+}
+
+// 单线程重构，见turnpike_solve_parallel
+int turnpike_solve(const int *distances, int count, TurnpikeCallback callback, void *user_data,
+                   long long max_nodes, TurnpikeStats *stats, char *error, size_t error_size) {
+    return turnpike_solve_parallel(distances, count, callback, user_data, max_nodes, 1, NULL,
+                                   stats, error, error_size);
+}
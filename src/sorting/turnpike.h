@@ -0,0 +1,31 @@
+#ifndef TURNPIKE_H
+#define TURNPIKE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+// 并行搜索最多使用的工作线程数
+#define TURNPIKE_MAX_THREADS 64
+
+// 每找到一个解调用一次，points为升序的n个点（首点为0）；返回false时停止搜索
+typedef bool (*TurnpikeCallback)(void *user_data, const int *points, int n);
+
+// 搜索统计
+typedef struct {
+    int n;                      // 点的个数
+    long long solutions;        // 找到的解的个数（互为镜像的两个解只计一次）
+    long long nodes;            // 搜索树的节点数
+    bool exhausted;             // 达到节点上限而中止，可能还有未找到的解
+    bool cancelled;             // 调用者置位取消标志而中止
+} TurnpikeStats;
+
+// 函数声明
+int turnpike_point_count(long long distance_count);
+int turnpike_solve(const int *distances, int count, TurnpikeCallback callback, void *user_data,
+                   long long max_nodes, TurnpikeStats *stats, char *error, size_t error_size);
+int turnpike_solve_parallel(const int *distances, int count, TurnpikeCallback callback, void *user_data,
+                            long long max_nodes, int threads, atomic_bool *cancel, TurnpikeStats *stats,
+                            char *error, size_t error_size);
+
+#endif
@@ -0,0 +1,119 @@
+#include "turnpike_bench.h"
+#include "turnpike.h"
+#include "../utils/xorshift.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+// 困难实例：n个点随机落在[0, range]内，点大量重合，差值重数高，回溯分支多
+typedef struct {
+    int n;
+    int range;
+} HardInstance;
+
+static const HardInstance hard_suite[] = {
+    { 24, 3 },
+    { 28, 7 },
+    { 32, 4 },
+    { 32, 8 },
+    { 40, 10 },
+};
+
+#define HARD_SUITE_SIZE ((int)(sizeof(hard_suite) / sizeof(hard_suite[0])))
+
+/**
+ * 生成一个困难实例的差值序列
+ * 参数：
+ *   instance: 实例规模
+ *   seed: 随机数状态
+ *   distances: 输出，n(n-1)/2个差值
+ * 返回值：
+ *   差值个数
+ */
+static int fill_hard_instance(const HardInstance *instance, uint32_t *seed, int *distances) {
+    int points[64];
+    points[0] = 0;
+    points[1] = instance->range;
+    for (int i = 2; i < instance->n; i++) {
+        points[i] = (int)(xorshift32_next(seed) % (uint32_t)(instance->range + 1));
+    }
+
+    int count = 0;
+    for (int i = 0; i < instance->n; i++) {
+        for (int j = 0; j < i; j++) {
+            distances[count++] = abs(points[i] - points[j]);
+        }
+    }
+    return count;
+}
+
+// 枚举模式：接收全部解
+static bool accept_solution(void *user_data, const int *points, int n) {
+    (void)user_data;
+    (void)points;
+    (void)n;
+    return true;
+}
+
+// 测试的线程数序列：1、2、4……倍增，最后一项为max_threads
+static int next_thread_count(int threads, int max_threads) {
+    if (threads >= max_threads) return max_threads + 1;
+    return threads * 2 < max_threads ? threads * 2 : max_threads;
+}
+
+/**
+ * 运行收费站重构的并行性能测试
+ * 返回值：
+ *   测试报告文本，调用者用g_free释放；内存不足返回NULL
+ * 算法原理：
+ * 1. 用固定种子生成一组点大量重合的困难实例，它们的差值重数高，
+ *    左右两种放置都常常可行，搜索树远大于随机实例
+ * 2. 以枚举模式（找出全部解）运行，每个实例最多搜索TURNPIKE_BENCH_MAX_NODES个节点，
+ *    线程数按1、2、4……倍增到max_threads
+ * 3. 线程数不同时搜索顺序不同，节点数可能略有差别，因此加速比按节点吞吐量计算
+ */
+gchar* turnpike_benchmark_report(int max_threads) {
+    int max_n = 0;
+    for (int i = 0; i < HARD_SUITE_SIZE; i++) {
+        if (hard_suite[i].n > max_n) max_n = hard_suite[i].n;
+    }
+    int *distances = malloc((size_t)max_n * (size_t)(max_n - 1) / 2 * sizeof(int));
+    if (!distances) return NULL;
+
+    GString *report = g_string_new(NULL);
+    g_string_append(report, "收费站重构并行搜索性能测试（枚举全部解）\n实例：");
+    for (int i = 0; i < HARD_SUITE_SIZE; i++) {
+        g_string_append_printf(report, "%sn=%d/值域%d", i > 0 ? "，" : "",
+                               hard_suite[i].n, hard_suite[i].range);
+    }
+    g_string_append_printf(report, "\n每个实例最多搜索 %lld 个节点\n\n", TURNPIKE_BENCH_MAX_NODES);
+
+    double single = 0.0;
+    for (int threads = 1; threads <= max_threads; threads = next_thread_count(threads, max_threads)) {
+        uint32_t seed = 12345;
+        long long nodes = 0;
+        long long solutions = 0;
+        gint64 start = g_get_monotonic_time();
+        for (int i = 0; i < HARD_SUITE_SIZE; i++) {
+            int count = fill_hard_instance(&hard_suite[i], &seed, distances);
+            TurnpikeStats stats;
+            char message[256];
+            if (turnpike_solve_parallel(distances, count, accept_solution, NULL,
+                                        TURNPIKE_BENCH_MAX_NODES, threads, NULL, &stats,
+                                        message, sizeof(message)) != 0) {
+                g_string_append_printf(report, "%2d 线程  失败：%s\n", threads, message);
+                continue;
+            }
+            nodes += stats.nodes;
+            solutions += stats.solutions;
+        }
+        double seconds = (double)(g_get_monotonic_time() - start) / 1e6;
+        double throughput = seconds > 0.0 ? (double)nodes / seconds : 0.0;
+        if (threads == 1) single = throughput;
+        g_string_append_printf(report, "%2d 线程  %.2f 秒  %.1f M节点/秒  加速比 %.2fx  （%lld 个解）\n",
+                               threads, seconds, throughput / 1e6,
+                               single > 0.0 ? throughput / single : 0.0, solutions);
+    }
+
+    free(distances);
+    return g_string_free(report, FALSE);
+}
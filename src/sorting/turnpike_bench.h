@@ -0,0 +1,12 @@
+#ifndef TURNPIKE_BENCH_H
+#define TURNPIKE_BENCH_H
+
+#include <gtk/gtk.h>
+
+// 性能测试中每个实例的搜索节点上限
+#define TURNPIKE_BENCH_MAX_NODES 2000000LL
+
+// 函数声明
+gchar* turnpike_benchmark_report(int max_threads);
+
+#endif
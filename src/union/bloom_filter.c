@@ -0,0 +1,144 @@
+#include "bloom_filter.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 每个字选位使用的乘法常数（奇数），8个字各选出一位
+static const uint32_t bloom_salts[BLOOM_BLOCK_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+// 64位混合哈希（splitmix64的终结步骤），高32位选块，低32位选块内的位
+static inline uint64_t bloom_hash(int key) {
+    uint64_t h = (uint64_t)(uint32_t)key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// 把哈希高32位按比例映射到[0, block_count)，避免取模
+static inline const uint64_t* bloom_block(const BloomFilter *filter, uint64_t h) {
+    size_t index = (size_t)(((h >> 32) * (uint64_t)filter->block_count) >> 32);
+    return filter->blocks + index * BLOOM_BLOCK_WORDS;
+}
+
+/**
+ * 初始化过滤器
+ * 参数：
+ *   filter: 过滤器
+ *   expected: 预计的键个数
+ * 返回值：
+ *   成功返回true，内存分配失败返回false
+ */
+bool bloom_init(BloomFilter *filter, size_t expected) {
+    size_t bits = expected * BLOOM_BITS_PER_KEY;
+    size_t block_bits = BLOOM_BLOCK_WORDS * 64;
+    size_t count = (bits + block_bits - 1) / block_bits;
+    if (count == 0) count = 1;
+
+    size_t bytes = count * BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+    filter->blocks = aligned_alloc(64, bytes);
+    filter->block_count = filter->blocks ? count : 0;
+    if (!filter->blocks) return false;
+    memset(filter->blocks, 0, bytes);
+    return true;
+}
+
+void bloom_free(BloomFilter *filter) {
+    free(filter->blocks);
+    filter->blocks = NULL;
+    filter->block_count = 0;
+}
+
+/**
+ * 加入一个键
+ * 算法原理：
+ * 先选定一块，再用8个不同的乘法常数各在块内的一个字中置一位；
+ * 查询时8个字互相独立，可以无分支地一起判断
+ */
+void bloom_add(BloomFilter *filter, int key) {
+    uint64_t h = bloom_hash(key);
+    uint64_t *block = (uint64_t*)bloom_block(filter, h);
+    uint32_t low = (uint32_t)h;
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+        block[i] |= 1ULL << ((low * bloom_salts[i]) >> 26);
+    }
+}
+
+// 键可能存在时返回true；返回false时键一定不存在
+bool bloom_may_contain(const BloomFilter *filter, int key) {
+    uint64_t h = bloom_hash(key);
+    const uint64_t *block = bloom_block(filter, h);
+    uint32_t low = (uint32_t)h;
+    uint64_t missing = 0;
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+        missing |= ~block[i] & (1ULL << ((low * bloom_salts[i]) >> 26));
+    }
+    return missing == 0;
+}
+
+// 为一组键建立过滤器
+bool bloom_build(BloomFilter *filter, const int *keys, int size) {
+    if (!bloom_init(filter, (size_t)size)) return false;
+    for (int i = 0; i < size; i++) {
+        bloom_add(filter, keys[i]);
+    }
+    return true;
+}
+
+/**
+ * 用过滤器加速小集合对大集合的求交与求差
+ * 参数：
+ *   filter: 在ref上建立的过滤器
+ *   probe, np: 升序且去重的小集合
+ *   ref, nref: 升序且去重的大集合
+ *   members_out, members_size: probe ∩ ref，可为NULL
+ *   missing_out, missing_size: probe - ref，可为NULL
+ *   stats: 累加过滤统计，可为NULL
+ * 算法原理：
+ * 1. 大多数不在ref中的元素被过滤器一次缓存行访问直接排除
+ * 2. 只有通过过滤器的元素才在ref中做精确的二分查找；probe有序，
+ *    因此每次查找都从上一次的位置开始，查找区间单调缩小
+ * 时间复杂度：O(np + 通过数 * log nref)
+ */
+void bloom_probe_sorted(const BloomFilter *filter, const int *probe, int np, const int *ref, int nref,
+                        int *members_out, int *members_size, int *missing_out, int *missing_size,
+                        BloomStats *stats) {
+    int members = 0, missing = 0;
+    long long passed = 0, found_count = 0;
+    int base = 0;
+
+    for (int i = 0; i < np; i++) {
+        int key = probe[i];
+        bool found = false;
+        if (bloom_may_contain(filter, key)) {
+            passed++;
+            int lo = base, hi = nref;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (ref[mid] < key) lo = mid + 1;
+                else hi = mid;
+            }
+            base = lo;
+            found = lo < nref && ref[lo] == key;
+        }
+
+        if (found) {
+            found_count++;
+            if (members_out) members_out[members++] = key;
+        } else if (missing_out) {
+            missing_out[missing++] = key;
+        }
+    }
+
+    if (members_size) *members_size = members;
+    if (missing_size) *missing_size = missing;
+    if (stats) {
+        stats->probes += np;
+        stats->passed += passed;
+        stats->members += found_count;
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 每个键占用的位数，约对应1%的误判率
+#define BLOOM_BITS_PER_KEY 12
+// 每块8个64位字，恰好是一条64字节的缓存行
+#define BLOOM_BLOCK_WORDS 8
+
+// 分块布隆过滤器：一个键的所有位都落在同一块中，一次查询只访问一条缓存行
+typedef struct {
+    uint64_t *blocks;       // block_count * BLOOM_BLOCK_WORDS 个字，按64字节对齐
+    size_t block_count;
+} BloomFilter;
+
+// 过滤统计
+typedef struct {
+    long long probes;       // 查询次数
+    long long passed;       // 通过过滤器、需要精确查找的次数
+    long long members;      // 精确查找确认存在的次数
+} BloomStats;
+
+// 函数声明
+bool bloom_init(BloomFilter *filter, size_t expected);
+void bloom_free(BloomFilter *filter);
+void bloom_add(BloomFilter *filter, int key);
+bool bloom_may_contain(const BloomFilter *filter, int key);
+bool bloom_build(BloomFilter *filter, const int *keys, int size);
+void bloom_probe_sorted(const BloomFilter *filter, const int *probe, int np, const int *ref, int nref,
+                        int *members_out, int *members_size, int *missing_out, int *missing_size,
+                        BloomStats *stats);
+
+#endif
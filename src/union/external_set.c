@@ -0,0 +1,541 @@
+#include "external_set.h"
+#include "../utils/int_parser.h"
+#include "../utils/int_format.h"
+#include "../sorting/sort_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// 归并阶段每个有序段的最小读缓冲（元素个数）
+#define MIN_RUN_BUFFER 4096
+// 输出缓冲区大小（字节）
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+// 只读映射的输入文件
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+} MappedFile;
+
+// 输入文件上的读取游标
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    size_t pos;
+    ExternalFormat format;
+    IntParseStatus status;  // 文本解析失败时的原因
+} InputCursor;
+
+// 写在临时文件中的有序段及其读缓冲
+typedef struct {
+    FILE *file;
+    long long *buffer;
+    size_t length;
+    size_t pos;
+} Run;
+
+// 由多个有序段归并得到的有序去重流
+typedef struct {
+    Run *runs;
+    int run_count;
+    int *heap;              // 按当前元素排列的有序段下标小顶堆
+    int heap_size;
+    size_t per_run;         // 每个有序段的读缓冲元素个数
+    bool read_failed;       // 读临时文件出错，流提前结束
+    bool has_last;
+    long long last;
+} SortedStream;
+
+// 带缓冲的输出
+typedef struct {
+    FILE *file;
+    ExternalFormat format;
+    char *buffer;
+    size_t used;
+    long long count;
+} OutputWriter;
+
+// 记录错误信息
+static void set_error(char *error, size_t error_size, const char *format, ...) {
+    if (!error || error_size == 0) return;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+}
+
+/**
+ * 以只读方式映射整个文件
+ * 返回值：
+ *   成功返回0，失败返回-1；空文件映射为size为0的空区域
+ */
+static int map_file(const char *path, MappedFile *mapped) {
+    mapped->data = NULL;
+    mapped->size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return -1;
+
+    madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+    mapped->data = addr;
+    mapped->size = (size_t)st.st_size;
+    return 0;
+}
+
+static void unmap_file(MappedFile *mapped) {
+    if (mapped->data) {
+        munmap((void*)mapped->data, mapped->size);
+    }
+    mapped->data = NULL;
+    mapped->size = 0;
+}
+
+/**
+ * 从游标批量读取整数
+ * 参数：
+ *   cursor: 输入游标
+ *   buffer, capacity: 输出缓冲区及容量
+ *   length: 本次读到的元素个数
+ * 返回值：
+ *   缓冲区已满且输入可能还有剩余返回1，输入读完返回0，
+ *   格式错误或溢出返回-1（cursor->pos指向出错位置，cursor->status为原因）
+ */
+static int cursor_fill(InputCursor *cursor, long long *buffer, size_t capacity, size_t *length) {
+    if (cursor->format == EXTERNAL_FORMAT_TEXT) {
+        cursor->status = int_parse_batch64((const char*)cursor->data, cursor->size, &cursor->pos,
+                                           buffer, capacity, length);
+        if (cursor->status == INT_PARSE_FULL) return 1;
+        return cursor->status == INT_PARSE_OK ? 0 : -1;
+    }
+
+    // 二进制格式：文件长度已在build_runs中检查为元素宽度的整数倍
+    size_t width = cursor->format == EXTERNAL_FORMAT_INT32 ? sizeof(int) : sizeof(long long);
+    size_t available = (cursor->size - cursor->pos) / width;
+    size_t n = available < capacity ? available : capacity;
+    const unsigned char *p = cursor->data + cursor->pos;
+    if (cursor->format == EXTERNAL_FORMAT_INT32) {
+        for (size_t i = 0; i < n; i++) {
+            int v;
+            memcpy(&v, p + i * sizeof(int), sizeof(int));
+            buffer[i] = v;
+        }
+    } else {
+        memcpy(buffer, p, n * sizeof(long long));
+    }
+    cursor->pos += n * width;
+    *length = n;
+    return n == capacity ? 1 : 0;
+}
+
+static void free_runs(Run *runs, int count) {
+    for (int i = 0; i < count; i++) {
+        if (runs[i].file) fclose(runs[i].file);
+        free(runs[i].buffer);
+    }
+    free(runs);
+}
+
+/**
+ * 外部排序第一阶段：把输入切分为若干个内存可容纳的有序段
+ * 参数：
+ *   mapped: 已映射的输入
+ *   format: 输入格式
+ *   budget: 排序缓冲区字节数
+ *   runs, run_count: 输出的有序段列表（写入临时文件）
+ *   count: 输入元素总数
+ * 返回值：
+ *   成功返回0，失败返回-1
+ * 算法原理：
+ * 依次把输入读入缓冲区，排序去重后写入临时文件，临时文件关闭时自动删除
+ */
+static int build_runs(const MappedFile *mapped, ExternalFormat format, size_t budget,
+                      Run **runs, int *run_count, long long *count,
+                      const char *name, char *error, size_t error_size) {
+    size_t capacity = budget / sizeof(long long);
+    if (capacity < MIN_RUN_BUFFER) capacity = MIN_RUN_BUFFER;
+
+    // 二进制输入的长度须为元素宽度的整数倍，多出的尾部字节说明格式选错或文件被截断
+    if (format != EXTERNAL_FORMAT_TEXT) {
+        size_t width = format == EXTERNAL_FORMAT_INT32 ? sizeof(int) : sizeof(long long);
+        if (mapped->size % width != 0) {
+            set_error(error, error_size, "文件%s的长度%zu字节不是%zu的整数倍，末尾有%zu字节不足一个元素",
+                      name, mapped->size, width, mapped->size % width);
+            return -1;
+        }
+    }
+
+    long long *buffer = malloc(capacity * sizeof(long long));
+    if (!buffer) {
+        set_error(error, error_size, "内存分配失败");
+        return -1;
+    }
+
+    InputCursor cursor = { mapped->data, mapped->size, 0, format, INT_PARSE_OK };
+    *runs = NULL;
+    *run_count = 0;
+    *count = 0;
+    int run_capacity = 0;
+    int status = 0;
+
+    for (;;) {
+        size_t length = 0;
+        int r = cursor_fill(&cursor, buffer, capacity, &length);
+        if (r < 0) {
+            set_error(error, error_size, "文件%s在第%zu字节处%s", name, cursor.pos,
+                      int_parse_status_string(cursor.status));
+            status = -1;
+            break;
+        }
+        if (length == 0) break;
+        *count += (long long)length;
+
+        sort_i64(buffer, length);
+        size_t unique = 1;
+        for (size_t i = 1; i < length; i++) {
+            if (buffer[i] != buffer[unique - 1]) buffer[unique++] = buffer[i];
+        }
+
+        if (*run_count == run_capacity) {
+            run_capacity = run_capacity ? run_capacity * 2 : 8;
+            Run *grown = realloc(*runs, (size_t)run_capacity * sizeof(Run));
+            if (!grown) {
+                set_error(error, error_size, "内存分配失败");
+                status = -1;
+                break;
+            }
+            *runs = grown;
+        }
+
+        Run *run = &(*runs)[(*run_count)++];
+        memset(run, 0, sizeof(Run));
+        run->file = tmpfile();
+        if (!run->file || fwrite(buffer, sizeof(long long), unique, run->file) != unique ||
+            fflush(run->file) != 0) {
+            set_error(error, error_size, "写入临时文件失败：%s", strerror(errno));
+            status = -1;
+            break;
+        }
+        rewind(run->file);
+
+        if (r == 0) break;
+    }
+
+    free(buffer);
+    if (status != 0) {
+        free_runs(*runs, *run_count);
+        *runs = NULL;
+        *run_count = 0;
+    }
+    return status;
+}
+
+// 重新填充有序段的读缓冲，返回缓冲中的元素个数；读出错时记入流并返回0
+static size_t run_refill(SortedStream *stream, Run *run) {
+    run->length = fread(run->buffer, sizeof(long long), stream->per_run, run->file);
+    run->pos = 0;
+    if (run->length < stream->per_run && ferror(run->file)) {
+        stream->read_failed = true;
+        run->length = 0;
+    }
+    return run->length;
+}
+
+static inline long long run_head(const Run *run) {
+    return run->buffer[run->pos];
+}
+
+// 小顶堆下沉
+static void heap_sift_down(SortedStream *stream, int index) {
+    int *heap = stream->heap;
+    for (;;) {
+        int smallest = index;
+        int left = 2 * index + 1, right = left + 1;
+        if (left < stream->heap_size &&
+            run_head(&stream->runs[heap[left]]) < run_head(&stream->runs[heap[smallest]])) {
+            smallest = left;
+        }
+        if (right < stream->heap_size &&
+            run_head(&stream->runs[heap[right]]) < run_head(&stream->runs[heap[smallest]])) {
+            smallest = right;
+        }
+        if (smallest == index) return;
+        int tmp = heap[index];
+        heap[index] = heap[smallest];
+        heap[smallest] = tmp;
+        index = smallest;
+    }
+}
+
+/**
+ * 初始化多路归并流
+ * 算法原理：
+ * 每个有序段分配一块读缓冲，缓冲总量不超过内存预算；
+ * 各段当前元素组成小顶堆，每次取堆顶即为全局最小值
+ */
+static int stream_init(SortedStream *stream, Run *runs, int run_count, size_t budget) {
+    memset(stream, 0, sizeof(SortedStream));
+    stream->runs = runs;
+    stream->run_count = run_count;
+    if (run_count == 0) return 0;
+
+    stream->per_run = budget / sizeof(long long) / (size_t)run_count;
+    if (stream->per_run < MIN_RUN_BUFFER) stream->per_run = MIN_RUN_BUFFER;
+
+    stream->heap = malloc((size_t)run_count * sizeof(int));
+    if (!stream->heap) return -1;
+
+    for (int i = 0; i < run_count; i++) {
+        runs[i].buffer = malloc(stream->per_run * sizeof(long long));
+        if (!runs[i].buffer) return -1;
+        if (run_refill(stream, &runs[i]) > 0) {
+            stream->heap[stream->heap_size++] = i;
+        }
+    }
+    for (int i = stream->heap_size / 2 - 1; i >= 0; i--) {
+        heap_sift_down(stream, i);
+    }
+    return 0;
+}
+
+/**
+ * 取出下一个不重复的最小元素
+ * 返回值：
+ *   读到返回1，所有有序段耗尽返回0
+ */
+static int stream_next(SortedStream *stream, long long *value) {
+    while (stream->heap_size > 0) {
+        Run *run = &stream->runs[stream->heap[0]];
+        long long v = run_head(run);
+
+        run->pos++;
+        if (run->pos == run->length && run_refill(stream, run) == 0) {
+            stream->heap[0] = stream->heap[--stream->heap_size];
+        }
+        heap_sift_down(stream, 0);
+
+        if (!stream->has_last || v != stream->last) {
+            stream->has_last = true;
+            stream->last = v;
+            *value = v;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void stream_free(SortedStream *stream) {
+    free(stream->heap);
+    stream->heap = NULL;
+}
+
+// 输出一个元素
+static int writer_put(OutputWriter *writer, long long value) {
+    if (writer->used + 32 > OUTPUT_BUFFER_SIZE) {
+        if (fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) return -1;
+        writer->used = 0;
+    }
+
+    char *dst = writer->buffer + writer->used;
+    if (writer->format == EXTERNAL_FORMAT_TEXT) {
+        char *end = int_format_int64(dst, value);
+        *end++ = '\n';
+        writer->used = (size_t)(end - writer->buffer);
+    } else if (writer->format == EXTERNAL_FORMAT_INT32) {
+        if (value < INT_MIN || value > INT_MAX) return -2;
+        int v = (int)value;
+        memcpy(dst, &v, sizeof(int));
+        writer->used += sizeof(int);
+    } else {
+        memcpy(dst, &value, sizeof(long long));
+        writer->used += sizeof(long long);
+    }
+    writer->count++;
+    return 0;
+}
+
+static int writer_flush(OutputWriter *writer) {
+    if (writer->used > 0 && fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        return -1;
+    }
+    writer->used = 0;
+    return fflush(writer->file) == 0 ? 0 : -1;
+}
+
+/**
+ * 对两个有序去重流执行集合运算并写出
+ * 算法原理：
+ * 与内存中的有序归并相同：比较两个流的当前元素，
+ * 按“只在A / 只在B / 两者都有”三种情况决定是否输出
+ */
+static int merge_streams(SortedStream *a, SortedStream *b, ExternalOp op, OutputWriter *writer) {
+    bool keep_a_only = op == EXTERNAL_OP_UNION || op == EXTERNAL_OP_A_MINUS_B || op == EXTERNAL_OP_SYM_DIFF;
+    bool keep_b_only = op == EXTERNAL_OP_UNION || op == EXTERNAL_OP_B_MINUS_A || op == EXTERNAL_OP_SYM_DIFF;
+    bool keep_both = op == EXTERNAL_OP_UNION || op == EXTERNAL_OP_INTERSECTION;
+
+    long long x = 0, y = 0;
+    int has_a = stream_next(a, &x);
+    int has_b = stream_next(b, &y);
+    int status = 0;
+
+    while ((has_a || has_b) && status == 0 && !a->read_failed && !b->read_failed) {
+        if (has_a && (!has_b || x < y)) {
+            if (keep_a_only) status = writer_put(writer, x);
+            has_a = stream_next(a, &x);
+        } else if (has_b && (!has_a || y < x)) {
+            if (keep_b_only) status = writer_put(writer, y);
+            has_b = stream_next(b, &y);
+        } else {
+            if (keep_both) status = writer_put(writer, x);
+            has_a = stream_next(a, &x);
+            has_b = stream_next(b, &y);
+        }
+    }
+    if (status == 0 && (a->read_failed || b->read_failed)) {
+        status = -3;
+    }
+    return status;
+}
+
+/**
+ * 对两个整数文件执行外部集合运算，结果直接写入输出文件
+ * 参数：
+ *   path_a, path_b: 输入文件路径（mmap只读映射）
+ *   out_path: 输出文件路径
+ *   op: 运算类型
+ *   options: 输入输出格式与内存预算
+ *   stats: 运行统计（可以为NULL）
+ *   error, error_size: 失败时的错误描述
+ * 返回值：
+ *   成功返回0，失败返回-1；失败时不留下输出文件，已存在的同名文件保持不变
+ * 算法原理：
+ * 1. 生成有序段：按内存预算分块读入、排序去重、写入临时文件
+ * 2. 多路归并：每个输入的所有有序段经小顶堆归并为一个有序去重流
+ * 3. 集合运算：两个有序流再做一次线性归并，结果边算边写出到同目录的临时文件，
+ *    全部写完后再改名为输出文件
+ * 内存占用只与预算有关，与输入规模无关
+ */
+int external_set_operation(const char *path_a, const char *path_b, const char *out_path,
+                           ExternalOp op, const ExternalOptions *options,
+                           ExternalStats *stats, char *error, size_t error_size) {
+    size_t budget = options->memory_budget ? options->memory_budget : EXTERNAL_DEFAULT_MEMORY_BUDGET;
+    MappedFile file_a = {0}, file_b = {0};
+    Run *runs_a = NULL, *runs_b = NULL;
+    int count_runs_a = 0, count_runs_b = 0;
+    long long count_a = 0, count_b = 0;
+    SortedStream stream_a = {0}, stream_b = {0};
+    OutputWriter writer = {0};
+    char *temp_path = NULL;
+    int status = -1;
+
+    if (map_file(path_a, &file_a) != 0) {
+        set_error(error, error_size, "无法打开文件 %s：%s", path_a, strerror(errno));
+        goto cleanup;
+    }
+    if (map_file(path_b, &file_b) != 0) {
+        set_error(error, error_size, "无法打开文件 %s：%s", path_b, strerror(errno));
+        goto cleanup;
+    }
+
+    // 两个输入依次排序，各自可使用全部预算
+    if (build_runs(&file_a, options->input_format, budget, &runs_a, &count_runs_a, &count_a,
+                   "A", error, error_size) != 0) {
+        goto cleanup;
+    }
+    unmap_file(&file_a);
+    if (build_runs(&file_b, options->input_format, budget, &runs_b, &count_runs_b, &count_b,
+                   "B", error, error_size) != 0) {
+        goto cleanup;
+    }
+    unmap_file(&file_b);
+
+    // 归并阶段两个输入平分预算
+    if (stream_init(&stream_a, runs_a, count_runs_a, budget / 2) != 0 ||
+        stream_init(&stream_b, runs_b, count_runs_b, budget / 2) != 0) {
+        set_error(error, error_size, "内存分配失败");
+        goto cleanup;
+    }
+
+    // 先写到同目录的临时文件，成功后改名，出错时不会留下写了一半的输出
+    size_t path_length = strlen(out_path);
+    temp_path = malloc(path_length + sizeof(".partial"));
+    writer.format = options->output_format;
+    writer.buffer = malloc(OUTPUT_BUFFER_SIZE);
+    if (!temp_path || !writer.buffer) {
+        set_error(error, error_size, "内存分配失败");
+        goto cleanup;
+    }
+    memcpy(temp_path, out_path, path_length);
+    memcpy(temp_path + path_length, ".partial", sizeof(".partial"));
+    writer.file = fopen(temp_path, "wb");
+    if (!writer.file) {
+        set_error(error, error_size, "无法创建输出文件 %s：%s", temp_path, strerror(errno));
+        goto cleanup;
+    }
+
+    int merged = merge_streams(&stream_a, &stream_b, op, &writer);
+    if (merged == -2) {
+        set_error(error, error_size, "结果超出int32范围，请改用int64或文本输出");
+        goto cleanup;
+    }
+    if (merged == -3) {
+        set_error(error, error_size, "读取临时文件失败：%s", strerror(errno));
+        goto cleanup;
+    }
+    if (merged != 0 || writer_flush(&writer) != 0) {
+        set_error(error, error_size, "写入输出文件失败：%s", strerror(errno));
+        goto cleanup;
+    }
+
+    if (stats) {
+        stats->count_a = count_a;
+        stats->count_b = count_b;
+        stats->count_out = writer.count;
+        stats->runs_a = count_runs_a;
+        stats->runs_b = count_runs_b;
+    }
+    status = 0;
+
+cleanup:
+    unmap_file(&file_a);
+    unmap_file(&file_b);
+    stream_free(&stream_a);
+    stream_free(&stream_b);
+    free_runs(runs_a, count_runs_a);
+    free_runs(runs_b, count_runs_b);
+    if (writer.file && fclose(writer.file) != 0 && status == 0) {
+        set_error(error, error_size, "写入输出文件失败：%s", strerror(errno));
+        status = -1;
+    }
+    if (writer.file && status == 0 && rename(temp_path, out_path) != 0) {
+        set_error(error, error_size, "无法写入输出文件 %s：%s", out_path, strerror(errno));
+        status = -1;
+    }
+    if (writer.file && status != 0) {
+        remove(temp_path);
+    }
+    free(temp_path);
+    free(writer.buffer);
+    return status;
+}
@@ -0,0 +1,45 @@
+#ifndef EXTERNAL_SET_H
+#define EXTERNAL_SET_H
+
+#include <stddef.h>
+
+// 外部文件中整数的存储格式
+typedef enum {
+    EXTERNAL_FORMAT_TEXT,   // 以空白或逗号分隔的十进制整数
+    EXTERNAL_FORMAT_INT32,  // 本机字节序的int32数组
+    EXTERNAL_FORMAT_INT64   // 本机字节序的int64数组
+} ExternalFormat;
+
+// 外部集合运算类型
+typedef enum {
+    EXTERNAL_OP_UNION,
+    EXTERNAL_OP_INTERSECTION,
+    EXTERNAL_OP_A_MINUS_B,
+    EXTERNAL_OP_B_MINUS_A,
+    EXTERNAL_OP_SYM_DIFF
+} ExternalOp;
+
+// 运行参数
+typedef struct {
+    ExternalFormat input_format;
+    ExternalFormat output_format;
+    size_t memory_budget;   // 排序缓冲区可使用的最大字节数
+} ExternalOptions;
+
+// 运行统计
+typedef struct {
+    long long count_a;      // 输入A的元素个数（含重复）
+    long long count_b;      // 输入B的元素个数（含重复）
+    long long count_out;    // 输出元素个数
+    int runs_a;             // A生成的有序段个数
+    int runs_b;             // B生成的有序段个数
+} ExternalStats;
+
+#define EXTERNAL_DEFAULT_MEMORY_BUDGET ((size_t)256 * 1024 * 1024)
+
+// 函数声明
+int external_set_operation(const char *path_a, const char *path_b, const char *out_path,
+                           ExternalOp op, const ExternalOptions *options,
+                           ExternalStats *stats, char *error, size_t error_size);
+
+#endif
@@ -0,0 +1,150 @@
+#include "int_count_map.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+// 负载因子上限为 1/2，保证线性探测的期望探测长度为常数
+#define MIN_CAPACITY 16
+
+// Fibonacci乘法哈希，高位异或到低位后按掩码取槽位
+static inline size_t hash_slot(int key, size_t mask) {
+    uint32_t h = (uint32_t)key * 2654435769u;
+    h ^= h >> 16;
+    return (size_t)h & mask;
+}
+
+/**
+ * 初始化计数表
+ * 参数：
+ *   map: 要初始化的计数表
+ *   expected: 预计的不同键个数
+ * 返回值：
+ *   成功返回true，内存分配失败返回false
+ */
+bool int_count_map_init(IntCountMap *map, size_t expected) {
+    size_t capacity = MIN_CAPACITY;
+    while (capacity < expected * 2) {
+        capacity <<= 1;
+    }
+
+    map->keys = malloc(capacity * sizeof(int));
+    map->counts = malloc(capacity * sizeof(int));
+    map->used = calloc(capacity, sizeof(unsigned char));
+    map->capacity = capacity;
+    map->size = 0;
+
+    if (!map->keys || !map->counts || !map->used) {
+        int_count_map_free(map);
+        return false;
+    }
+    return true;
+}
+
+// 释放计数表占用的内存
+void int_count_map_free(IntCountMap *map) {
+    free(map->keys);
+    free(map->counts);
+    free(map->used);
+    map->keys = NULL;
+    map->counts = NULL;
+    map->used = NULL;
+    map->capacity = 0;
+    map->size = 0;
+}
+
+// 查找键所在的槽位，不存在时返回其探测链末尾的空槽
+static size_t find_slot(const IntCountMap *map, int key) {
+    size_t mask = map->capacity - 1;
+    size_t i = hash_slot(key, mask);
+    while (map->used[i] && map->keys[i] != key) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// 容量翻倍并重新插入所有键
+static bool grow(IntCountMap *map) {
+    IntCountMap bigger;
+    if (!int_count_map_init(&bigger, map->capacity)) {
+        return false;
+    }
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->used[i]) {
+            size_t slot = find_slot(&bigger, map->keys[i]);
+            bigger.used[slot] = 1;
+            bigger.keys[slot] = map->keys[i];
+            bigger.counts[slot] = map->counts[i];
+        }
+    }
+    bigger.size = map->size;
+    int_count_map_free(map);
+    *map = bigger;
+    return true;
+}
+
+/**
+ * 删除槽位i上的键
+ * 算法原理：
+ * 线性探测不能简单地清空槽位，否则会截断其后键的探测链。
+ * 这里向后扫描同一簇，把“起始槽位不在(i, j]之间”的键前移到空位，
+ * 直到遇到空槽（backward shift deletion），无需墓碑标记
+ */
+static void remove_slot(IntCountMap *map, size_t i) {
+    size_t mask = map->capacity - 1;
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!map->used[j]) break;
+        size_t home = hash_slot(map->keys[j], mask);
+        // home 位于循环区间 (i, j] 内时该键不能前移
+        bool in_range = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+        if (!in_range) {
+            map->keys[i] = map->keys[j];
+            map->counts[i] = map->counts[j];
+            i = j;
+        }
+    }
+    map->used[i] = 0;
+    map->size--;
+}
+
+/**
+ * 调整键的出现次数
+ * 参数：
+ *   map: 计数表
+ *   key: 键
+ *   delta: 增量，可以为负；次数降到0及以下时删除该键
+ *   old_count: 输出调整前的次数，可为NULL
+ * 返回值：
+ *   成功返回true，扩容失败返回false（此时计数表不变）
+ * 时间复杂度：期望O(1)
+ */
+bool int_count_map_add(IntCountMap *map, int key, int delta, int *old_count) {
+    size_t i = find_slot(map, key);
+    int old = map->used[i] ? map->counts[i] : 0;
+    if (old_count) *old_count = old;
+
+    if (old + delta <= 0) {
+        if (old > 0) remove_slot(map, i);
+        return true;
+    }
+    if (old > 0) {
+        map->counts[i] += delta;
+        return true;
+    }
+
+    if ((map->size + 1) * 2 > map->capacity) {
+        if (!grow(map)) return false;
+        i = find_slot(map, key);
+    }
+    map->used[i] = 1;
+    map->keys[i] = key;
+    map->counts[i] = delta;
+    map->size++;
+    return true;
+}
+
+// 键的出现次数，不存在时为0
+int int_count_map_get(const IntCountMap *map, int key) {
+    size_t i = find_slot(map, key);
+    return map->used[i] ? map->counts[i] : 0;
+}
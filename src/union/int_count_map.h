@@ -0,0 +1,23 @@
+#ifndef INT_COUNT_MAP_H
+#define INT_COUNT_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// 开放寻址整数计数表（键 -> 出现次数）
+// 线性探测的开放寻址布局，计数降为0的键立即删除（后移删除，不留墓碑）
+typedef struct {
+    int *keys;              // 槽位中的键
+    int *counts;            // 键的出现次数，始终大于0
+    unsigned char *used;    // 槽位占用标记
+    size_t capacity;        // 槽位数量（2的幂）
+    size_t size;            // 不同键的个数
+} IntCountMap;
+
+// 函数声明
+bool int_count_map_init(IntCountMap *map, size_t expected);
+void int_count_map_free(IntCountMap *map);
+bool int_count_map_add(IntCountMap *map, int key, int delta, int *old_count);
+int int_count_map_get(const IntCountMap *map, int key);
+
+#endif
@@ -0,0 +1,154 @@
+#include "int_ordered_set.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 单块容量；块满时对半分裂，相邻两块合计不超过半块时合并
+#define BLOCK_MAX 1024
+
+void int_ordered_set_init(IntOrderedSet *set) {
+    memset(set, 0, sizeof(IntOrderedSet));
+}
+
+// 释放所有块
+void int_ordered_set_free(IntOrderedSet *set) {
+    for (size_t i = 0; i < set->block_count; i++) {
+        free(set->blocks[i].values);
+    }
+    free(set->blocks);
+    int_ordered_set_init(set);
+}
+
+// 第一个末元素不小于value的块；所有块都更小时返回最后一块
+static size_t find_block(const IntOrderedSet *set, int value) {
+    size_t lo = 0, hi = set->block_count - 1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const IntOrderedBlock *block = &set->blocks[mid];
+        if (block->values[block->size - 1] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// 块内第一个不小于value的位置
+static int lower_bound(const IntOrderedBlock *block, int value) {
+    int lo = 0, hi = block->size;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (block->values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// 在块数组的index处腾出一个空块
+static bool insert_block(IntOrderedSet *set, size_t index) {
+    if (set->block_count == set->block_capacity) {
+        size_t capacity = set->block_capacity ? set->block_capacity * 2 : 16;
+        IntOrderedBlock *blocks = realloc(set->blocks, capacity * sizeof(IntOrderedBlock));
+        if (!blocks) return false;
+        set->blocks = blocks;
+        set->block_capacity = capacity;
+    }
+    int *values = malloc(BLOCK_MAX * sizeof(int));
+    if (!values) return false;
+    memmove(&set->blocks[index + 1], &set->blocks[index],
+            (set->block_count - index) * sizeof(IntOrderedBlock));
+    set->blocks[index].values = values;
+    set->blocks[index].size = 0;
+    set->block_count++;
+    return true;
+}
+
+// 从块数组中移除index处的块
+static void remove_block(IntOrderedSet *set, size_t index) {
+    free(set->blocks[index].values);
+    memmove(&set->blocks[index], &set->blocks[index + 1],
+            (set->block_count - index - 1) * sizeof(IntOrderedBlock));
+    set->block_count--;
+}
+
+/**
+ * 插入一个元素，已存在时不变
+ * 返回值：
+ *   成功返回true，内存分配失败返回false（集合保持不变）
+ * 算法原理：
+ * 二分查找所在块与块内位置，块内移动至多BLOCK_MAX个元素；
+ * 块满时先把后半部分移入新块，时间复杂度O(log n + BLOCK_MAX)
+ */
+bool int_ordered_set_insert(IntOrderedSet *set, int value) {
+    if (set->block_count == 0 && !insert_block(set, 0)) {
+        return false;
+    }
+    size_t b = find_block(set, value);
+    IntOrderedBlock *block = &set->blocks[b];
+    int pos = lower_bound(block, value);
+    if (pos < block->size && block->values[pos] == value) {
+        return true;
+    }
+
+    if (block->size == BLOCK_MAX) {
+        if (!insert_block(set, b + 1)) {
+            return false;
+        }
+        block = &set->blocks[b];
+        IntOrderedBlock *upper = &set->blocks[b + 1];
+        int half = BLOCK_MAX / 2;
+        memcpy(upper->values, block->values + half, (size_t)(BLOCK_MAX - half) * sizeof(int));
+        upper->size = BLOCK_MAX - half;
+        block->size = half;
+        if (pos > half) {
+            block = upper;
+            pos -= half;
+        }
+    }
+
+    memmove(block->values + pos + 1, block->values + pos, (size_t)(block->size - pos) * sizeof(int));
+    block->values[pos] = value;
+    block->size++;
+    set->size++;
+    return true;
+}
+
+// 删除一个元素，不存在时不变；变空的块被释放，过小的相邻块合并
+void int_ordered_set_remove(IntOrderedSet *set, int value) {
+    if (set->block_count == 0) return;
+    size_t b = find_block(set, value);
+    IntOrderedBlock *block = &set->blocks[b];
+    int pos = lower_bound(block, value);
+    if (pos == block->size || block->values[pos] != value) {
+        return;
+    }
+
+    memmove(block->values + pos, block->values + pos + 1, (size_t)(block->size - pos - 1) * sizeof(int));
+    block->size--;
+    set->size--;
+
+    if (block->size == 0) {
+        remove_block(set, b);
+        return;
+    }
+    // 与后一块合并，避免反复删除后留下大量近空的块
+    if (b + 1 < set->block_count && block->size + set->blocks[b + 1].size <= BLOCK_MAX / 2) {
+        IntOrderedBlock *next = &set->blocks[b + 1];
+        memcpy(block->values + block->size, next->values, (size_t)next->size * sizeof(int));
+        block->size += next->size;
+        remove_block(set, b + 1);
+    }
+}
+
+// 按升序把所有元素写入out，out容量不小于set->size，返回元素个数
+size_t int_ordered_set_copy(const IntOrderedSet *set, int *out) {
+    size_t n = 0;
+    for (size_t i = 0; i < set->block_count; i++) {
+        memcpy(out + n, set->blocks[i].values, (size_t)set->blocks[i].size * sizeof(int));
+        n += (size_t)set->blocks[i].size;
+    }
+    return n;
+}
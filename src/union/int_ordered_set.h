@@ -0,0 +1,30 @@
+#ifndef INT_ORDERED_SET_H
+#define INT_ORDERED_SET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// 有序整数集合的一个块：块内元素严格递增
+typedef struct {
+    int *values;
+    int size;
+} IntOrderedBlock;
+
+// 分块有序整数集合
+// 元素按值分布在若干有序块中，前一块的所有元素小于后一块；
+// 插入与删除只移动一个块内的元素，按序取出时逐块复制
+typedef struct {
+    IntOrderedBlock *blocks;
+    size_t block_count;
+    size_t block_capacity;
+    size_t size;            // 元素总数
+} IntOrderedSet;
+
+// 函数声明
+void int_ordered_set_init(IntOrderedSet *set);
+void int_ordered_set_free(IntOrderedSet *set);
+bool int_ordered_set_insert(IntOrderedSet *set, int value);
+void int_ordered_set_remove(IntOrderedSet *set, int value);
+size_t int_ordered_set_copy(const IntOrderedSet *set, int *out);
+
+#endif
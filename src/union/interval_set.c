@@ -0,0 +1,197 @@
+#include "interval_set.h"
+#include "../utils/int_format.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define INTERVAL_SET_MIN_CAPACITY 16
+
+// 初始化区间集合并预留capacity个区间的空间
+bool interval_set_init(IntervalSet *set, Arena *arena, size_t capacity) {
+    set->data = NULL;
+    set->size = 0;
+    set->capacity = 0;
+    set->arena = arena;
+    return interval_set_reserve(set, capacity < INTERVAL_SET_MIN_CAPACITY ? INTERVAL_SET_MIN_CAPACITY : capacity);
+}
+
+// 确保容量至少为capacity，不足时按2倍从区域中增长
+bool interval_set_reserve(IntervalSet *set, size_t capacity) {
+    if (capacity <= set->capacity) return true;
+
+    size_t new_capacity = set->capacity ? set->capacity : INTERVAL_SET_MIN_CAPACITY;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    Interval *data = arena_grow(set->arena, set->data,
+                                set->capacity * sizeof(Interval), new_capacity * sizeof(Interval));
+    if (!data) return false;
+
+    set->data = data;
+    set->capacity = new_capacity;
+    return true;
+}
+
+// 按下界排序的内核，直接对Interval原地排序
+#define SORT_NAME sort_intervals
+#define SORT_TYPE Interval
+#define SORT_LESS(a, b) ((a).lo < (b).lo)
+#include "../sorting/sort_template.h"
+
+/**
+ * 规范化：排序并合并重叠或相邻的区间
+ * 算法原理：
+ * 按下界排序后顺序扫描，下一个区间的下界不超过当前上界+1时并入当前区间
+ * （上界+1用long long计算，避免INT_MAX溢出）
+ * 时间复杂度：O(r log r)，r为区间个数，与区间内的元素个数无关
+ */
+void interval_set_normalize(IntervalSet *set) {
+    if (set->size < 2) return;
+
+    // 输入通常已经有序，先检查一遍避免无谓的排序
+    bool sorted = true;
+    for (size_t i = 1; i < set->size && sorted; i++) {
+        sorted = set->data[i - 1].lo <= set->data[i].lo;
+    }
+    if (!sorted) {
+        sort_intervals(set->data, set->size);
+    }
+
+    size_t k = 0;
+    for (size_t i = 1; i < set->size; i++) {
+        Interval *cur = &set->data[k];
+        const Interval *next = &set->data[i];
+        if ((long long)next->lo <= (long long)cur->hi + 1) {
+            if (next->hi > cur->hi) cur->hi = next->hi;
+        } else {
+            set->data[++k] = *next;
+        }
+    }
+    set->size = k + 1;
+}
+
+// 把升序且无重复的整数数组压缩为连续段组成的区间集合
+bool interval_set_from_sorted(IntervalSet *set, const int *values, size_t count) {
+    set->size = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (set->size > 0 && (long long)set->data[set->size - 1].hi + 1 == values[i]) {
+            set->data[set->size - 1].hi = values[i];
+            continue;
+        }
+        if (set->size == set->capacity && !interval_set_reserve(set, set->size + 1)) {
+            return false;
+        }
+        set->data[set->size++] = (Interval){ values[i], values[i] };
+    }
+    return true;
+}
+
+// 运算结果是否包含同时满足in_a、in_b状态的位置
+static inline bool op_contains(IntervalOp op, bool in_a, bool in_b) {
+    switch (op) {
+        case INTERVAL_UNION:        return in_a || in_b;
+        case INTERVAL_INTERSECTION: return in_a && in_b;
+        case INTERVAL_A_MINUS_B:    return in_a && !in_b;
+        case INTERVAL_B_MINUS_A:    return in_b && !in_a;
+        case INTERVAL_SYM_DIFF:     return in_a != in_b;
+        default:                    return false;
+    }
+}
+
+// 集合在当前状态下的下一个边界：在区间外时为下一区间的起点，在区间内时为终点+1
+static inline long long next_boundary(const IntervalSet *set, size_t index, bool inside) {
+    if (index >= set->size) return LLONG_MAX;
+    return inside ? (long long)set->data[index].hi + 1 : set->data[index].lo;
+}
+
+/**
+ * 区间集合运算
+ * 参数：
+ *   a, b: 规范化的区间集合
+ *   op: 运算类型
+ *   out: 输出集合（与a、b不能是同一个），结果同样是规范化的
+ * 返回值：
+ *   成功返回true，内存分配失败返回false
+ * 算法原理：
+ * 把每个区间看作半开区间[lo, hi+1)，按坐标顺序扫描两侧的全部端点，
+ * 在每个端点处更新“是否在a中”“是否在b中”两个状态；
+ * 运算结果在状态由假变真处开始一个区间，由真变假处结束该区间。
+ * 结果的端点都是输入的端点，区间个数不超过两侧区间数之和
+ * 时间复杂度：O(ra + rb)，与区间内的元素个数无关
+ */
+bool interval_set_op(const IntervalSet *a, const IntervalSet *b, IntervalOp op, IntervalSet *out) {
+    out->size = 0;
+    if (!interval_set_reserve(out, a->size + b->size)) {
+        return false;
+    }
+
+    size_t ia = 0, ib = 0;
+    bool in_a = false, in_b = false, open = false;
+    long long start = 0;
+
+    for (;;) {
+        long long pa = next_boundary(a, ia, in_a);
+        long long pb = next_boundary(b, ib, in_b);
+        long long x = pa < pb ? pa : pb;
+        if (x == LLONG_MAX) break;
+
+        if (pa == x) {
+            in_a = !in_a;
+            if (!in_a) ia++;
+        }
+        if (pb == x) {
+            in_b = !in_b;
+            if (!in_b) ib++;
+        }
+
+        bool inside = op_contains(op, in_a, in_b);
+        if (inside && !open) {
+            start = x;
+            open = true;
+        } else if (!inside && open) {
+            out->data[out->size++] = (Interval){ (int)start, (int)(x - 1) };
+            open = false;
+        }
+    }
+    return true;
+}
+
+// 集合的元素个数
+long long interval_set_count(const IntervalSet *set) {
+    long long total = 0;
+    for (size_t i = 0; i < set->size; i++) {
+        total += (long long)set->data[i].hi - set->data[i].lo + 1;
+    }
+    return total;
+}
+
+// 格式化count个区间所需的最大字节数（含'\0'）：每个区间最多两个整数、一个'-'和分隔符", "
+size_t interval_set_format_bound(size_t count) {
+    return count * (2 * INT_FORMAT_MAX_CHARS + 3) + 1;
+}
+
+/**
+ * 把区间集合格式化为“1-100, 105, 200-300”
+ * 参数：
+ *   set: 区间集合
+ *   dst: 输出缓冲区，容量至少为interval_set_format_bound(set->size)
+ * 返回值：
+ *   写入的字节数（不含'\0'）
+ */
+size_t interval_set_format(const IntervalSet *set, char *dst) {
+    char *p = dst;
+    for (size_t i = 0; i < set->size; i++) {
+        if (i > 0) {
+            *p++ = ',';
+            *p++ = ' ';
+        }
+        p = int_format_int(p, set->data[i].lo);
+        if (set->data[i].hi != set->data[i].lo) {
+            *p++ = '-';
+            p = int_format_int(p, set->data[i].hi);
+        }
+    }
+    *p = '\0';
+    return (size_t)(p - dst);
+}
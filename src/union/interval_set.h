@@ -0,0 +1,41 @@
+#ifndef INTERVAL_SET_H
+#define INTERVAL_SET_H
+
+#include "../utils/arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// 闭区间[lo, hi]
+typedef struct {
+    int lo;
+    int hi;
+} Interval;
+
+// 区间列表表示的集合，规范化后按lo升序、互不相交且互不相邻
+typedef struct {
+    Interval *data;
+    size_t size;
+    size_t capacity;
+    Arena *arena;
+} IntervalSet;
+
+// 区间集合运算类型
+typedef enum {
+    INTERVAL_UNION,
+    INTERVAL_INTERSECTION,
+    INTERVAL_A_MINUS_B,
+    INTERVAL_B_MINUS_A,
+    INTERVAL_SYM_DIFF
+} IntervalOp;
+
+// 函数声明
+bool interval_set_init(IntervalSet *set, Arena *arena, size_t capacity);
+bool interval_set_reserve(IntervalSet *set, size_t capacity);
+void interval_set_normalize(IntervalSet *set);
+bool interval_set_from_sorted(IntervalSet *set, const int *values, size_t count);
+bool interval_set_op(const IntervalSet *a, const IntervalSet *b, IntervalOp op, IntervalSet *out);
+long long interval_set_count(const IntervalSet *set);
+size_t interval_set_format_bound(size_t count);
+size_t interval_set_format(const IntervalSet *set, char *dst);
+
+#endif
@@ -0,0 +1,168 @@
+#include "live_sets.h"
+#include "../utils/int_parser.h"
+#include <string.h>
+
+bool live_sets_init(LiveSets *live) {
+    memset(live, 0, sizeof(LiveSets));
+    for (int r = 0; r < LIVE_RESULT_COUNT; r++) {
+        int_ordered_set_init(&live->results[r]);
+    }
+    if (!int_count_map_init(&live->counts[0], 0) || !int_count_map_init(&live->counts[1], 0)) {
+        live_sets_free(live);
+        return false;
+    }
+    return true;
+}
+
+void live_sets_free(LiveSets *live) {
+    int_count_map_free(&live->counts[0]);
+    int_count_map_free(&live->counts[1]);
+    for (int r = 0; r < LIVE_RESULT_COUNT; r++) {
+        int_ordered_set_free(&live->results[r]);
+    }
+}
+
+// 开始一次新的编辑，清空上一次编辑的增量统计
+void live_sets_begin_edit(LiveSets *live) {
+    memset(live->added, 0, sizeof(live->added));
+    memset(live->removed, 0, sizeof(live->removed));
+}
+
+// 值按其在A、B中的归属是否属于某项结果
+static bool in_result(LiveResult result, bool in_a, bool in_b) {
+    switch (result) {
+        case LIVE_UNION:        return in_a || in_b;
+        case LIVE_INTERSECTION: return in_a && in_b;
+        case LIVE_A_MINUS_B:    return in_a && !in_b;
+        case LIVE_B_MINUS_A:    return !in_a && in_b;
+        case LIVE_SYM_DIFF:     return in_a != in_b;
+        default:                return false;
+    }
+}
+
+/**
+ * 调整一个值在某个输入中的出现次数，并更新各项结果
+ * 算法原理：
+ * 只有次数在0与正数之间切换时值的归属才会变化；
+ * 比较变化前后该值是否属于每项结果，把它插入或移出对应结果的有序集合，
+ * 每项结果O(log n + 块大小)，与集合大小基本无关
+ */
+static bool apply_value(LiveSets *live, int input, int value, int sign) {
+    int old_count;
+    if (!int_count_map_add(&live->counts[input], value, sign, &old_count)) {
+        return false;
+    }
+    bool was_member = old_count > 0;
+    bool is_member = old_count + sign > 0;
+    if (was_member == is_member) return true;
+
+    bool other = int_count_map_get(&live->counts[1 - input], value) > 0;
+    bool old_a = input == 0 ? was_member : other;
+    bool old_b = input == 0 ? other : was_member;
+    bool new_a = input == 0 ? is_member : other;
+    bool new_b = input == 0 ? other : is_member;
+
+    for (int r = 0; r < LIVE_RESULT_COUNT; r++) {
+        bool before = in_result((LiveResult)r, old_a, old_b);
+        bool after = in_result((LiveResult)r, new_a, new_b);
+        if (before && !after) {
+            int_ordered_set_remove(&live->results[r], value);
+            live->removed[r]++;
+        } else if (!before && after) {
+            if (!int_ordered_set_insert(&live->results[r], value)) {
+                return false;
+            }
+            live->added[r]++;
+        }
+    }
+    return true;
+}
+
+static inline bool is_delimiter(char c) {
+    return c == ' ' || c == ',' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * 把一段文本中的整数加入（sign=1）或移出（sign=-1）某个输入
+ * 参数：
+ *   live: 常驻集合
+ *   input: 0为集合1，1为集合2
+ *   text, length: 由完整记号组成的文本片段
+ *   sign: 1或-1
+ * 返回值：
+ *   成功返回true，内存不足返回false
+ * 说明：
+ * 编辑过程中经常出现“-”“12a”之类暂时无效的记号，这些记号被计数后忽略，
+ * 加入与移出时按同样规则处理，因此计数始终保持一致
+ */
+bool live_sets_apply_text(LiveSets *live, int input, const char *text, size_t length, int sign) {
+    size_t i = 0;
+    while (i < length) {
+        while (i < length && is_delimiter(text[i])) i++;
+        size_t start = i;
+        while (i < length && !is_delimiter(text[i])) i++;
+        if (i == start) break;
+
+        size_t pos = 0, count = 0;
+        int value;
+        if (int_parse_batch(text + start, i - start, &pos, &value, 1, &count) != INT_PARSE_OK || count != 1) {
+            live->invalid_tokens[input] += sign;
+            continue;
+        }
+        if (!apply_value(live, input, value, sign)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按升序写出某项结果，out容量不小于results[result].size
+size_t live_sets_copy_result(const LiveSets *live, LiveResult result, int *out) {
+    return int_ordered_set_copy(&live->results[result], out);
+}
+
+// 有序集合上的顺序游标
+typedef struct {
+    const IntOrderedSet *set;
+    size_t block;
+    int pos;
+} OrderedCursor;
+
+static inline bool cursor_valid(const OrderedCursor *c) {
+    return c->block < c->set->block_count;
+}
+
+static inline int cursor_value(const OrderedCursor *c) {
+    return c->set->blocks[c->block].values[c->pos];
+}
+
+static inline void cursor_next(OrderedCursor *c) {
+    if (++c->pos == c->set->blocks[c->block].size) {
+        c->block++;
+        c->pos = 0;
+    }
+}
+
+/**
+ * 按升序写出某个输入的所有不同值，out容量不小于counts[input].size
+ * 算法原理：
+ * 输入A恰为交集与A-B的不相交并，B同理；两项结果都已有序，
+ * 逐块线性归并即可，无需遍历计数表再排序
+ */
+size_t live_sets_copy_input(const LiveSets *live, int input, int *out) {
+    OrderedCursor a = { &live->results[LIVE_INTERSECTION], 0, 0 };
+    OrderedCursor b = { &live->results[input == 0 ? LIVE_A_MINUS_B : LIVE_B_MINUS_A], 0, 0 };
+    size_t n = 0;
+    while (cursor_valid(&a) && cursor_valid(&b)) {
+        if (cursor_value(&a) < cursor_value(&b)) {
+            out[n++] = cursor_value(&a);
+            cursor_next(&a);
+        } else {
+            out[n++] = cursor_value(&b);
+            cursor_next(&b);
+        }
+    }
+    for (; cursor_valid(&a); cursor_next(&a)) out[n++] = cursor_value(&a);
+    for (; cursor_valid(&b); cursor_next(&b)) out[n++] = cursor_value(&b);
+    return n;
+}
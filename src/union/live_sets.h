@@ -0,0 +1,36 @@
+#ifndef LIVE_SETS_H
+#define LIVE_SETS_H
+
+#include "int_count_map.h"
+#include "int_ordered_set.h"
+
+// 实时维护的各项运算结果
+typedef enum {
+    LIVE_UNION,
+    LIVE_INTERSECTION,
+    LIVE_A_MINUS_B,
+    LIVE_B_MINUS_A,
+    LIVE_SYM_DIFF,
+    LIVE_RESULT_COUNT
+} LiveResult;
+
+// 常驻的已解析集合，以及由其派生的各项结果
+// 输入文本允许重复出现同一个数，因此每个输入用计数表记录出现次数，
+// 值属于集合当且仅当次数大于0；各项结果的有序成员按值的归属变化增量维护
+typedef struct {
+    IntCountMap counts[2];                      // 两个输入中各值的出现次数
+    int invalid_tokens[2];                      // 无法解析而被忽略的记号个数
+    IntOrderedSet results[LIVE_RESULT_COUNT];   // 各项结果的成员，按值有序
+    int added[LIVE_RESULT_COUNT];               // 最近一次编辑加入各结果的元素个数
+    int removed[LIVE_RESULT_COUNT];             // 最近一次编辑移出各结果的元素个数
+} LiveSets;
+
+// 函数声明
+bool live_sets_init(LiveSets *live);
+void live_sets_free(LiveSets *live);
+void live_sets_begin_edit(LiveSets *live);
+bool live_sets_apply_text(LiveSets *live, int input, const char *text, size_t length, int sign);
+size_t live_sets_copy_result(const LiveSets *live, LiveResult result, int *out);
+size_t live_sets_copy_input(const LiveSets *live, int input, int *out);
+
+#endif
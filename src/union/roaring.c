@@ -0,0 +1,507 @@
+#include "roaring.h"
+#include <string.h>
+
+#define CHUNK_BITS 65536
+#define BITMAP_WORDS 1024
+#define BITMAP_BYTES (BITMAP_WORDS * sizeof(uint64_t))
+#define ARRAY_MAX_CARDINALITY 4096
+#define CONTAINER_OVERHEAD ((size_t)sizeof(RoaringContainer))
+
+// 有符号整数映射到无符号空间，保持大小顺序
+static inline uint32_t to_unsigned(int value) {
+    return (uint32_t)value ^ 0x80000000u;
+}
+
+static inline int to_signed(uint32_t value) {
+    return (int)(value ^ 0x80000000u);
+}
+
+// 初始化空位图
+void roaring_init(RoaringBitmap *bitmap, Arena *arena) {
+    bitmap->containers = NULL;
+    bitmap->size = 0;
+    bitmap->capacity = 0;
+    bitmap->arena = arena;
+}
+
+// 在末尾追加一个容器槽位，返回其地址
+static RoaringContainer* append_container(RoaringBitmap *bitmap) {
+    if (bitmap->size == bitmap->capacity) {
+        int capacity = bitmap->capacity ? bitmap->capacity * 2 : 16;
+        RoaringContainer *grown = arena_grow(bitmap->arena, bitmap->containers,
+                                             (size_t)bitmap->capacity * sizeof(RoaringContainer),
+                                             (size_t)capacity * sizeof(RoaringContainer));
+        if (!grown) return NULL;
+        bitmap->containers = grown;
+        bitmap->capacity = capacity;
+    }
+    return &bitmap->containers[bitmap->size++];
+}
+
+/**
+ * 按编码代价选择容器类型
+ * 算法原理：
+ * 数组每个元素2字节，位图固定8KB，游程每段4字节，取最小者；
+ * 数组容器最多容纳4096个元素
+ */
+static ContainerType choose_type(int cardinality, int runs) {
+    size_t array_cost = (size_t)cardinality * 2;
+    size_t run_cost = (size_t)runs * 4;
+    if (run_cost < BITMAP_BYTES && (cardinality > ARRAY_MAX_CARDINALITY || run_cost < array_cost)) {
+        return CONTAINER_RUN;
+    }
+    return cardinality <= ARRAY_MAX_CARDINALITY ? CONTAINER_ARRAY : CONTAINER_BITMAP;
+}
+
+// 把区间 [lo, hi] 的位全部置1
+static void bitmap_set_range(uint64_t *words, uint32_t lo, uint32_t hi) {
+    uint32_t first = lo >> 6, last = hi >> 6;
+    uint64_t first_mask = ~0ULL << (lo & 63);
+    uint64_t last_mask = ~0ULL >> (63 - (hi & 63));
+    if (first == last) {
+        words[first] |= first_mask & last_mask;
+        return;
+    }
+    words[first] |= first_mask;
+    for (uint32_t i = first + 1; i < last; i++) {
+        words[i] = ~0ULL;
+    }
+    words[last] |= last_mask;
+}
+
+// 将任意容器展开为位图
+static void container_to_bitmap(const RoaringContainer *c, uint64_t *words) {
+    if (c->type == CONTAINER_BITMAP) {
+        memcpy(words, c->data, BITMAP_BYTES);
+        return;
+    }
+
+    memset(words, 0, BITMAP_BYTES);
+    const uint16_t *values = c->data;
+    if (c->type == CONTAINER_ARRAY) {
+        for (int i = 0; i < c->cardinality; i++) {
+            words[values[i] >> 6] |= 1ULL << (values[i] & 63);
+        }
+    } else {
+        for (int i = 0; i < c->runs; i++) {
+            bitmap_set_range(words, values[2 * i], (uint32_t)values[2 * i] + values[2 * i + 1]);
+        }
+    }
+}
+
+// 判断容器中是否包含低16位为value的元素
+static bool container_contains(const RoaringContainer *c, uint16_t value) {
+    const uint16_t *values = c->data;
+    if (c->type == CONTAINER_BITMAP) {
+        return (((const uint64_t*)c->data)[value >> 6] >> (value & 63)) & 1;
+    }
+
+    if (c->type == CONTAINER_ARRAY) {
+        int lo = 0, hi = c->cardinality;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (values[mid] < value) lo = mid + 1; else hi = mid;
+        }
+        return lo < c->cardinality && values[lo] == value;
+    }
+
+    // 找到最后一个起点不大于value的游程
+    int lo = 0, hi = c->runs;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (values[2 * mid] <= value) lo = mid + 1; else hi = mid;
+    }
+    return lo > 0 && value - values[2 * (lo - 1)] <= values[2 * (lo - 1) + 1];
+}
+
+/**
+ * 由位图生成容器，自动选择最省空间的编码
+ * 返回值：
+ *   成功返回true；位图为空时out->cardinality为0
+ * 算法原理：
+ * 基数由逐字popcount得到；游程起点是“本位为1且前一位为0”的位置，
+ * 用 w & ~(w << 1 | 上一字的最高位) 一次统计64位中的起点个数
+ */
+static bool container_from_bitmap(Arena *arena, const uint64_t *words, uint16_t key,
+                                  RoaringContainer *out) {
+    int cardinality = 0, runs = 0;
+    uint64_t carry = 0;
+    for (int i = 0; i < BITMAP_WORDS; i++) {
+        uint64_t w = words[i];
+        cardinality += __builtin_popcountll(w);
+        runs += __builtin_popcountll(w & ~((w << 1) | carry));
+        carry = w >> 63;
+    }
+
+    out->key = key;
+    out->cardinality = cardinality;
+    out->runs = runs;
+    out->data = NULL;
+    if (cardinality == 0) return true;
+
+    out->type = (uint8_t)choose_type(cardinality, runs);
+    if (out->type == CONTAINER_BITMAP) {
+        out->data = arena_alloc(arena, BITMAP_BYTES);
+        if (!out->data) return false;
+        memcpy(out->data, words, BITMAP_BYTES);
+        return true;
+    }
+
+    size_t count = out->type == CONTAINER_ARRAY ? (size_t)cardinality : (size_t)runs * 2;
+    uint16_t *values = arena_alloc(arena, count * sizeof(uint16_t));
+    if (!values) return false;
+    out->data = values;
+
+    int k = 0;
+    if (out->type == CONTAINER_ARRAY) {
+        for (int i = 0; i < BITMAP_WORDS; i++) {
+            uint64_t w = words[i];
+            while (w) {
+                values[k++] = (uint16_t)(i * 64 + __builtin_ctzll(w));
+                w &= w - 1;
+            }
+        }
+        return true;
+    }
+
+    // 逐位扫描游程边界，整字为0或全1时直接跳过
+    uint32_t bit = 0;
+    while (bit < CHUNK_BITS) {
+        uint64_t w = words[bit >> 6] >> (bit & 63);
+        if (w == 0) {
+            bit = (bit | 63) + 1;
+            continue;
+        }
+        bit += (uint32_t)__builtin_ctzll(w);
+        uint32_t start = bit;
+        while (bit < CHUNK_BITS) {
+            uint64_t ones = ~(words[bit >> 6] >> (bit & 63));
+            if ((bit & 63) != 0) ones &= ~0ULL >> (bit & 63);
+            if (ones == 0) {
+                bit = (bit | 63) + 1;
+                continue;
+            }
+            bit += (uint32_t)__builtin_ctzll(ones);
+            break;
+        }
+        values[k++] = (uint16_t)start;
+        values[k++] = (uint16_t)(bit - 1 - start);
+    }
+    return true;
+}
+
+/**
+ * 由有序uint16序列生成容器
+ * 参数：
+ *   values, count: 严格递增的低16位
+ */
+static bool container_from_values(Arena *arena, const uint16_t *values, int count, uint16_t key,
+                                   RoaringContainer *out) {
+    int runs = count > 0 ? 1 : 0;
+    for (int i = 1; i < count; i++) {
+        if (values[i] != values[i - 1] + 1) runs++;
+    }
+
+    out->key = key;
+    out->cardinality = count;
+    out->runs = runs;
+    out->data = NULL;
+    if (count == 0) return true;
+
+    out->type = (uint8_t)choose_type(count, runs);
+    if (out->type == CONTAINER_ARRAY) {
+        out->data = arena_alloc(arena, (size_t)count * sizeof(uint16_t));
+        if (!out->data) return false;
+        memcpy(out->data, values, (size_t)count * sizeof(uint16_t));
+    } else if (out->type == CONTAINER_RUN) {
+        uint16_t *pairs = arena_alloc(arena, (size_t)runs * 2 * sizeof(uint16_t));
+        if (!pairs) return false;
+        int k = 0;
+        for (int i = 0; i < count; ) {
+            int j = i + 1;
+            while (j < count && values[j] == values[j - 1] + 1) j++;
+            pairs[k++] = values[i];
+            pairs[k++] = (uint16_t)(j - i - 1);
+            i = j;
+        }
+        out->data = pairs;
+    } else {
+        uint64_t *words = arena_alloc(arena, BITMAP_BYTES);
+        if (!words) return false;
+        memset(words, 0, BITMAP_BYTES);
+        for (int i = 0; i < count; i++) {
+            words[values[i] >> 6] |= 1ULL << (values[i] & 63);
+        }
+        out->data = words;
+    }
+    return true;
+}
+
+/**
+ * 由有序无重复整数数组构建压缩位图
+ * 参数：
+ *   bitmap: 已初始化的空位图
+ *   arr, size: 有序且无重复的整数
+ * 返回值：
+ *   成功返回true，内存不足返回false
+ */
+bool roaring_from_sorted(RoaringBitmap *bitmap, const int *arr, int size) {
+    uint16_t chunk[CHUNK_BITS];
+    int i = 0;
+    while (i < size) {
+        uint32_t key = to_unsigned(arr[i]) >> 16;
+        int count = 0;
+        while (i < size && (to_unsigned(arr[i]) >> 16) == key) {
+            chunk[count++] = (uint16_t)to_unsigned(arr[i]);
+            i++;
+        }
+        RoaringContainer *c = append_container(bitmap);
+        if (!c || !container_from_values(bitmap->arena, chunk, count, (uint16_t)key, c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 两个数组容器的归并运算，keep_a_only/keep_b_only/keep_both 描述运算的真值表
+static int merge_arrays(const uint16_t *a, int na, const uint16_t *b, int nb,
+                        bool keep_a_only, bool keep_b_only, bool keep_both, uint16_t *out) {
+    int i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            if (keep_a_only) out[k++] = a[i];
+            i++;
+        } else if (a[i] > b[j]) {
+            if (keep_b_only) out[k++] = b[j];
+            j++;
+        } else {
+            if (keep_both) out[k++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    if (keep_a_only) while (i < na) out[k++] = a[i++];
+    if (keep_b_only) while (j < nb) out[k++] = b[j++];
+    return k;
+}
+
+/**
+ * 对key相同的两个容器执行集合运算
+ * 算法原理：
+ * 1. 两个数组容器：直接归并
+ * 2. 左侧为数组的交集/差集：逐个元素在右侧容器中查找
+ * 3. 其余情况：展开为位图，按64位字执行 AND/OR/ANDNOT/XOR
+ * 结果再按密度重新选择编码；返回的容器基数可能为0
+ */
+static bool container_op(Arena *arena, const RoaringContainer *a, const RoaringContainer *b,
+                         RoaringOp op, RoaringContainer *out) {
+    uint16_t values[CHUNK_BITS];
+
+    if (a->type == CONTAINER_ARRAY && b->type == CONTAINER_ARRAY) {
+        int k = merge_arrays(a->data, a->cardinality, b->data, b->cardinality,
+                             op != ROARING_AND, op == ROARING_OR || op == ROARING_XOR,
+                             op == ROARING_OR || op == ROARING_AND, values);
+        return container_from_values(arena, values, k, a->key, out);
+    }
+
+    if (a->type == CONTAINER_ARRAY && (op == ROARING_AND || op == ROARING_ANDNOT)) {
+        const uint16_t *src = a->data;
+        bool keep = op == ROARING_AND;
+        int k = 0;
+        for (int i = 0; i < a->cardinality; i++) {
+            if (container_contains(b, src[i]) == keep) values[k++] = src[i];
+        }
+        return container_from_values(arena, values, k, a->key, out);
+    }
+
+    if (b->type == CONTAINER_ARRAY && op == ROARING_AND) {
+        return container_op(arena, b, a, op, out);
+    }
+
+    uint64_t wa[BITMAP_WORDS], wb[BITMAP_WORDS];
+    container_to_bitmap(a, wa);
+    container_to_bitmap(b, wb);
+    switch (op) {
+        case ROARING_OR:
+            for (int i = 0; i < BITMAP_WORDS; i++) wa[i] |= wb[i];
+            break;
+        case ROARING_AND:
+            for (int i = 0; i < BITMAP_WORDS; i++) wa[i] &= wb[i];
+            break;
+        case ROARING_ANDNOT:
+            for (int i = 0; i < BITMAP_WORDS; i++) wa[i] &= ~wb[i];
+            break;
+        case ROARING_XOR:
+            for (int i = 0; i < BITMAP_WORDS; i++) wa[i] ^= wb[i];
+            break;
+    }
+    return container_from_bitmap(arena, wa, a->key, out);
+}
+
+/**
+ * 两个压缩位图的集合运算
+ * 参数：
+ *   a, b: 输入位图
+ *   op: 运算类型
+ *   out: 已初始化的空位图，用于存放结果
+ * 返回值：
+ *   成功返回true，内存不足返回false
+ * 算法原理：
+ * 按key归并两侧的容器列表；只出现在一侧的容器按运算语义整体保留或丢弃，
+ * 两侧都有的容器调用container_op，结果为空的容器不输出。
+ * 只在一侧出现的容器与输入共享数据，不做复制
+ */
+bool roaring_op(const RoaringBitmap *a, const RoaringBitmap *b, RoaringOp op, RoaringBitmap *out) {
+    bool keep_a_only = op != ROARING_AND;
+    bool keep_b_only = op == ROARING_OR || op == ROARING_XOR;
+    int i = 0, j = 0;
+
+    while (i < a->size || j < b->size) {
+        const RoaringContainer *ca = i < a->size ? &a->containers[i] : NULL;
+        const RoaringContainer *cb = j < b->size ? &b->containers[j] : NULL;
+        const RoaringContainer *single = NULL;
+        bool keep = false;
+
+        if (ca && (!cb || ca->key < cb->key)) {
+            single = ca;
+            keep = keep_a_only;
+            i++;
+        } else if (cb && (!ca || cb->key < ca->key)) {
+            single = cb;
+            keep = keep_b_only;
+            j++;
+        } else {
+            RoaringContainer result;
+            if (!container_op(out->arena, ca, cb, op, &result)) return false;
+            i++;
+            j++;
+            if (result.cardinality > 0) {
+                RoaringContainer *slot = append_container(out);
+                if (!slot) return false;
+                *slot = result;
+            }
+            continue;
+        }
+
+        if (keep) {
+            RoaringContainer *slot = append_container(out);
+            if (!slot) return false;
+            *slot = *single;
+        }
+    }
+    return true;
+}
+
+// 位图中的元素总数
+long long roaring_cardinality(const RoaringBitmap *bitmap) {
+    long long total = 0;
+    for (int i = 0; i < bitmap->size; i++) {
+        total += bitmap->containers[i].cardinality;
+    }
+    return total;
+}
+
+/**
+ * 将压缩位图展开为有序整数数组
+ * 参数：
+ *   out: 容量至少为roaring_cardinality的输出数组
+ * 返回值：
+ *   写入的元素个数
+ */
+int roaring_to_array(const RoaringBitmap *bitmap, int *out) {
+    int k = 0;
+    for (int i = 0; i < bitmap->size; i++) {
+        const RoaringContainer *c = &bitmap->containers[i];
+        uint32_t high = (uint32_t)c->key << 16;
+        const uint16_t *values = c->data;
+
+        if (c->type == CONTAINER_ARRAY) {
+            for (int j = 0; j < c->cardinality; j++) {
+                out[k++] = to_signed(high | values[j]);
+            }
+        } else if (c->type == CONTAINER_RUN) {
+            for (int j = 0; j < c->runs; j++) {
+                uint32_t start = values[2 * j], end = start + values[2 * j + 1];
+                for (uint32_t v = start; v <= end; v++) {
+                    out[k++] = to_signed(high | v);
+                }
+            }
+        } else {
+            const uint64_t *words = c->data;
+            for (int w = 0; w < BITMAP_WORDS; w++) {
+                uint64_t bits = words[w];
+                while (bits) {
+                    out[k++] = to_signed(high | (uint32_t)(w * 64 + __builtin_ctzll(bits)));
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+    return k;
+}
+
+// 运算代价模型的单位，约为顺序处理一个元素的时间的一半，由集合运算性能测试标定
+#define COST_MERGE_ELEMENT 8        // 有序归并一个元素：比较分支难以预测
+#define COST_MERGE_RUN_ELEMENT 2    // 连续区间内的元素：归并的分支可预测
+#define COST_BUILD_ELEMENT 2        // 把一个元素放入容器
+#define COST_BITMAP_CONTAINER 12000 // 一个位图容器参与五项运算的按字运算与分配
+#define COST_BITMAP_ELEMENT 1       // 位图容器中一个元素的展开
+#define COST_ARRAY_ELEMENT 40       // 数组容器中一个元素参与五项运算
+#define COST_RUN 150                // 游程容器中一段游程参与五项运算
+
+/**
+ * 估算一个有序数组分别用有序归并与压缩位图完成全部集合运算的代价
+ * 参数：
+ *   sorted, size: 有序且无重复的集合
+ *   merge_cost, roaring_cost: 累加两种方式的代价
+ * 算法原理：
+ * 一次扫描统计每个2^16块的基数与游程数，按choose_type确定容器类型；
+ * 位图容器每次运算只处理1024个64位字，与块内元素个数无关，
+ * 数组与游程容器逐元素或逐段运算，比直接归并慢
+ */
+static void estimate_costs(const int *sorted, int size, size_t *merge_cost, size_t *roaring_cost) {
+    *roaring_cost += (size_t)size * COST_BUILD_ELEMENT;
+    int i = 0;
+    while (i < size) {
+        uint32_t key = to_unsigned(sorted[i]) >> 16;
+        int cardinality = 0, runs = 0;
+        uint32_t prev = 0;
+        while (i < size && (to_unsigned(sorted[i]) >> 16) == key) {
+            uint32_t v = to_unsigned(sorted[i]);
+            if (cardinality == 0 || v != prev + 1) runs++;
+            prev = v;
+            cardinality++;
+            i++;
+        }
+
+        switch (choose_type(cardinality, runs)) {
+            case CONTAINER_ARRAY:
+                *merge_cost += (size_t)cardinality * COST_MERGE_ELEMENT;
+                *roaring_cost += (size_t)cardinality * COST_ARRAY_ELEMENT;
+                break;
+            case CONTAINER_RUN:
+                *merge_cost += (size_t)cardinality * COST_MERGE_RUN_ELEMENT;
+                *roaring_cost += (size_t)runs * COST_RUN;
+                break;
+            case CONTAINER_BITMAP:
+                *merge_cost += (size_t)cardinality * COST_MERGE_ELEMENT;
+                *roaring_cost += COST_BITMAP_CONTAINER + (size_t)cardinality * COST_BITMAP_ELEMENT;
+                break;
+        }
+    }
+}
+
+/**
+ * 判断两个集合的全部运算改用压缩位图是否更快
+ * 返回值：
+ *   压缩位图的估算代价比有序归并低ROARING_GAIN_PERCENT%以上时返回true
+ * 说明：
+ * 输入与结果仍是int数组，压缩位图只在运算期间临时建立，选择只考虑运算时间；
+ * 通常只有大部分元素落在位图容器中（块内密度约在1/16以上且不成连续区间）时才会选用
+ */
+bool roaring_is_cheaper(const int *a, int na, const int *b, int nb) {
+    size_t merge_cost = 0, roaring_cost = 0;
+    estimate_costs(a, na, &merge_cost, &roaring_cost);
+    estimate_costs(b, nb, &merge_cost, &roaring_cost);
+    return roaring_cost * (100 + ROARING_GAIN_PERCENT) < merge_cost * 100;
+}
@@ -0,0 +1,52 @@
+#ifndef ROARING_H
+#define ROARING_H
+
+#include "../utils/arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 容器类型：每个容器覆盖 2^16 个连续整数，按密度选择最省空间的编码
+typedef enum {
+    CONTAINER_ARRAY,    // 有序uint16数组，适合稀疏块（不超过4096个元素）
+    CONTAINER_BITMAP,   // 1024个64位字组成的位图，适合稠密块
+    CONTAINER_RUN       // (起点, 长度-1) 对组成的游程，适合连续区间
+} ContainerType;
+
+// 单个容器
+typedef struct {
+    uint16_t key;           // 元素的高16位
+    uint8_t type;           // ContainerType
+    int cardinality;        // 容器内元素个数
+    int runs;               // 游程容器中的游程个数
+    void *data;             // uint16_t数组、uint64_t位图或uint16_t游程对
+} RoaringContainer;
+
+// 压缩位图集合，容器按key升序排列，内存全部来自区域分配器
+typedef struct {
+    RoaringContainer *containers;
+    int size;
+    int capacity;
+    Arena *arena;
+} RoaringBitmap;
+
+// 集合运算类型
+typedef enum {
+    ROARING_OR,
+    ROARING_AND,
+    ROARING_ANDNOT,
+    ROARING_XOR
+} RoaringOp;
+
+// 压缩位图的估算运算代价至少要比有序归并低 ROARING_GAIN_PERCENT% 才会被自动选用
+#define ROARING_GAIN_PERCENT 25
+
+// 函数声明
+void roaring_init(RoaringBitmap *bitmap, Arena *arena);
+bool roaring_from_sorted(RoaringBitmap *bitmap, const int *arr, int size);
+bool roaring_op(const RoaringBitmap *a, const RoaringBitmap *b, RoaringOp op, RoaringBitmap *out);
+long long roaring_cardinality(const RoaringBitmap *bitmap);
+int roaring_to_array(const RoaringBitmap *bitmap, int *out);
+bool roaring_is_cheaper(const int *a, int na, const int *b, int nb);
+
+#endif
@@ -0,0 +1,119 @@
+#include "set_bench.h"
+#include "simd_intersect.h"
+#include "set_parallel.h"
+#include "../utils/xorshift.h"
+#include <stdlib.h>
+
+// 单个内核至少运行的时间（微秒），保证计时稳定
+#define BENCH_MIN_DURATION_US 200000
+
+// 生成严格递增的测试集合，相邻元素间隔为1~4，两个集合约有四成元素重合
+static void fill_sorted(int *arr, int size, uint32_t *seed) {
+    int value = 0;
+    for (int i = 0; i < size; i++) {
+        value += 1 + (int)(xorshift32_next(seed) % 4);
+        arr[i] = value;
+    }
+}
+
+/**
+ * 测量一个求交内核的吞吐量
+ * 返回值：
+ *   每秒处理的输入元素个数（两个集合元素数之和）
+ */
+static double measure_kernel(IntersectKernel kernel, const int *a, const int *b, int size,
+                             int *out, int *result_size) {
+    gint64 start = g_get_monotonic_time();
+    gint64 elapsed = 0;
+    long long rounds = 0;
+    do {
+        *result_size = kernel(a, size, b, size, out);
+        rounds++;
+        elapsed = g_get_monotonic_time() - start;
+    } while (elapsed < BENCH_MIN_DURATION_US);
+
+    return (double)rounds * 2.0 * size / ((double)elapsed / 1e6);
+}
+
+// 测试的线程数序列：1、2、4……倍增，最后一项为max_threads
+static int next_thread_count(int threads, int max_threads) {
+    if (threads >= max_threads) return max_threads + 1;
+    return threads * 2 < max_threads ? threads * 2 : max_threads;
+}
+
+/**
+ * 测量指定线程数下并集运算的吞吐量
+ * 返回值：
+ *   每秒处理的输入元素个数（两个集合元素数之和）
+ */
+static double measure_parallel_union(const int *a, const int *b, int size, int *out, int threads) {
+    SetMergeResult res = { .union_out = out };
+    gint64 start = g_get_monotonic_time();
+    gint64 elapsed = 0;
+    long long rounds = 0;
+    do {
+        set_merge_parallel(a, size, b, size, &res, threads);
+        rounds++;
+        elapsed = g_get_monotonic_time() - start;
+    } while (elapsed < BENCH_MIN_DURATION_US);
+
+    return (double)rounds * 2.0 * size / ((double)elapsed / 1e6);
+}
+
+/**
+ * 运行求交内核性能测试
+ * 返回值：
+ *   测试报告文本，调用者用g_free释放；内存不足返回NULL
+ * 算法原理：
+ * 1. 对同一组有序集合依次运行每个可用的内核，报告吞吐量（元素/秒）
+ *    以及相对标量版本的加速比
+ * 2. 线程数按1、2、4……倍增到max_threads运行并行并集，报告加速比曲线
+ */
+gchar* set_benchmark_report(int max_threads) {
+    int *a = malloc(BENCH_SET_SIZE * sizeof(int));
+    int *b = malloc(BENCH_SET_SIZE * sizeof(int));
+    int *out = malloc(2 * BENCH_SET_SIZE * sizeof(int));
+    if (!a || !b || !out) {
+        free(a);
+        free(b);
+        free(out);
+        return NULL;
+    }
+
+    uint32_t seed = 12345;
+    fill_sorted(a, BENCH_SET_SIZE, &seed);
+    fill_sorted(b, BENCH_SET_SIZE, &seed);
+
+    GString *report = g_string_new(NULL);
+    g_string_append_printf(report, "有序集合求交性能测试（每个集合 %d 个元素）\n", BENCH_SET_SIZE);
+
+    double baseline = 0.0;
+    for (int id = 0; id < INTERSECT_KERNEL_COUNT; id++) {
+        IntersectKernel kernel = intersect_get_kernel((IntersectKernelId)id);
+        const char *name = intersect_kernel_name((IntersectKernelId)id);
+        if (!kernel) {
+            g_string_append_printf(report, "%-6s  当前CPU不支持\n", name);
+            continue;
+        }
+
+        int result_size = 0;
+        double throughput = measure_kernel(kernel, a, b, BENCH_SET_SIZE, out, &result_size);
+        if (id == INTERSECT_SCALAR) baseline = throughput;
+        g_string_append_printf(report, "%-6s  %.1f M元素/秒  加速比 %.2fx  （交集 %d 个元素）\n",
+                               name, throughput / 1e6, throughput / baseline, result_size);
+    }
+
+    g_string_append_printf(report, "\n多线程并集（按值域分区，最多 %d 个线程）\n", max_threads);
+    double single = 0.0;
+    for (int threads = 1; threads <= max_threads; threads = next_thread_count(threads, max_threads)) {
+        double throughput = measure_parallel_union(a, b, BENCH_SET_SIZE, out, threads);
+        if (threads == 1) single = throughput;
+        g_string_append_printf(report, "%2d 线程  %.1f M元素/秒  加速比 %.2fx\n",
+                               threads, throughput / 1e6, throughput / single);
+    }
+
+    free(a);
+    free(b);
+    free(out);
+    return g_string_free(report, FALSE);
+}
@@ -0,0 +1,12 @@
+#ifndef SET_BENCH_H
+#define SET_BENCH_H
+
+#include <gtk/gtk.h>
+
+// 性能测试使用的集合规模
+#define BENCH_SET_SIZE (1 << 20)
+
+// 函数声明
+gchar* set_benchmark_report(int max_threads);
+
+#endif
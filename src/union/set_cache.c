@@ -0,0 +1,115 @@
+#include "set_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 缓存条目，按最近使用顺序串成双向链表
+typedef struct CacheEntry {
+    struct CacheEntry *prev;
+    struct CacheEntry *next;
+    uint64_t key_a;             // 输入文本的哈希（解析结果）或集合1文本的哈希（运算结果）
+    uint64_t key_b;             // 集合2文本的哈希，解析结果为0
+    SetCacheKind kind;
+    int size;
+    int *data;
+} CacheEntry;
+
+// 链表头为最近使用的条目，链表尾为最久未使用的条目
+static CacheEntry *cache_head = NULL;
+static CacheEntry *cache_tail = NULL;
+static int cache_count = 0;
+static size_t cache_bytes = 0;
+
+static void unlink_entry(CacheEntry *entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache_head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache_tail = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void push_front(CacheEntry *entry) {
+    entry->prev = NULL;
+    entry->next = cache_head;
+    if (cache_head) cache_head->prev = entry;
+    cache_head = entry;
+    if (!cache_tail) cache_tail = entry;
+}
+
+static void free_entry(CacheEntry *entry) {
+    unlink_entry(entry);
+    cache_count--;
+    cache_bytes -= (size_t)entry->size * sizeof(int);
+    free(entry->data);
+    free(entry);
+}
+
+/**
+ * 查找缓存条目
+ * 参数：
+ *   key_a, key_b, kind: 条目的键
+ *   size: 输出元素个数
+ * 返回值：
+ *   命中时返回缓存的数组（在下一次set_cache_store之前有效），未命中返回NULL
+ * 说明：
+ * 条目数很少，顺序查找即可；命中的条目移到链表头
+ */
+const int* set_cache_lookup(uint64_t key_a, uint64_t key_b, SetCacheKind kind, int *size) {
+    for (CacheEntry *e = cache_head; e; e = e->next) {
+        if (e->key_a == key_a && e->key_b == key_b && e->kind == kind) {
+            if (e != cache_head) {
+                unlink_entry(e);
+                push_front(e);
+            }
+            *size = e->size;
+            return e->data;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * 存入一个条目（复制数据）
+ * 返回值：
+ *   成功返回true；数据超过缓存上限或内存不足时返回false，缓存保持可用
+ * 算法原理：
+ * 新条目放在链表头，条目数或总字节数超限时从链表尾依次淘汰
+ */
+bool set_cache_store(uint64_t key_a, uint64_t key_b, SetCacheKind kind, const int *data, int size) {
+    size_t bytes = (size_t)size * sizeof(int);
+    if (bytes > SET_CACHE_MAX_BYTES) return false;
+
+    int existing_size;
+    if (set_cache_lookup(key_a, key_b, kind, &existing_size)) {
+        return true;
+    }
+
+    CacheEntry *entry = malloc(sizeof(CacheEntry));
+    int *copy = malloc(bytes ? bytes : 1);
+    if (!entry || !copy) {
+        free(entry);
+        free(copy);
+        return false;
+    }
+    if (bytes) memcpy(copy, data, bytes);
+
+    while (cache_tail && (cache_count >= SET_CACHE_MAX_ENTRIES || cache_bytes + bytes > SET_CACHE_MAX_BYTES)) {
+        free_entry(cache_tail);
+    }
+
+    entry->key_a = key_a;
+    entry->key_b = key_b;
+    entry->kind = kind;
+    entry->size = size;
+    entry->data = copy;
+    push_front(entry);
+    cache_count++;
+    cache_bytes += bytes;
+    return true;
+}
+
+// 清空缓存
+void set_cache_clear(void) {
+    while (cache_head) {
+        free_entry(cache_head);
+    }
+}
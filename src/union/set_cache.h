@@ -0,0 +1,26 @@
+#ifndef SET_CACHE_H
+#define SET_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 缓存的最大条目数与最大总字节数，超出时淘汰最久未使用的条目
+#define SET_CACHE_MAX_ENTRIES 16
+#define SET_CACHE_MAX_BYTES ((size_t)256 * 1024 * 1024)
+
+// 缓存条目的种类：解析后的输入集合或某项运算结果
+typedef enum {
+    SET_CACHE_PARSED,
+    SET_CACHE_UNION,
+    SET_CACHE_INTERSECTION,
+    SET_CACHE_A_MINUS_B,
+    SET_CACHE_B_MINUS_A,
+    SET_CACHE_SYM_DIFF
+} SetCacheKind;
+
+// 函数声明
+const int* set_cache_lookup(uint64_t key_a, uint64_t key_b, SetCacheKind kind, int *size);
+bool set_cache_store(uint64_t key_a, uint64_t key_b, SetCacheKind kind, const int *data, int size);
+void set_cache_clear(void);
+
+#endif
@@ -0,0 +1,657 @@
+#include "set_expr.h"
+#include "set_merge.h"
+#include "set_parallel.h"
+#include "set_kway.h"
+#include "../sorting/sort_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <limits.h>
+
+// 运算类型；并与交可以有任意个运算对象，差与对称差恰好两个
+typedef enum {
+    EXPR_SET,
+    EXPR_EMPTY,
+    EXPR_UNION,
+    EXPR_INTERSECTION,
+    EXPR_DIFFERENCE,
+    EXPR_SYM_DIFF
+} ExprOp;
+
+// 运算符的写法：数学符号与ASCII替代写法
+static const struct {
+    const char *text;
+    ExprOp op;
+} expr_operators[] = {
+    { "∪", EXPR_UNION }, { "|", EXPR_UNION }, { "+", EXPR_UNION },
+    { "∩", EXPR_INTERSECTION }, { "&", EXPR_INTERSECTION },
+    { "−", EXPR_DIFFERENCE }, { "∖", EXPR_DIFFERENCE }, { "-", EXPR_DIFFERENCE }, { "\\", EXPR_DIFFERENCE },
+    { "△", EXPR_SYM_DIFF }, { "⊕", EXPR_SYM_DIFF }, { "^", EXPR_SYM_DIFF }
+};
+
+static const char *const expr_symbols[] = {
+    [EXPR_UNION] = " ∪ ", [EXPR_INTERSECTION] = " ∩ ", [EXPR_DIFFERENCE] = " − ", [EXPR_SYM_DIFF] = " △ "
+};
+
+// 语法树节点
+typedef struct Ast {
+    ExprOp op;
+    const char *name;           // EXPR_SET：集合名称
+    struct Ast *left;
+    struct Ast *right;
+} Ast;
+
+// 递归下降解析器
+typedef struct {
+    const char *text;
+    size_t pos;
+    Arena *arena;
+    int ast_count;
+    bool failed;
+    char *error;
+    size_t error_size;
+} Parser;
+
+// DAG节点：相同的子表达式只有一个节点，只计算一次
+typedef struct {
+    ExprOp op;
+    const char *name;           // EXPR_SET：集合名称
+    int *children;
+    int child_count;
+    long long estimate;         // 结果规模的估计，集合节点为精确值
+    const int *values;
+    int size;
+    bool done;
+} ExprNode;
+
+typedef struct {
+    ExprNode *nodes;
+    int count;
+    int capacity;
+    int empty;                  // 空集节点，-1表示尚未创建
+    Arena *arena;
+    int threads;
+    SetExprResolver resolver;
+    void *user_data;
+    SetExprResult *stats;
+    char *error;
+    size_t error_size;
+} ExprGraph;
+
+// 记录错误信息
+static void set_error(char *error, size_t error_size, const char *format, ...) {
+    if (!error || error_size == 0) return;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+}
+
+// 字节偏移对应的字符序号（从1开始，按UTF-8计数）
+static long char_offset(const char *text, size_t pos) {
+    long count = 1;
+    for (size_t i = 0; i < pos; i++) {
+        if (((unsigned char)text[i] & 0xC0) != 0x80) count++;
+    }
+    return count;
+}
+
+static void parse_error(Parser *p, const char *what) {
+    if (p->failed) return;
+    p->failed = true;
+    set_error(p->error, p->error_size, "表达式第%ld个字符处%s", char_offset(p->text, p->pos), what);
+}
+
+static void skip_spaces(Parser *p) {
+    while (isspace((unsigned char)p->text[p->pos])) p->pos++;
+}
+
+// 当前位置的运算符，匹配时返回其字节长度，否则返回0
+static size_t match_operator(const char *s, ExprOp *op) {
+    for (size_t i = 0; i < sizeof(expr_operators) / sizeof(expr_operators[0]); i++) {
+        size_t length = strlen(expr_operators[i].text);
+        if (strncmp(s, expr_operators[i].text, length) == 0) {
+            *op = expr_operators[i].op;
+            return length;
+        }
+    }
+    return 0;
+}
+
+// 名称由字母、数字、下划线与非ASCII字符（运算符除外）组成
+static bool is_name_char(const char *s) {
+    unsigned char c = (unsigned char)*s;
+    ExprOp op;
+    if (c >= 0x80) return match_operator(s, &op) == 0;
+    return isalnum(c) || c == '_';
+}
+
+static Ast* new_ast(Parser *p, ExprOp op, const char *name, Ast *left, Ast *right) {
+    Ast *node = arena_alloc(p->arena, sizeof(Ast));
+    if (!node) {
+        parse_error(p, "内存分配失败");
+        return NULL;
+    }
+    node->op = op;
+    node->name = name;
+    node->left = left;
+    node->right = right;
+    p->ast_count++;
+    return node;
+}
+
+static Ast* parse_expr(Parser *p);
+
+// factor := 名称 | ∅ | '(' expr ')'
+static Ast* parse_factor(Parser *p) {
+    skip_spaces(p);
+    if (p->text[p->pos] == '(') {
+        p->pos++;
+        Ast *inner = parse_expr(p);
+        if (!inner) return NULL;
+        skip_spaces(p);
+        if (p->text[p->pos] != ')') {
+            parse_error(p, "缺少')'");
+            return NULL;
+        }
+        p->pos++;
+        return inner;
+    }
+
+    size_t start = p->pos;
+    while (p->text[p->pos] && is_name_char(p->text + p->pos)) {
+        p->pos++;
+    }
+    if (p->pos == start) {
+        parse_error(p, p->text[p->pos] ? "应为集合名称或'('" : "表达式不完整");
+        return NULL;
+    }
+
+    size_t length = p->pos - start;
+    char *name = arena_alloc(p->arena, length + 1);
+    if (!name) {
+        parse_error(p, "内存分配失败");
+        return NULL;
+    }
+    memcpy(name, p->text + start, length);
+    name[length] = '\0';
+    return new_ast(p, strcmp(name, "∅") == 0 ? EXPR_EMPTY : EXPR_SET, name, NULL, NULL);
+}
+
+// term := factor { ∩ factor }，交的优先级高于其余运算
+static Ast* parse_term(Parser *p) {
+    Ast *left = parse_factor(p);
+    while (left) {
+        skip_spaces(p);
+        ExprOp op;
+        size_t length = match_operator(p->text + p->pos, &op);
+        if (length == 0 || op != EXPR_INTERSECTION) break;
+        p->pos += length;
+        Ast *right = parse_factor(p);
+        if (!right) return NULL;
+        left = new_ast(p, op, NULL, left, right);
+    }
+    return left;
+}
+
+// expr := term { (∪ | − | △) term }，同级运算左结合
+static Ast* parse_expr(Parser *p) {
+    Ast *left = parse_term(p);
+    while (left) {
+        skip_spaces(p);
+        ExprOp op;
+        size_t length = match_operator(p->text + p->pos, &op);
+        if (length == 0 || op == EXPR_INTERSECTION) break;
+        p->pos += length;
+        Ast *right = parse_term(p);
+        if (!right) return NULL;
+        left = new_ast(p, op, NULL, left, right);
+    }
+    return left;
+}
+
+// 查找或创建节点，相同的运算与运算对象只保留一个节点（公共子表达式合并）
+static int graph_add(ExprGraph *g, ExprOp op, const char *name, int *children, int child_count) {
+    for (int i = 0; i < g->count; i++) {
+        const ExprNode *n = &g->nodes[i];
+        if (n->op != op || n->child_count != child_count) continue;
+        if (op == EXPR_SET ? strcmp(n->name, name) == 0 :
+            memcmp(n->children, children, (size_t)child_count * sizeof(int)) == 0) {
+            return i;
+        }
+    }
+
+    ExprNode *n = &g->nodes[g->count];
+    memset(n, 0, sizeof(*n));
+    n->op = op;
+    n->name = name;
+    n->children = children;
+    n->child_count = child_count;
+    return g->count++;
+}
+
+static int empty_node(ExprGraph *g) {
+    if (g->empty < 0) {
+        g->empty = graph_add(g, EXPR_EMPTY, NULL, NULL, 0);
+        g->nodes[g->empty].done = true;
+    }
+    return g->empty;
+}
+
+// 把同一运算的连续嵌套展开为一层，如 (A ∪ B) ∪ C → ∪{A, B, C}
+static void flatten(const Ast *ast, ExprOp op, const Ast **operands, int *count) {
+    if (ast->op == op) {
+        flatten(ast->left, op, operands, count);
+        flatten(ast->right, op, operands, count);
+    } else {
+        operands[(*count)++] = ast;
+    }
+}
+
+static int build_node(ExprGraph *g, const Ast *ast);
+
+// 建立并或交节点：运算对象按编号排序去重，空集按运算的性质化简
+static int build_nary(ExprGraph *g, const Ast *ast) {
+    const Ast **operands = arena_alloc(g->arena, (size_t)g->capacity * sizeof(Ast*));
+    int *children = arena_alloc(g->arena, (size_t)g->capacity * sizeof(int));
+    if (!operands || !children) {
+        set_error(g->error, g->error_size, "内存分配失败");
+        return -1;
+    }
+
+    int count = 0;
+    flatten(ast, ast->op, operands, &count);
+    int k = 0;
+    for (int i = 0; i < count; i++) {
+        int child = build_node(g, operands[i]);
+        if (child < 0) return -1;
+        if (g->nodes[child].op == EXPR_EMPTY) {
+            if (ast->op == EXPR_INTERSECTION) return empty_node(g);
+            continue;
+        }
+        children[k++] = child;
+    }
+
+    sort_i32(children, (size_t)k);
+    int unique = 0;
+    for (int i = 0; i < k; i++) {
+        if (unique == 0 || children[i] != children[unique - 1]) {
+            children[unique++] = children[i];
+        }
+    }
+    if (unique == 0) return empty_node(g);
+    if (unique == 1) return children[0];
+
+    int id = graph_add(g, ast->op, NULL, children, unique);
+    ExprNode *n = &g->nodes[id];
+    long long estimate = ast->op == EXPR_UNION ? 0 : LLONG_MAX;
+    for (int i = 0; i < unique; i++) {
+        long long e = g->nodes[children[i]].estimate;
+        if (ast->op == EXPR_UNION) estimate += e;
+        else if (e < estimate) estimate = e;
+    }
+    n->estimate = estimate;
+    return id;
+}
+
+/**
+ * 由语法树建立DAG
+ * 返回值：
+ *   节点编号，失败返回-1（错误信息已记录）
+ * 说明：
+ * 集合节点的规模是精确值；并的估计为各对象之和，交为最小者，
+ * 差为被减集合，对称差为两者之和（都是上界）
+ */
+static int build_node(ExprGraph *g, const Ast *ast) {
+    if (ast->op == EXPR_EMPTY) {
+        return empty_node(g);
+    }
+    if (ast->op == EXPR_SET) {
+        int id = graph_add(g, EXPR_SET, ast->name, NULL, 0);
+        ExprNode *n = &g->nodes[id];
+        if (!n->done) {
+            ExprSet set;
+            if (!g->resolver(g->user_data, ast->name, &set)) {
+                set_error(g->error, g->error_size, "未定义的集合“%s”", ast->name);
+                return -1;
+            }
+            n->values = set.values;
+            n->size = set.size;
+            n->estimate = set.size;
+            n->done = true;
+        }
+        return id;
+    }
+
+    if (ast->op == EXPR_UNION || ast->op == EXPR_INTERSECTION) {
+        return build_nary(g, ast);
+    }
+
+    int left = build_node(g, ast->left);
+    int right = left < 0 ? -1 : build_node(g, ast->right);
+    if (right < 0) return -1;
+
+    bool left_empty = g->nodes[left].op == EXPR_EMPTY;
+    bool right_empty = g->nodes[right].op == EXPR_EMPTY;
+    if (left == right || left_empty) {
+        // A − A = A △ A = ∅，∅ − B = ∅，∅ △ B = B
+        if (ast->op == EXPR_SYM_DIFF && left != right) return right;
+        return empty_node(g);
+    }
+    if (right_empty) return left;
+
+    int *children = arena_alloc(g->arena, 2 * sizeof(int));
+    if (!children) {
+        set_error(g->error, g->error_size, "内存分配失败");
+        return -1;
+    }
+    // 对称差满足交换律，按编号排列以便合并相同的子表达式
+    bool swap = ast->op == EXPR_SYM_DIFF && right < left;
+    children[0] = swap ? right : left;
+    children[1] = swap ? left : right;
+
+    int id = graph_add(g, ast->op, NULL, children, 2);
+    ExprNode *n = &g->nodes[id];
+    n->estimate = ast->op == EXPR_DIFFERENCE ? g->nodes[left].estimate
+                                             : g->nodes[left].estimate + g->nodes[right].estimate;
+    return id;
+}
+
+// 规划：交的运算对象按估计规模从小到大排列，先算小的，中间结果始终不超过最小者
+static void plan_graph(ExprGraph *g) {
+    for (int i = 0; i < g->count; i++) {
+        ExprNode *n = &g->nodes[i];
+        if (n->op != EXPR_INTERSECTION) continue;
+        for (int a = 1; a < n->child_count; a++) {
+            int child = n->children[a];
+            int b = a;
+            while (b > 0 && g->nodes[n->children[b - 1]].estimate > g->nodes[child].estimate) {
+                n->children[b] = n->children[b - 1];
+                b--;
+            }
+            n->children[b] = child;
+        }
+    }
+}
+
+static int* alloc_values(ExprGraph *g, long long count) {
+    int *out = arena_alloc(g->arena, (size_t)(count > 0 ? count : 1) * sizeof(int));
+    if (!out) set_error(g->error, g->error_size, "内存分配失败");
+    return out;
+}
+
+// 两个运算对象恰为(x, y)时，该节点在一次归并中对应的输出；不对应时返回NULL
+static int** merge_slot(SetMergeResult *res, const ExprNode *n, int x, int y, int **size) {
+    if (n->done || n->child_count != 2) return NULL;
+    int c0 = n->children[0], c1 = n->children[1];
+    bool same = c0 == x && c1 == y, swapped = c0 == y && c1 == x;
+    if (!same && !swapped) return NULL;
+
+    switch (n->op) {
+        case EXPR_UNION:        *size = &res->union_size;        return &res->union_out;
+        case EXPR_INTERSECTION: *size = &res->intersection_size; return &res->intersection_out;
+        case EXPR_SYM_DIFF:     *size = &res->sym_diff_size;     return &res->sym_diff_out;
+        case EXPR_DIFFERENCE:
+            if (same) {
+                *size = &res->a_minus_b_size;
+                return &res->a_minus_b_out;
+            }
+            *size = &res->b_minus_a_size;
+            return &res->b_minus_a_out;
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * 对运算对象x、y做一次归并，同时得到所有以(x, y)为运算对象、尚未计算的节点
+ * 算法原理：
+ * 有序归并一遍即可同时产生并、交、两个方向的差与对称差，
+ * 因此像 (A − B) ∪ (A ∩ B) 这样共享运算对象的相邻运算只需扫描一次
+ */
+static bool fused_merge(ExprGraph *g, int x, int y) {
+    const ExprNode *a = &g->nodes[x], *b = &g->nodes[y];
+    SetMergeResult res = {0};
+    int targets[5], *sizes[5], **outs[5];
+    int count = 0;
+
+    for (int i = 0; i < g->count && count < 5; i++) {
+        int *size;
+        int **out = merge_slot(&res, &g->nodes[i], x, y, &size);
+        if (!out || *out) continue;
+
+        long long capacity = out == &res.intersection_out ? (a->size < b->size ? a->size : b->size) :
+                             out == &res.a_minus_b_out ? a->size :
+                             out == &res.b_minus_a_out ? b->size : (long long)a->size + b->size;
+        *out = alloc_values(g, capacity);
+        if (!*out) return false;
+        targets[count] = i;
+        sizes[count] = size;
+        outs[count] = out;
+        count++;
+    }
+
+    set_merge_parallel(a->values, a->size, b->values, b->size, &res, g->threads);
+    for (int i = 0; i < count; i++) {
+        ExprNode *n = &g->nodes[targets[i]];
+        n->values = *outs[i];
+        n->size = *sizes[i];
+        n->done = true;
+    }
+    g->stats->merge_passes++;
+    g->stats->fused += count - 1;
+    return true;
+}
+
+static void set_empty_result(ExprNode *n) {
+    n->values = NULL;
+    n->size = 0;
+    n->done = true;
+}
+
+static bool evaluate(ExprGraph *g, int id);
+
+// 按规划的顺序求交：结果为空时其余运算对象不再计算
+static bool evaluate_intersection(ExprGraph *g, int id) {
+    ExprNode *n = &g->nodes[id];
+    if (!evaluate(g, n->children[0])) return false;
+    n = &g->nodes[id];
+    const int *running = g->nodes[n->children[0]].values;
+    int running_size = g->nodes[n->children[0]].size;
+
+    for (int i = 1; i < n->child_count; i++) {
+        if (running_size == 0) {
+            g->stats->skipped += n->child_count - i;
+            break;
+        }
+        int child = n->children[i];
+        if (!evaluate(g, child)) return false;
+        // 只有两个运算对象时，与共享这两个对象的其他运算一起归并
+        if (n->child_count == 2) {
+            return fused_merge(g, n->children[0], child);
+        }
+
+        const ExprNode *c = &g->nodes[child];
+        SetMergeResult res = { .intersection_out = alloc_values(g, running_size < c->size ? running_size : c->size) };
+        if (!res.intersection_out) return false;
+        set_merge_parallel(running, running_size, c->values, c->size, &res, g->threads);
+        g->stats->merge_passes++;
+        running = res.intersection_out;
+        running_size = res.intersection_size;
+    }
+
+    n->values = running;
+    n->size = running_size;
+    n->done = true;
+    return true;
+}
+
+// 多个集合的并一次多路归并完成，两个集合时与共享运算对象的其他运算一起归并
+static bool evaluate_union(ExprGraph *g, int id) {
+    ExprNode *n = &g->nodes[id];
+    int k = n->child_count;
+    for (int i = 0; i < k; i++) {
+        if (!evaluate(g, n->children[i])) return false;
+    }
+    if (k == 2) {
+        return fused_merge(g, n->children[0], n->children[1]);
+    }
+
+    const int **sets = arena_alloc(g->arena, (size_t)k * sizeof(int*));
+    int *sizes = arena_alloc(g->arena, (size_t)k * sizeof(int));
+    if (!sets || !sizes) {
+        set_error(g->error, g->error_size, "内存分配失败");
+        return false;
+    }
+    for (int i = 0; i < k; i++) {
+        sets[i] = g->nodes[n->children[i]].values;
+        sizes[i] = g->nodes[n->children[i]].size;
+    }
+
+    int *out = alloc_values(g, (long long)set_kway_capacity(sizes, k, 1));
+    int size = out ? set_kway_threshold(sets, sizes, k, 1, out) : -1;
+    if (size < 0) {
+        set_error(g->error, g->error_size, "内存分配失败");
+        return false;
+    }
+    n->values = out;
+    n->size = size;
+    n->done = true;
+    g->stats->merge_passes++;
+    return true;
+}
+
+// 求出节点的值，已计算的节点直接复用
+static bool evaluate(ExprGraph *g, int id) {
+    ExprNode *n = &g->nodes[id];
+    if (n->done) return true;
+
+    switch (n->op) {
+        case EXPR_UNION:
+            return evaluate_union(g, id);
+        case EXPR_INTERSECTION:
+            return evaluate_intersection(g, id);
+        case EXPR_DIFFERENCE:
+            if (!evaluate(g, n->children[0])) return false;
+            if (g->nodes[n->children[0]].size == 0) {
+                g->stats->skipped++;
+                set_empty_result(&g->nodes[id]);
+                return true;
+            }
+            if (!evaluate(g, n->children[1])) return false;
+            return g->nodes[id].done || fused_merge(g, n->children[0], n->children[1]);
+        case EXPR_SYM_DIFF:
+            if (!evaluate(g, n->children[0]) || !evaluate(g, n->children[1])) return false;
+            return g->nodes[id].done || fused_merge(g, n->children[0], n->children[1]);
+        default:
+            set_empty_result(n);
+            return true;
+    }
+}
+
+// 把规划后的表达式写入plan：集合名称后附规模，交的运算对象按计算顺序排列
+static void append_plan(const ExprGraph *g, int id, char *plan, size_t size, size_t *length) {
+    const ExprNode *n = &g->nodes[id];
+    if (*length >= size) return;
+    char *p = plan + *length;
+    size_t room = size - *length;
+
+    if (n->op == EXPR_SET || n->op == EXPR_EMPTY) {
+        int written = n->op == EXPR_SET ? snprintf(p, room, "%s[%d]", n->name, n->size)
+                                        : snprintf(p, room, "∅");
+        *length += (size_t)written < room ? (size_t)written : room - 1;
+        return;
+    }
+
+    int written = snprintf(p, room, "(");
+    *length += (size_t)written < room ? (size_t)written : room - 1;
+    for (int i = 0; i < n->child_count; i++) {
+        if (i > 0 && *length < size) {
+            room = size - *length;
+            written = snprintf(plan + *length, room, "%s", expr_symbols[n->op]);
+            *length += (size_t)written < room ? (size_t)written : room - 1;
+        }
+        append_plan(g, n->children[i], plan, size, length);
+    }
+    if (*length < size) {
+        room = size - *length;
+        written = snprintf(plan + *length, room, ")");
+        *length += (size_t)written < room ? (size_t)written : room - 1;
+    }
+}
+
+/**
+ * 对集合表达式求值
+ * 参数：
+ *   expression: 如 "(A ∪ B) ∩ (C − D)"；运算符也可写作 | + & - \ ^
+ *   resolver, user_data: 按名称查找集合
+ *   arena: 中间结果与最终结果所在的区域
+ *   threads: 归并使用的线程数
+ *   result: 结果与执行统计
+ *   plan, plan_size: 规划后的表达式，可为NULL
+ *   error, error_size: 失败时的错误信息
+ * 返回值：
+ *   成功返回0，失败返回-1
+ * 算法原理：
+ * 1. 递归下降解析为语法树（交的优先级最高，其余运算左结合）
+ * 2. 建立DAG：同一运算的嵌套展开为多元运算，相同子表达式只保留一个节点，
+ *    并按 A ∩ ∅ = ∅、A − A = ∅ 等恒等式化简
+ * 3. 规划：交的运算对象按规模估计从小到大计算，任一中间结果为空即停止
+ * 4. 求值：多元并一次多路归并；共享同一对运算对象的二元运算合并为一次归并
+ */
+int set_expr_evaluate(const char *expression, SetExprResolver resolver, void *user_data,
+                      Arena *arena, int threads, SetExprResult *result,
+                      char *plan, size_t plan_size, char *error, size_t error_size) {
+    memset(result, 0, sizeof(*result));
+
+    Parser parser = {
+        .text = expression,
+        .arena = arena,
+        .error = error,
+        .error_size = error_size
+    };
+    Ast *root = parse_expr(&parser);
+    if (root) {
+        skip_spaces(&parser);
+        if (expression[parser.pos] != '\0') {
+            parse_error(&parser, "有多余的字符");
+            root = NULL;
+        }
+    }
+    if (!root) return -1;
+
+    // 每个语法树节点至多产生一个DAG节点，另加一个空集节点
+    ExprGraph graph = {
+        .capacity = parser.ast_count + 1,
+        .empty = -1,
+        .arena = arena,
+        .threads = threads,
+        .resolver = resolver,
+        .user_data = user_data,
+        .stats = result,
+        .error = error,
+        .error_size = error_size
+    };
+    graph.nodes = arena_alloc(arena, (size_t)graph.capacity * sizeof(ExprNode));
+    if (!graph.nodes) {
+        set_error(error, error_size, "内存分配失败");
+        return -1;
+    }
+
+    int id = build_node(&graph, root);
+    if (id < 0) return -1;
+    plan_graph(&graph);
+    if (!evaluate(&graph, id)) return -1;
+
+    result->values = graph.nodes[id].values;
+    result->size = graph.nodes[id].size;
+    result->node_count = graph.count;
+    if (plan && plan_size > 0) {
+        size_t length = 0;
+        plan[0] = '\0';
+        append_plan(&graph, id, plan, plan_size, &length);
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#ifndef SET_EXPR_H
+#define SET_EXPR_H
+
+#include "../utils/arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// 表达式中引用的具名集合（升序且无重复）
+typedef struct {
+    const int *values;
+    int size;
+} ExprSet;
+
+// 按名称查找集合，找不到时返回false
+typedef bool (*SetExprResolver)(void *user_data, const char *name, ExprSet *set);
+
+// 求值结果及执行统计
+typedef struct {
+    const int *values;      // 结果集合，位于区域中（或直接指向输入集合）
+    int size;
+    int node_count;         // 合并公共子表达式后的DAG节点数
+    int merge_passes;       // 执行的归并遍数
+    int fused;              // 与其他结果共享一次归并而得到的结果数
+    int skipped;            // 因中间结果为空而免于计算的运算对象数
+} SetExprResult;
+
+// 函数声明
+int set_expr_evaluate(const char *expression, SetExprResolver resolver, void *user_data,
+                      Arena *arena, int threads, SetExprResult *result,
+                      char *plan, size_t plan_size, char *error, size_t error_size);
+
+#endif
@@ -0,0 +1,370 @@
+#include "set_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// 写文件时打包缓冲区的大小（字节）
+#define PACK_BUFFER_SIZE (1 << 20)
+
+// 记录错误信息
+static void set_error(char *error, size_t error_size, const char *format, ...) {
+    if (!error || error_size == 0) return;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error, error_size, format, args);
+    va_end(args);
+}
+
+// 表示x所需的位数，x为0时返回0
+static inline uint32_t bit_width(uint32_t x) {
+    return x ? 32 - (uint32_t)__builtin_clz(x) : 0;
+}
+
+// 块内n个元素打包后的字节数（第一个元素存于索引中）
+static inline size_t packed_bytes(uint32_t count, uint32_t width) {
+    return ((size_t)(count - 1) * width + 7) / 8;
+}
+
+// 带缓冲的位打包输出
+typedef struct {
+    FILE *file;
+    unsigned char *buffer;
+    size_t used;
+    uint64_t acc;           // 尚未写出的位
+    uint32_t acc_bits;
+    uint64_t written;       // 已打包的总字节数（含缓冲区中的）
+} BitWriter;
+
+static int writer_flush(BitWriter *w) {
+    if (w->used && fwrite(w->buffer, 1, w->used, w->file) != w->used) return -1;
+    w->used = 0;
+    return 0;
+}
+
+static inline int writer_byte(BitWriter *w, unsigned char byte) {
+    if (w->used == PACK_BUFFER_SIZE && writer_flush(w) != 0) return -1;
+    w->buffer[w->used++] = byte;
+    w->written++;
+    return 0;
+}
+
+static inline int writer_bits(BitWriter *w, uint32_t value, uint32_t width) {
+    w->acc |= (uint64_t)value << w->acc_bits;
+    w->acc_bits += width;
+    while (w->acc_bits >= 8) {
+        if (writer_byte(w, (unsigned char)w->acc) != 0) return -1;
+        w->acc >>= 8;
+        w->acc_bits -= 8;
+    }
+    return 0;
+}
+
+// 块结束时把不足一个字节的剩余位补齐写出
+static inline int writer_align(BitWriter *w) {
+    if (w->acc_bits && writer_byte(w, (unsigned char)w->acc) != 0) return -1;
+    w->acc = 0;
+    w->acc_bits = 0;
+    return 0;
+}
+
+/**
+ * 把有序集合保存为二进制集合文件
+ * 参数：
+ *   path: 输出文件路径
+ *   values, count: 升序且无重复的集合
+ *   file_size: 输出文件字节数，可为NULL
+ *   error, error_size: 失败时的错误信息
+ * 返回值：
+ *   成功返回0，失败返回-1
+ * 算法原理：
+ * 1. 每块的位宽取块内最大差值的位数，稠密区间的位宽很小，连续ID区间位宽为0
+ * 2. 块索引在数据写完后才确定，因此先写占位的头部与索引，最后回填
+ * 说明：
+ * 先写到同目录的path.partial，成功后改名为path。写入失败时原文件保持不变；
+ * path正被映射（保存回刚加载的文件）时，改名不影响已有的映射
+ */
+int set_file_save(const char *path, const int *values, int count, size_t *file_size,
+                  char *error, size_t error_size) {
+    size_t block_count = ((size_t)count + SET_FILE_BLOCK_VALUES - 1) / SET_FILE_BLOCK_VALUES;
+    SetFileBlock *blocks = calloc(block_count ? block_count : 1, sizeof(SetFileBlock));
+    unsigned char *buffer = malloc(PACK_BUFFER_SIZE);
+    if (!blocks || !buffer) {
+        free(blocks);
+        free(buffer);
+        set_error(error, error_size, "内存分配失败");
+        return -1;
+    }
+
+    size_t path_length = strlen(path);
+    char *temp_path = malloc(path_length + sizeof(".partial"));
+    if (!temp_path) {
+        free(blocks);
+        free(buffer);
+        set_error(error, error_size, "内存分配失败");
+        return -1;
+    }
+    memcpy(temp_path, path, path_length);
+    memcpy(temp_path + path_length, ".partial", sizeof(".partial"));
+
+    FILE *file = fopen(temp_path, "wb");
+    if (!file) {
+        set_error(error, error_size, "无法创建文件 %s：%s", temp_path, strerror(errno));
+        free(temp_path);
+        free(blocks);
+        free(buffer);
+        return -1;
+    }
+
+    SetFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SET_FILE_MAGIC, sizeof(header.magic));
+    header.byte_order = SET_FILE_BYTE_ORDER;
+    header.block_values = SET_FILE_BLOCK_VALUES;
+    header.count = (uint64_t)count;
+    header.block_count = block_count;
+
+    BitWriter writer = { .file = file, .buffer = buffer };
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (block_count == 0 || fwrite(blocks, sizeof(SetFileBlock), block_count, file) == block_count);
+
+    for (size_t b = 0; ok && b < block_count; b++) {
+        size_t start = b * SET_FILE_BLOCK_VALUES;
+        size_t end = start + SET_FILE_BLOCK_VALUES < (size_t)count ? start + SET_FILE_BLOCK_VALUES : (size_t)count;
+
+        // 严格递增，相邻差值减1后落在[0, 2^32-2]
+        uint32_t max_delta = 0;
+        for (size_t i = start + 1; i < end; i++) {
+            uint32_t delta = (uint32_t)values[i] - (uint32_t)values[i - 1] - 1;
+            if (delta > max_delta) max_delta = delta;
+        }
+
+        SetFileBlock *block = &blocks[b];
+        block->min = values[start];
+        block->max = values[end - 1];
+        block->count = (uint32_t)(end - start);
+        block->width = bit_width(max_delta);
+        block->offset = writer.written;
+
+        if (block->width) {
+            for (size_t i = start + 1; ok && i < end; i++) {
+                uint32_t delta = (uint32_t)values[i] - (uint32_t)values[i - 1] - 1;
+                ok = writer_bits(&writer, delta, block->width) == 0;
+            }
+            ok = ok && writer_align(&writer) == 0;
+        }
+    }
+
+    for (int i = 0; ok && i < SET_FILE_PADDING; i++) {
+        ok = writer_byte(&writer, 0) == 0;
+    }
+    ok = ok && writer_flush(&writer) == 0;
+
+    // 回填块索引
+    ok = ok && fseek(file, (long)sizeof(header), SEEK_SET) == 0 &&
+         (block_count == 0 || fwrite(blocks, sizeof(SetFileBlock), block_count, file) == block_count);
+    if (fclose(file) != 0) ok = false;
+
+    if (!ok) {
+        set_error(error, error_size, "写入文件 %s 失败：%s", temp_path, strerror(errno));
+    } else if (rename(temp_path, path) != 0) {
+        set_error(error, error_size, "无法写入文件 %s：%s", path, strerror(errno));
+        ok = false;
+    } else if (file_size) {
+        *file_size = sizeof(header) + block_count * sizeof(SetFileBlock) + (size_t)writer.written;
+    }
+    // 不留下写了一半的临时文件
+    if (!ok) {
+        remove(temp_path);
+    }
+    free(temp_path);
+    free(blocks);
+    free(buffer);
+    return ok ? 0 : -1;
+}
+
+// 检查索引与文件大小是否一致，损坏或截断的文件在映射后立即拒绝
+static bool validate_index(const SetFile *file, const SetFileHeader *header, size_t data_size) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < file->block_count; b++) {
+        const SetFileBlock *block = &file->blocks[b];
+        if (block->count == 0 || block->count > header->block_values || block->width > 32 ||
+            block->min > block->max || (b > 0 && file->blocks[b - 1].max >= block->min)) {
+            return false;
+        }
+        if (block->offset > data_size - SET_FILE_PADDING ||
+            packed_bytes(block->count, block->width) > data_size - SET_FILE_PADDING - block->offset) {
+            return false;
+        }
+        total += block->count;
+    }
+    return total == header->count;
+}
+
+/**
+ * 打开二进制集合文件
+ * 参数：
+ *   file: 输出的映射
+ *   path: 文件路径
+ *   error, error_size: 失败时的错误信息
+ * 返回值：
+ *   成功返回0，失败返回-1
+ * 说明：
+ * 文件以只读方式整体映射，打开时只检查头部与索引，不解码任何数据
+ */
+int set_file_open(SetFile *file, const char *path, char *error, size_t error_size) {
+    memset(file, 0, sizeof(*file));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        set_error(error, error_size, "无法打开文件 %s：%s", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SetFileHeader) + SET_FILE_PADDING) {
+        close(fd);
+        set_error(error, error_size, "%s 不是有效的二进制集合文件", path);
+        return -1;
+    }
+
+    void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        set_error(error, error_size, "无法映射文件 %s：%s", path, strerror(errno));
+        return -1;
+    }
+    file->map = addr;
+    file->map_size = (size_t)st.st_size;
+
+    const SetFileHeader *header = addr;
+    size_t max_blocks = (file->map_size - sizeof(SetFileHeader)) / sizeof(SetFileBlock);
+    if (memcmp(header->magic, SET_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->byte_order != SET_FILE_BYTE_ORDER || header->block_values == 0 ||
+        header->block_count > max_blocks || header->count > (uint64_t)INT32_MAX) {
+        set_file_close(file);
+        set_error(error, error_size, "%s 不是有效的二进制集合文件或字节序不一致", path);
+        return -1;
+    }
+
+    size_t index_end = sizeof(SetFileHeader) + (size_t)header->block_count * sizeof(SetFileBlock);
+    file->blocks = (const SetFileBlock*)(file->map + sizeof(SetFileHeader));
+    file->block_count = (size_t)header->block_count;
+    file->data = file->map + index_end;
+    file->count = (long long)header->count;
+
+    if (file->map_size - index_end < SET_FILE_PADDING ||
+        !validate_index(file, header, file->map_size - index_end)) {
+        set_file_close(file);
+        set_error(error, error_size, "二进制集合文件 %s 已损坏", path);
+        return -1;
+    }
+
+    madvise(addr, file->map_size, MADV_WILLNEED);
+    return 0;
+}
+
+void set_file_close(SetFile *file) {
+    if (file->map) {
+        munmap((void*)file->map, file->map_size);
+    }
+    memset(file, 0, sizeof(*file));
+}
+
+/**
+ * 解码一块
+ * 参数：
+ *   file: 已打开的集合文件
+ *   block: 块下标
+ *   out: 输出数组，容量至少为该块的count
+ * 返回值：
+ *   解码出的元素个数
+ * 算法原理：
+ * 第j个差值从第j*width位开始，按64位读取后移位、屏蔽即可取出（width<=32，
+ * 移位不超过7位，一次读取总能覆盖完整的差值）；元素由差值前缀和恢复
+ */
+int set_file_decode_block(const SetFile *file, size_t block, int *out) {
+    const SetFileBlock *b = &file->blocks[block];
+    const unsigned char *p = file->data + b->offset;
+    uint32_t width = b->width;
+    uint32_t n = b->count;
+    uint32_t value = (uint32_t)b->min;
+
+    out[0] = (int)value;
+    if (width == 0) {
+        for (uint32_t j = 1; j < n; j++) {
+            out[j] = (int)(value + j);
+        }
+        return (int)n;
+    }
+
+    uint64_t mask = (width == 32) ? 0xFFFFFFFFULL : ((1ULL << width) - 1);
+    size_t bit = 0;
+    for (uint32_t j = 1; j < n; j++, bit += width) {
+        uint64_t word;
+        memcpy(&word, p + (bit >> 3), sizeof(word));
+        value += (uint32_t)((word >> (bit & 7)) & mask) + 1;
+        out[j] = (int)value;
+    }
+    return (int)n;
+}
+
+// 第一个max >= lo的块
+static size_t first_block(const SetFile *file, int lo) {
+    size_t left = 0, right = file->block_count;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (file->blocks[mid].max < lo) left = mid + 1;
+        else right = mid;
+    }
+    return left;
+}
+
+// 解码[lo, hi]所需的输出容量：与区间相交的块的元素个数之和
+long long set_file_range_capacity(const SetFile *file, int lo, int hi) {
+    long long total = 0;
+    for (size_t b = first_block(file, lo); b < file->block_count && file->blocks[b].min <= hi; b++) {
+        total += file->blocks[b].count;
+    }
+    return total;
+}
+
+/**
+ * 解码值域[lo, hi]内的元素
+ * 参数：
+ *   file: 已打开的集合文件
+ *   lo, hi: 值域（闭区间）
+ *   out: 输出数组，容量至少为set_file_range_capacity(file, lo, hi)
+ * 返回值：
+ *   解码出的元素个数，结果升序
+ * 算法原理：
+ * 按块索引二分找到第一个相交的块，只解码与区间相交的块；
+ * 完全落在区间内的块整块保留，两端的块再按值裁剪
+ */
+long long set_file_decode_range(const SetFile *file, int lo, int hi, int *out) {
+    long long size = 0;
+    for (size_t b = first_block(file, lo); b < file->block_count && file->blocks[b].min <= hi; b++) {
+        const SetFileBlock *block = &file->blocks[b];
+        int n = set_file_decode_block(file, b, out + size);
+        if (block->min >= lo && block->max <= hi) {
+            size += n;
+            continue;
+        }
+
+        int *values = out + size;
+        int kept = 0;
+        for (int i = 0; i < n; i++) {
+            if (values[i] >= lo && values[i] <= hi) {
+                values[kept++] = values[i];
+            }
+        }
+        size += kept;
+    }
+    return size;
+}
@@ -0,0 +1,55 @@
+#ifndef SET_FILE_H
+#define SET_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * 二进制集合文件格式（本机字节序）：
+ *   SetFileHeader | SetFileBlock[block_count] | 数据区
+ * 集合升序且无重复，每SET_FILE_BLOCK_VALUES个元素为一块。块的第一个元素即索引中的min，
+ * 其余元素与前一元素之差减1按块内统一的位宽紧密打包；数据区末尾补8个零字节，
+ * 解码时可以无条件按64位读取
+ */
+#define SET_FILE_MAGIC "INTSET1"
+#define SET_FILE_BYTE_ORDER 0x01020304U
+#define SET_FILE_BLOCK_VALUES 256
+#define SET_FILE_PADDING 8
+
+typedef struct {
+    char magic[8];
+    uint32_t byte_order;    // 写入端的字节序标记，读取端不一致时拒绝
+    uint32_t block_values;  // 每块的最大元素个数
+    uint64_t count;         // 元素总数
+    uint64_t block_count;
+} SetFileHeader;
+
+// 块索引：加载和运算时按[min, max]跳过不相交的块
+typedef struct {
+    int32_t min;
+    int32_t max;
+    uint32_t count;
+    uint32_t width;         // 差值的位宽（0~32），0表示块内元素连续
+    uint64_t offset;        // 打包数据相对数据区起点的字节偏移
+} SetFileBlock;
+
+// 以mmap只读映射的集合文件
+typedef struct {
+    const unsigned char *map;
+    size_t map_size;
+    const SetFileBlock *blocks;
+    size_t block_count;
+    const unsigned char *data;
+    long long count;
+} SetFile;
+
+// 函数声明
+int set_file_save(const char *path, const int *values, int count, size_t *file_size,
+                  char *error, size_t error_size);
+int set_file_open(SetFile *file, const char *path, char *error, size_t error_size);
+void set_file_close(SetFile *file);
+int set_file_decode_block(const SetFile *file, size_t block, int *out);
+long long set_file_range_capacity(const SetFile *file, int lo, int hi);
+long long set_file_decode_range(const SetFile *file, int lo, int hi, int *out);
+
+#endif
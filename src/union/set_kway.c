@@ -0,0 +1,89 @@
+#include "set_kway.h"
+#include "../utils/loser_tree.h"
+#include <stdlib.h>
+
+/**
+ * K路运算结果数组所需的容量
+ * 参数：
+ *   sizes: 各集合的元素个数
+ *   k: 集合个数
+ *   threshold: 至少出现的集合数t
+ * 返回值：
+ *   结果元素个数的上界：每个结果元素至少消耗t个输入元素，
+ *   并且t=k时不超过最小集合的大小
+ */
+size_t set_kway_capacity(const int *sizes, int k, int threshold) {
+    size_t total = 0;
+    size_t smallest = k > 0 ? (size_t)sizes[0] : 0;
+    for (int i = 0; i < k; i++) {
+        total += (size_t)sizes[i];
+        if ((size_t)sizes[i] < smallest) smallest = (size_t)sizes[i];
+    }
+    if (threshold <= 1) return total;
+    if (threshold >= k) return smallest;
+    return total / (size_t)threshold;
+}
+
+/**
+ * K个有序集合的“至少出现在t个集合中”运算
+ * 参数：
+ *   sets: K个升序且去重的集合
+ *   sizes: 各集合的元素个数
+ *   k: 集合个数
+ *   threshold: t，t=1为并集，t=k为交集
+ *   out: 结果数组，容量不小于set_kway_capacity的返回值
+ * 返回值：
+ *   结果元素个数；内存不足返回-1
+ * 算法原理：
+ * 1. 用败者树对K个集合做一次多路归并，每取出一个元素只需log2(K)次比较
+ * 2. 败者树按值输出，相同的值来自不同集合并连续出现，
+ *    因此连续相同的个数就是该值出现在多少个集合中
+ * 3. 剩余未取完的集合少于t个时，后面的值不可能再满足条件，提前结束
+ * 时间复杂度：O(N log K)，N为所有集合的元素总数
+ */
+int set_kway_threshold(const int *const *sets, const int *sizes, int k, int threshold, int *out) {
+    if (k <= 0) return 0;
+    if (threshold < 1) threshold = 1;
+    if (threshold > k) return 0;
+
+    LoserTree lt;
+    if (!loser_tree_init(&lt, k)) return -1;
+
+    size_t *pos = calloc((size_t)k, sizeof(size_t));
+    if (!pos) {
+        loser_tree_free(&lt);
+        return -1;
+    }
+
+    for (int i = 0; i < k; i++) {
+        if (sizes[i] > 0) {
+            loser_tree_set(&lt, i, sets[i][0]);
+        }
+    }
+    loser_tree_build(&lt);
+
+    int out_size = 0;
+    while (lt.active >= threshold) {
+        long long value = loser_tree_top(&lt);
+        int count = 0;
+
+        // 取出所有等于value的元素，每个集合至多一个
+        int source;
+        while ((source = loser_tree_winner(&lt)) != -1 && loser_tree_top(&lt) == value) {
+            count++;
+            if (++pos[source] < (size_t)sizes[source]) {
+                loser_tree_replace(&lt, sets[source][pos[source]]);
+            } else {
+                loser_tree_pop(&lt);
+            }
+        }
+
+        if (count >= threshold) {
+            out[out_size++] = (int)value;
+        }
+    }
+
+    free(pos);
+    loser_tree_free(&lt);
+    return out_size;
+}
@@ -0,0 +1,10 @@
+#ifndef SET_KWAY_H
+#define SET_KWAY_H
+
+#include <stddef.h>
+
+// 函数声明
+size_t set_kway_capacity(const int *sizes, int k, int threshold);
+int set_kway_threshold(const int *const *sets, const int *sizes, int k, int threshold, int *out);
+
+#endif
@@ -0,0 +1,183 @@
+#include "set_merge.h"
+#include "../sorting/sorting.h"
+#include "simd_intersect.h"
+#include <string.h>
+
+/**
+ * 排序并去除重复元素
+ * 参数：
+ *   arr: 要处理的数组，结果原地写回
+ *   size: 数组大小
+ * 返回值：
+ *   去重后的元素个数
+ * 时间复杂度：O(n log n)
+ */
+int sort_unique(int *arr, int size) {
+    if (size <= 1) return size;
+
+    sort_array(arr, size);
+    int count = 1;
+    for (int i = 1; i < size; i++) {
+        if (arr[i] != arr[count - 1]) {
+            arr[count++] = arr[i];
+        }
+    }
+    return count;
+}
+
+// 向输出数组追加单个元素，out为NULL时忽略
+static inline void emit(int *out, int *size, int value) {
+    if (out) {
+        out[(*size)++] = value;
+    }
+}
+
+// 向输出数组批量追加一段连续元素，out为NULL时忽略
+static inline void emit_run(int *out, int *size, const int *src, int n) {
+    if (out && n > 0) {
+        memcpy(out + *size, src, (size_t)n * sizeof(int));
+        *size += n;
+    }
+}
+
+/**
+ * 在有序数组中倍增查找第一个不小于value的位置
+ * 参数：
+ *   arr, size: 有序数组
+ *   from: 查找起点
+ *   value: 目标值
+ * 返回值：
+ *   下标 k，满足 arr[from..k) < value <= arr[k..)
+ * 算法原理：
+ * 先以1,2,4,...的步长向前跳跃确定区间，再在区间内二分，
+ * 代价为O(log d)，d为与起点的距离
+ */
+static int gallop_lower_bound(const int *arr, int size, int from, int value) {
+    int step = 1;
+    int lo = from, hi = from;
+    while (hi < size && arr[hi] < value) {
+        lo = hi + 1;
+        hi += step;
+        step <<= 1;
+    }
+    if (hi > size) hi = size;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (arr[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * 小集合对大集合的倍增归并
+ * 参数：
+ *   small, ns: 元素较少的一侧
+ *   large, nl: 元素较多的一侧
+ *   small_only, small_only_size: 只属于小集合的元素输出
+ *   large_only, large_only_size: 只属于大集合的元素输出
+ *   res: 并集、交集、对称差输出
+ * 算法原理：
+ * 对小集合的每个元素在大集合中倍增查找，跳过的大集合区间整段复制，
+ * 代价为O(ns·log(nl/ns))，外加输出本身的长度
+ */
+static void gallop_merge(const int *small, int ns, const int *large, int nl,
+                         int *small_only, int *small_only_size,
+                         int *large_only, int *large_only_size,
+                         SetMergeResult *res) {
+    int j = 0;
+    for (int i = 0; i < ns; i++) {
+        int value = small[i];
+        int k = gallop_lower_bound(large, nl, j, value);
+
+        emit_run(res->union_out, &res->union_size, large + j, k - j);
+        emit_run(res->sym_diff_out, &res->sym_diff_size, large + j, k - j);
+        emit_run(large_only, large_only_size, large + j, k - j);
+        j = k;
+
+        emit(res->union_out, &res->union_size, value);
+        if (j < nl && large[j] == value) {
+            emit(res->intersection_out, &res->intersection_size, value);
+            j++;
+        } else {
+            emit(res->sym_diff_out, &res->sym_diff_size, value);
+            emit(small_only, small_only_size, value);
+        }
+    }
+
+    emit_run(res->union_out, &res->union_size, large + j, nl - j);
+    emit_run(res->sym_diff_out, &res->sym_diff_size, large + j, nl - j);
+    emit_run(large_only, large_only_size, large + j, nl - j);
+}
+
+/**
+ * 一次归并同时计算并集、交集、A-B、B-A与对称差
+ * 参数：
+ *   a, na: 有序且无重复的集合A（可先调用sort_unique）
+ *   b, nb: 有序且无重复的集合B
+ *   res: 输出结构，为NULL的输出数组会被跳过
+ * 算法原理：
+ * 1. 两侧规模相近时使用双指针线性归并，每个元素只比较一次
+ * 2. 一侧规模远小于另一侧时改用倍增查找，避免逐个扫描大集合
+ * 3. 只需要交集且规模相近时，交给SIMD求交内核
+ * 4. 输出按归并顺序产生，天然有序，无需再排序
+ * 时间复杂度：O(n+m)；不对称时为O(min·log(max/min))加输出长度
+ */
+void set_merge(const int *a, int na, const int *b, int nb, SetMergeResult *res) {
+    res->union_size = 0;
+    res->intersection_size = 0;
+    res->a_minus_b_size = 0;
+    res->b_minus_a_size = 0;
+    res->sym_diff_size = 0;
+
+    if ((long long)na * SET_GALLOP_RATIO <= nb) {
+        gallop_merge(a, na, b, nb,
+                     res->a_minus_b_out, &res->a_minus_b_size,
+                     res->b_minus_a_out, &res->b_minus_a_size, res);
+        return;
+    }
+    if ((long long)nb * SET_GALLOP_RATIO <= na) {
+        gallop_merge(b, nb, a, na,
+                     res->b_minus_a_out, &res->b_minus_a_size,
+                     res->a_minus_b_out, &res->a_minus_b_size, res);
+        return;
+    }
+
+    if (res->intersection_out && !res->union_out && !res->a_minus_b_out &&
+        !res->b_minus_a_out && !res->sym_diff_out) {
+        res->intersection_size = simd_intersect(a, na, b, nb, res->intersection_out);
+        return;
+    }
+
+    int i = 0, j = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            emit(res->union_out, &res->union_size, a[i]);
+            emit(res->a_minus_b_out, &res->a_minus_b_size, a[i]);
+            emit(res->sym_diff_out, &res->sym_diff_size, a[i]);
+            i++;
+        } else if (a[i] > b[j]) {
+            emit(res->union_out, &res->union_size, b[j]);
+            emit(res->b_minus_a_out, &res->b_minus_a_size, b[j]);
+            emit(res->sym_diff_out, &res->sym_diff_size, b[j]);
+            j++;
+        } else {
+            emit(res->union_out, &res->union_size, a[i]);
+            emit(res->intersection_out, &res->intersection_size, a[i]);
+            i++;
+            j++;
+        }
+    }
+
+    // 剩余部分只属于其中一个集合
+    emit_run(res->union_out, &res->union_size, a + i, na - i);
+    emit_run(res->a_minus_b_out, &res->a_minus_b_size, a + i, na - i);
+    emit_run(res->sym_diff_out, &res->sym_diff_size, a + i, na - i);
+    emit_run(res->union_out, &res->union_size, b + j, nb - j);
+    emit_run(res->b_minus_a_out, &res->b_minus_a_size, b + j, nb - j);
+    emit_run(res->sym_diff_out, &res->sym_diff_size, b + j, nb - j);
+}
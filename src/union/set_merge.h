@@ -0,0 +1,27 @@
+#ifndef SET_MERGE_H
+#define SET_MERGE_H
+
+// 有序集合归并运算的结果
+// 每个输出数组由调用者提供，传入NULL表示不需要该结果
+// 容量要求：union/sym_diff >= na+nb，intersection <= min(na,nb)，a_minus_b >= na，b_minus_a >= nb
+typedef struct {
+    int *union_out;
+    int union_size;
+    int *intersection_out;
+    int intersection_size;
+    int *a_minus_b_out;
+    int a_minus_b_size;
+    int *b_minus_a_out;
+    int b_minus_a_size;
+    int *sym_diff_out;
+    int sym_diff_size;
+} SetMergeResult;
+
+// 当一侧元素个数是另一侧的 SET_GALLOP_RATIO 倍以上时改用倍增（galloping）查找
+#define SET_GALLOP_RATIO 16
+
+// 函数声明
+int sort_unique(int *arr, int size);
+void set_merge(const int *a, int na, const int *b, int nb, SetMergeResult *res);
+
+#endif
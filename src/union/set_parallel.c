@@ -0,0 +1,162 @@
+#include "set_parallel.h"
+#include "../sorting/sort_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// 一个值域分区：两个输入各自的下标区间，以及各输出在全局数组中的起始位置
+typedef struct {
+    const int *a;
+    int na;
+    const int *b;
+    int nb;
+    SetMergeResult partial;     // 输出指针指向全局数组中本分区的起点
+} Partition;
+
+// 本机可用的处理器个数
+int set_parallel_default_threads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    if (cpus > SET_PARALLEL_MAX_THREADS) return SET_PARALLEL_MAX_THREADS;
+    return (int)cpus;
+}
+
+// 第一个不小于value的元素下标
+static int lower_bound(const int *arr, int size, int value) {
+    int lo = 0, hi = size;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (arr[mid] < value) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * 通过抽样选出partitions-1个分割值
+ * 算法原理：
+ * 两个输入均已有序，等间隔取下标即为均匀抽样；样本排序后取分位点，
+ * 使每个分区包含的两侧元素总数大致相等
+ */
+static bool choose_splitters(const int *a, int na, const int *b, int nb,
+                             int partitions, int *splitters) {
+    int per_side = partitions * SET_PARALLEL_SAMPLES;
+    int *samples = malloc(2 * (size_t)per_side * sizeof(int));
+    if (!samples) return false;
+
+    int count = 0;
+    for (int i = 0; i < per_side; i++) {
+        if (na > 0) samples[count++] = a[(long long)na * i / per_side];
+        if (nb > 0) samples[count++] = b[(long long)nb * i / per_side];
+    }
+    sort_i32(samples, (size_t)count);
+
+    for (int p = 1; p < partitions; p++) {
+        splitters[p - 1] = samples[(long long)count * p / partitions];
+    }
+    free(samples);
+    return true;
+}
+
+static void* partition_worker(void *arg) {
+    Partition *part = arg;
+    set_merge(part->a, part->na, part->b, part->nb, &part->partial);
+    return NULL;
+}
+
+// 把一个分区的输出前移到已拼接部分之后；目标位置不晚于源位置，因此可以原地移动
+static void append_partial(int *out, int *total, const int *src, int size) {
+    if (!out) return;
+    if (src != out + *total) {
+        memmove(out + *total, src, (size_t)size * sizeof(int));
+    }
+    *total += size;
+}
+
+/**
+ * 多线程集合归并
+ * 参数：
+ *   a, na, b, nb: 两个升序且去重的集合
+ *   res: 输出，要求同set_merge
+ *   threads: 线程数，小于等于1或输入较小时退化为单线程set_merge
+ * 算法原理：
+ * 1. 抽样确定分割值，把值域切成threads段，每段在两个输入中对应一个连续区间
+ * 2. 各段值域互不相交，可以独立归并；每段的输出直接写到全局数组中
+ *    不会与其他段重叠的位置（按该段输入的起始下标计算），无需额外缓冲
+ * 3. 所有线程结束后按段顺序把输出前移拼接，得到整体有序的结果
+ * 时间复杂度：O((n+m)/threads + threads·log(n+m))，外加一次O(n+m)的拼接
+ */
+void set_merge_parallel(const int *a, int na, const int *b, int nb, SetMergeResult *res, int threads) {
+    if (threads > SET_PARALLEL_MAX_THREADS) threads = SET_PARALLEL_MAX_THREADS;
+    if (threads <= 1 || (long long)na + nb < SET_PARALLEL_MIN_SIZE) {
+        set_merge(a, na, b, nb, res);
+        return;
+    }
+
+    int splitters[SET_PARALLEL_MAX_THREADS];
+    Partition parts[SET_PARALLEL_MAX_THREADS];
+    pthread_t workers[SET_PARALLEL_MAX_THREADS];
+    bool started[SET_PARALLEL_MAX_THREADS];
+
+    if (!choose_splitters(a, na, b, nb, threads, splitters)) {
+        set_merge(a, na, b, nb, res);
+        return;
+    }
+
+    // 交集不会超过较小一侧的元素个数，按较小一侧的起始下标放置
+    bool a_smaller = na <= nb;
+    int a_start = 0, b_start = 0;
+    for (int p = 0; p < threads; p++) {
+        int a_end = p + 1 < threads ? lower_bound(a, na, splitters[p]) : na;
+        int b_end = p + 1 < threads ? lower_bound(b, nb, splitters[p]) : nb;
+        if (a_end < a_start) a_end = a_start;
+        if (b_end < b_start) b_end = b_start;
+
+        Partition *part = &parts[p];
+        part->a = a + a_start;
+        part->na = a_end - a_start;
+        part->b = b + b_start;
+        part->nb = b_end - b_start;
+        memset(&part->partial, 0, sizeof(SetMergeResult));
+        if (res->union_out) part->partial.union_out = res->union_out + a_start + b_start;
+        if (res->sym_diff_out) part->partial.sym_diff_out = res->sym_diff_out + a_start + b_start;
+        if (res->a_minus_b_out) part->partial.a_minus_b_out = res->a_minus_b_out + a_start;
+        if (res->b_minus_a_out) part->partial.b_minus_a_out = res->b_minus_a_out + b_start;
+        if (res->intersection_out) {
+            part->partial.intersection_out = res->intersection_out + (a_smaller ? a_start : b_start);
+        }
+
+        a_start = a_end;
+        b_start = b_end;
+    }
+
+    // 第0段在当前线程上执行；线程创建失败的段也在当前线程上补做
+    for (int p = 1; p < threads; p++) {
+        started[p] = pthread_create(&workers[p], NULL, partition_worker, &parts[p]) == 0;
+    }
+    partition_worker(&parts[0]);
+    for (int p = 1; p < threads; p++) {
+        if (started[p]) {
+            pthread_join(workers[p], NULL);
+        } else {
+            partition_worker(&parts[p]);
+        }
+    }
+
+    res->union_size = 0;
+    res->intersection_size = 0;
+    res->a_minus_b_size = 0;
+    res->b_minus_a_size = 0;
+    res->sym_diff_size = 0;
+    for (int p = 0; p < threads; p++) {
+        const SetMergeResult *partial = &parts[p].partial;
+        append_partial(res->union_out, &res->union_size, partial->union_out, partial->union_size);
+        append_partial(res->intersection_out, &res->intersection_size,
+                       partial->intersection_out, partial->intersection_size);
+        append_partial(res->a_minus_b_out, &res->a_minus_b_size, partial->a_minus_b_out, partial->a_minus_b_size);
+        append_partial(res->b_minus_a_out, &res->b_minus_a_size, partial->b_minus_a_out, partial->b_minus_a_size);
+        append_partial(res->sym_diff_out, &res->sym_diff_size, partial->sym_diff_out, partial->sym_diff_size);
+    }
+}
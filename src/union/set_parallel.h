@@ -0,0 +1,17 @@
+#ifndef SET_PARALLEL_H
+#define SET_PARALLEL_H
+
+#include "set_merge.h"
+
+// 最多使用的工作线程数
+#define SET_PARALLEL_MAX_THREADS 64
+// 两个集合元素总数低于该值时不值得启动线程，直接单线程归并
+#define SET_PARALLEL_MIN_SIZE (1 << 16)
+// 每个分区从每个集合中抽取的样本数
+#define SET_PARALLEL_SAMPLES 32
+
+// 函数声明
+int set_parallel_default_threads(void);
+void set_merge_parallel(const int *a, int na, const int *b, int nb, SetMergeResult *res, int threads);
+
+#endif
@@ -0,0 +1,182 @@
+#include "set_sketch.h"
+#include "../sorting/sort_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// 95%置信区间对应的标准差倍数
+#define CONFIDENCE_Z 1.96
+
+// 64位混合哈希（splitmix64），HyperLogLog与MinHash共用
+static inline uint64_t sketch_hash(int value) {
+    uint64_t h = (uint64_t)(uint32_t)value + 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+void set_sketch_init(SetSketch *sketch) {
+    memset(sketch->hll.registers, 0, sizeof(sketch->hll.registers));
+    sketch->minhash.size = 0;
+    sketch->minhash.threshold = UINT64_MAX;
+    sketch->items = 0;
+}
+
+// 高PRECISION位选寄存器，其余位的前导零个数+1为秩（末尾补1保证秩有上界）
+static inline void hll_add(HyperLogLog *hll, uint64_t h) {
+    uint32_t index = (uint32_t)(h >> (64 - HLL_PRECISION));
+    uint64_t rest = (h << HLL_PRECISION) | (1ULL << (HLL_PRECISION - 1));
+    uint8_t rank = (uint8_t)(__builtin_clzll(rest) + 1);
+    if (rank > hll->registers[index]) {
+        hll->registers[index] = rank;
+    }
+}
+
+/**
+ * 估算HyperLogLog的基数
+ * 算法原理：
+ * 调和平均 E = alpha * m^2 / Σ2^(-M[j])；E较小且仍有空寄存器时
+ * 改用线性计数 m*ln(m/空寄存器数)，修正小基数下的偏差
+ */
+static double hll_estimate(const HyperLogLog *hll) {
+    double sum = 0.0;
+    int zeros = 0;
+    for (int j = 0; j < HLL_REGISTERS; j++) {
+        sum += ldexp(1.0, -hll->registers[j]);
+        zeros += hll->registers[j] == 0;
+    }
+
+    double m = HLL_REGISTERS;
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * log(m / zeros);
+    }
+    return estimate;
+}
+
+// 排序去重后只保留最小的k个，并更新丢弃阈值
+static void minhash_compact(MinHash *minhash) {
+    sort_u64(minhash->values, (size_t)minhash->size);
+    int k = 0;
+    for (int i = 0; i < minhash->size; i++) {
+        if (k == 0 || minhash->values[i] != minhash->values[k - 1]) {
+            minhash->values[k++] = minhash->values[i];
+        }
+    }
+    minhash->size = k < MINHASH_K ? k : MINHASH_K;
+    minhash->threshold = minhash->size == MINHASH_K ? minhash->values[MINHASH_K - 1] : UINT64_MAX;
+}
+
+// 候选区满2k个时压缩；已满k个后大部分哈希值不小于阈值，直接丢弃
+static inline void minhash_add(MinHash *minhash, uint64_t h) {
+    if (h >= minhash->threshold) return;
+    minhash->values[minhash->size++] = h;
+    if (minhash->size == 2 * MINHASH_K) {
+        minhash_compact(minhash);
+    }
+}
+
+/**
+ * 把一批元素加入草图
+ * 参数：
+ *   sketch: 草图
+ *   values, count: 元素（可以无序、可以重复）
+ * 说明：
+ * 每个元素只计算一次哈希，同时更新两种草图，重复元素不影响结果
+ */
+void set_sketch_add(SetSketch *sketch, const int *values, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t h = sketch_hash(values[i]);
+        hll_add(&sketch->hll, h);
+        minhash_add(&sketch->minhash, h);
+    }
+    sketch->items += (long long)count;
+}
+
+/**
+ * 把区间[lo, hi]中的全部元素加入草图
+ * 返回值：
+ *   区间长度超过SKETCH_RANGE_LIMIT时不做任何修改并返回false
+ * 说明：
+ * 每个元素都要单独哈希，“1-2000000000”这样的区间会耗费数秒；
+ * 区间很长时精确计算反而更快（区间列表的运算与区间长度无关）
+ */
+bool set_sketch_add_range(SetSketch *sketch, int lo, int hi) {
+    if ((long long)hi - lo + 1 > SKETCH_RANGE_LIMIT) {
+        return false;
+    }
+    for (long long v = lo; v <= hi; v++) {
+        uint64_t h = sketch_hash((int)v);
+        hll_add(&sketch->hll, h);
+        minhash_add(&sketch->minhash, h);
+    }
+    sketch->items += (long long)hi - lo + 1;
+    return true;
+}
+
+/**
+ * 由两个草图估算基数与相似度
+ * 参数：
+ *   a, b: 两个输入的草图（会先压缩，之后仍可继续加入元素）
+ *   out: 估算结果
+ * 算法原理：
+ * 1. 不同元素不超过k个的集合，MinHash保留了全部哈希值，基数精确
+ * 2. 否则|A|、|B|由各自的HyperLogLog估算；逐寄存器取最大值即得A∪B的草图
+ * 3. A∪B的最小k个哈希值可由两侧各自的最小k个归并得到，其中同时出现在
+ *    两侧的比例即Jaccard相似度的无偏估计；|A∩B| ≈ J * |A∪B|
+ */
+void set_sketch_estimate(SetSketch *a, SetSketch *b, SketchEstimate *out) {
+    minhash_compact(&a->minhash);
+    minhash_compact(&b->minhash);
+    const MinHash *ma = &a->minhash, *mb = &b->minhash;
+    bool full_a = ma->size == MINHASH_K, full_b = mb->size == MINHASH_K;
+    out->exact = !full_a && !full_b;
+
+    // 归并两侧的最小哈希值，取并集中最小的k个（都未满时取全部）
+    int i = 0, j = 0, considered = 0, common = 0;
+    int limit = out->exact ? ma->size + mb->size : MINHASH_K;
+    while (considered < limit && (i < ma->size || j < mb->size)) {
+        if (j == mb->size || (i < ma->size && ma->values[i] < mb->values[j])) {
+            i++;
+        } else if (i == ma->size || mb->values[j] < ma->values[i]) {
+            j++;
+        } else {
+            i++;
+            j++;
+            common++;
+        }
+        considered++;
+    }
+
+    double hll_error = CONFIDENCE_Z * 1.04 / sqrt((double)HLL_REGISTERS);
+    HyperLogLog merged;
+    for (int r = 0; r < HLL_REGISTERS; r++) {
+        uint8_t x = a->hll.registers[r], y = b->hll.registers[r];
+        merged.registers[r] = x > y ? x : y;
+    }
+
+    out->card_a = full_a ? hll_estimate(&a->hll) : ma->size;
+    out->card_b = full_b ? hll_estimate(&b->hll) : mb->size;
+    out->card_error_a = full_a ? out->card_a * hll_error : 0.0;
+    out->card_error_b = full_b ? out->card_b * hll_error : 0.0;
+
+    if (out->exact) {
+        out->card_union = considered;
+        out->card_intersection = common;
+        out->jaccard = considered ? (double)common / considered : 0.0;
+        out->union_error = out->intersection_error = out->jaccard_error = 0.0;
+        return;
+    }
+
+    double jaccard = (double)common / considered;
+    double variance = jaccard * (1.0 - jaccard);
+    out->jaccard = jaccard;
+    // J接近0或1时二项分布的正态近似失效，改用“三倍法则”给出上界
+    out->jaccard_error = variance * considered < 1.0 ? 3.0 / considered
+                                                    : CONFIDENCE_Z * sqrt(variance / considered);
+    out->card_union = hll_estimate(&merged);
+    out->union_error = out->card_union * hll_error;
+    out->card_intersection = jaccard * out->card_union;
+    out->intersection_error = out->jaccard_error * out->card_union + out->card_intersection * hll_error;
+}
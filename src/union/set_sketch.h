@@ -0,0 +1,56 @@
+#ifndef SET_SKETCH_H
+#define SET_SKETCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// HyperLogLog的精度：2^14个寄存器，相对标准误差约1.04/sqrt(2^14)=0.81%
+#define HLL_PRECISION 14
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+// MinHash（bottom-k）保留的最小哈希值个数，Jaccard估计的标准误差约sqrt(J(1-J)/k)
+#define MINHASH_K 1024
+
+// 逐个哈希的区间长度上限；更长的区间不进入草图，由调用者改用区间列表精确计算
+#define SKETCH_RANGE_LIMIT (1 << 16)
+
+// 基数草图：每个寄存器记录落入该桶的哈希值中前导零个数的最大值+1
+typedef struct {
+    uint8_t registers[HLL_REGISTERS];
+} HyperLogLog;
+
+// 相似度草图：保留全部哈希值中最小的k个（升序、无重复）
+typedef struct {
+    uint64_t values[2 * MINHASH_K];     // 前size个为候选，压缩后前kept个为当前最小的k个
+    int size;
+    uint64_t threshold;                 // 已满k个时的第k小值，不小于它的哈希值直接丢弃
+} MinHash;
+
+// 一个输入集合的草图，占用内存与集合大小无关
+typedef struct {
+    HyperLogLog hll;
+    MinHash minhash;
+    long long items;                    // 输入的元素个数（含重复）
+} SetSketch;
+
+// 两个草图的估算结果；误差均为95%置信区间的半宽
+typedef struct {
+    double card_a, card_b;
+    double card_union;
+    double card_intersection;
+    double jaccard;
+    double card_error_a, card_error_b;  // 绝对误差
+    double union_error;
+    double intersection_error;
+    double jaccard_error;
+    bool exact;                         // 两个集合都不超过k个不同元素，结果精确
+} SketchEstimate;
+
+// 函数声明
+void set_sketch_init(SetSketch *sketch);
+void set_sketch_add(SetSketch *sketch, const int *values, size_t count);
+bool set_sketch_add_range(SetSketch *sketch, int lo, int hi);
+void set_sketch_estimate(SetSketch *a, SetSketch *b, SketchEstimate *out);
+
+#endif
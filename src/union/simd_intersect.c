@@ -0,0 +1,151 @@
+#include "simd_intersect.h"
+#include <stddef.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+/**
+ * 标量求交
+ * 算法原理：
+ * 双指针归并，用比较结果直接推进下标，避免难以预测的分支。
+ * out[k]总是先写入，只有相等时k才前进；由于k < min(na,nb)在循环中恒成立，写入不会越界
+ */
+static int intersect_scalar(const int *a, int na, const int *b, int nb, int *out) {
+    int i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        int x = a[i], y = b[j];
+        out[k] = x;
+        k += (x == y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return k;
+}
+
+#ifdef HAVE_X86_SIMD
+
+/**
+ * SSE求交（4路shuffle-and-compare）
+ * 算法原理：
+ * 1. 各取A、B的4个元素，把B块循环移位3次，与A块共比较4次，
+ *    覆盖两块之间的全部16种配对
+ * 2. 比较结果的掩码指出A块中哪些元素在B块中出现
+ * 3. 比较两块的最大值，较小（或相等）的一侧前进4个元素
+ * 4. 剩余不足4个的部分交给标量内核
+ */
+static int intersect_sse(const int *a, int na, const int *b, int nb, int *out) {
+    int i = 0, j = 0, k = 0;
+    int na4 = na & ~3, nb4 = nb & ~3;
+
+    while (i < na4 && j < nb4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+
+        __m128i cmp = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(cmp));
+        while (mask) {
+            out[k++] = a[i + __builtin_ctz(mask)];
+            mask &= mask - 1;
+        }
+
+        int a_max = a[i + 3], b_max = b[j + 3];
+        i += (a_max <= b_max) ? 4 : 0;
+        j += (b_max <= a_max) ? 4 : 0;
+    }
+
+    return k + intersect_scalar(a + i, na - i, b + j, nb - j, out + k);
+}
+
+/**
+ * AVX2求交（8路shuffle-and-compare）
+ * 算法原理同SSE版本，块大小为8，B块通过permutevar8x32做7次循环移位
+ */
+__attribute__((target("avx2")))
+static int intersect_avx2(const int *a, int na, const int *b, int nb, int *out) {
+    int i = 0, j = 0, k = 0;
+    int na8 = na & ~7, nb8 = nb & ~7;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+    while (i < na8 && j < nb8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+
+        __m256i cmp = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            cmp = _mm256_or_si256(cmp, _mm256_cmpeq_epi32(va, vb));
+        }
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+        while (mask) {
+            out[k++] = a[i + __builtin_ctz(mask)];
+            mask &= mask - 1;
+        }
+
+        int a_max = a[i + 7], b_max = b[j + 7];
+        i += (a_max <= b_max) ? 8 : 0;
+        j += (b_max <= a_max) ? 8 : 0;
+    }
+
+    return k + intersect_sse(a + i, na - i, b + j, nb - j, out + k);
+}
+
+#endif
+
+/**
+ * 获取指定的内核
+ * 返回值：
+ *   当前CPU不支持该指令集时返回NULL
+ */
+IntersectKernel intersect_get_kernel(IntersectKernelId id) {
+    switch (id) {
+        case INTERSECT_SCALAR:
+            return intersect_scalar;
+#ifdef HAVE_X86_SIMD
+        case INTERSECT_SSE:
+            return intersect_sse;
+        case INTERSECT_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? intersect_avx2 : NULL;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+// 内核名称，用于性能报告
+const char* intersect_kernel_name(IntersectKernelId id) {
+    switch (id) {
+        case INTERSECT_SCALAR: return "标量";
+        case INTERSECT_SSE:    return "SSE";
+        case INTERSECT_AVX2:   return "AVX2";
+        default:               return "未知";
+    }
+}
+
+/**
+ * 使用当前CPU支持的最快内核求交
+ * 算法原理：
+ * 首次调用时按 AVX2 > SSE > 标量 的顺序检测并缓存内核指针
+ */
+static IntersectKernel best_kernel = NULL;
+
+// 选出当前CPU支持的最快内核
+static void select_best_kernel(void) {
+    for (int id = INTERSECT_KERNEL_COUNT - 1; id >= 0 && !best_kernel; id--) {
+        best_kernel = intersect_get_kernel((IntersectKernelId)id);
+    }
+}
+
+int simd_intersect(const int *a, int na, const int *b, int nb, int *out) {
+    // 并行归并会在多个线程中同时调用，内核选择只做一次
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, select_best_kernel);
+    return best_kernel(a, na, b, nb, out);
+}
@@ -0,0 +1,21 @@
+#ifndef SIMD_INTERSECT_H
+#define SIMD_INTERSECT_H
+
+// 有序集合求交内核：输入为严格递增的int数组，返回交集元素个数
+// 输出数组容量至少为 min(na, nb)
+typedef int (*IntersectKernel)(const int *a, int na, const int *b, int nb, int *out);
+
+// 可用的内核实现
+typedef enum {
+    INTERSECT_SCALAR,
+    INTERSECT_SSE,
+    INTERSECT_AVX2,
+    INTERSECT_KERNEL_COUNT
+} IntersectKernelId;
+
+// 函数声明
+IntersectKernel intersect_get_kernel(IntersectKernelId id);
+const char* intersect_kernel_name(IntersectKernelId id);
+int simd_intersect(const int *a, int na, const int *b, int nb, int *out);
+
+#endif
@@ -1,10 +1,32 @@
 #include "union.h"
 #include "../utils/error_handler.h"
+#include "../utils/arena.h"
+#include "../utils/int_vec.h"
+#include "../utils/int_parser.h"
+#include "../utils/int_format.h"
+#include "../utils/xxhash.h"
+#include "../utils/string_pool.h"
+#include "../utils/background_task.h"
+#include "../utils/file_chooser.h"
 #include "../sorting/sorting.h"
+#include "set_merge.h"
+#include "set_kway.h"
+#include "set_parallel.h"
+#include "bloom_filter.h"
+#include "roaring.h"
+#include "set_bench.h"
+#include "external_set.h"
+#include "live_sets.h"
+#include "set_cache.h"
+#include "set_file.h"
+#include "interval_set.h"
+#include "set_sketch.h"
+#include "set_expr.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <limits.h>
 
 // 定义全局GUI组件变量
 // 这些变量在整个模块中共享，用于用户交互
@@ -12,386 +34,2145 @@ GtkWidget *text_view_input1;  // 第一个集合的输入文本框
 GtkWidget *text_view_input2;  // 第二个集合的输入文本框
 GtkWidget *text_view_output;  // 结果输出文本框
 
-// 定义静态变量
-// result数组用于存储集合运算的结果
-static int result[MAX_SET_SIZE];
+// 大文件模式的控件
+static GtkWidget *file_chooser_a;
+static GtkWidget *file_chooser_b;
+static GtkWidget *file_format_combo;
+static GtkWidget *file_op_combo;
+
+// 并行归并使用的线程数
+static GtkWidget *thread_spin;
+
+// 布隆过滤：在较大的输入上建立过滤器，输入未修改时在多次运算之间复用
+static GtkWidget *bloom_check;
+static GtkWidget *stats_label;          // 布隆过滤统计或缓存命中提示
+static BloomFilter cached_filter;
+static int cached_filter_input = -1;    // 过滤器所属的输入（0或1），-1表示没有可用的过滤器
+static size_t cached_filter_size;       // 建立过滤器时该输入的元素个数
+static uint64_t cached_filter_hash;     // 建立过滤器时集合内容的XXH64哈希
+
+// 结果缓存：以两个输入文本的XXH64哈希为键，缓存解析后的集合与运算结果
+static uint64_t input_keys[2];
+static bool input_keys_valid = false;   // 实时模式或载入二进制文件时集合不经文本解析，不使用缓存
+
+// 二进制集合文件：载入后该输入改从文件解码，文本框变为只读
+static SetFile binary_sets[2];
+static bool binary_loaded[2] = { false, false };
+static GtkWidget *binary_labels[2];
+
+// 各输入文本是否含区间语法：-1为未检查，0为否，1为是；输入被编辑后重置为-1
+static int input_has_ranges[2] = { -1, -1 };
+
+// 字符串模式：记号驻留为编号后复用整数集合运算
+static GtkWidget *string_check;
+
+// 实时模式：两个输入常驻内存，编辑时只重新解析受影响的记号
+static GtkWidget *live_check;
+static LiveSets live_sets;
+static bool live_active = false;
+static gulong live_handlers[2][4];      // 每个输入缓冲区上的四个信号处理器
+static gint live_window_start[2];       // 编辑前受影响记号区间的起点（字符偏移）
+
+// 多集合模式的控件
+static GtkWidget *text_view_multi;
+static GtkWidget *threshold_spin;
+static GtkWidget *expression_entry;
+
+// 多集合模式的运算，作为按钮回调的用户数据
+typedef enum {
+    MULTI_SET_UNION,
+    MULTI_SET_INTERSECTION,
+    MULTI_SET_AT_LEAST
+} MultiSetOp;
+
+// 每批解析的整数个数，数组按批扩容
+#define PARSE_BATCH_SIZE 65536
+// 区间模式下每批解析的区间个数
+#define INTERVAL_BATCH_SIZE 4096
+// 每次空闲回调向输出框追加的元素个数
+#define OUTPUT_CHUNK_SIZE 8192
+#define OUTPUT_MAX_SECTIONS 3
+// 草图页改按区间列表精确计算时，每个输入最多读入的区间个数，内存不超过约16MB
+#define SKETCH_EXACT_MAX_INTERVALS (1 << 20)
+
+// 输出框中的一段结果，显示为“标题：{元素列表}”
+typedef struct {
+    const char *title;
+    const int *values;
+    int count;
+} OutputSection;
+
+// 分块输出任务：大结果在空闲回调中逐块追加，界面不会长时间无响应
+typedef struct {
+    OutputSection sections[OUTPUT_MAX_SECTIONS];
+    int section_count;
+    int current;                // 正在输出的段
+    bool opened;                // 当前段的标题是否已写出
+    IntFormatCursor cursor;
+    int *values;                // 各段元素的副本，计算用的区域在回调结束时即释放
+    char *chunk;                // 单块的格式化缓冲区
+} OutputJob;
+
+static OutputJob *output_job = NULL;
+static guint output_source = 0;
 
 // 函数声明（静态函数）
-static bool contains(const int arr[], int size, int value);
-static char* array_to_string(const int arr[], int size);
+static IntParseStatus parse_union_set(const char* input, size_t length, IntVec* set, size_t* error_pos);
+static void read_input_sets(ErrorContext *error_ctx, IntVec *set1, IntVec *set2, bool overlap_only);
+static void collect_live_set(ErrorContext *error_ctx, int input, IntVec *set);
+static int* alloc_result(ErrorContext *error_ctx, Arena *arena, size_t count);
+static void compute_set_results(ErrorContext *error_ctx, Arena *arena,
+                                const IntVec *set1, const IntVec *set2, SetMergeResult *merged);
+static bool show_sections(const OutputSection *sections, int count);
+static void show_result(const char *text);
+
+/**
+ * 解析输入字符串为集合
+ * 参数：
+ *   input, length: 输入文本及字节数，格式为以空格或逗号分隔的整数
+ *   set: 输出数组，按需从区域分配器中增长
+ *   error_pos: 失败时的出错字节偏移
+ * 返回值：
+ *   INT_PARSE_OK表示成功；INT_PARSE_FULL表示数组无法继续扩容（内存不足）；
+ *   其余为格式错误或溢出
+ * 算法原理：
+ * 使用共享的向量化整数解析器，每批最多解析PARSE_BATCH_SIZE个整数，
+ * 解析前先为数组预留一批的空间
+ */
+static IntParseStatus parse_union_set(const char* input, size_t length, IntVec* set, size_t* error_pos) {
+    size_t pos = 0;
+    IntParseStatus status;
+    
+    do {
+        if (set->size > (size_t)INT_MAX - PARSE_BATCH_SIZE ||
+            !int_vec_reserve(set, set->size + PARSE_BATCH_SIZE)) {
+            return INT_PARSE_FULL;
+        }
+        size_t count = 0;
+        status = int_parse_batch(input, length, &pos, set->data + set->size,
+                                 PARSE_BATCH_SIZE, &count);
+        set->size += count;
+    } while (status == INT_PARSE_FULL);
+    
+    *error_pos = pos;
+    return status;
+}
+
+// 生成带出错位置的解析错误信息，位置按字符（而非字节）计数，返回对应的错误码
+static ErrorCode format_parse_error(char *message, size_t size, const char *name,
+                                    const char *text, IntParseStatus status, size_t error_pos) {
+    if (status == INT_PARSE_FULL) {
+        g_strlcpy(message, "内存分配失败", size);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    g_snprintf(message, size, "无效输入 - %s第%ld个字符处%s",
+               name, g_utf8_pointer_to_offset(text, text + error_pos) + 1,
+               int_parse_status_string(status));
+    return ERROR_INVALID_INPUT;
+}
+
+// 从缓存中取出已解析的集合，命中时返回true
+static bool load_cached_set(IntVec *set, uint64_t key) {
+    int size;
+    const int *data = set_cache_lookup(key, 0, SET_CACHE_PARSED, &size);
+    if (!data || !int_vec_reserve(set, (size_t)size)) {
+        return false;
+    }
+    memcpy(set->data, data, (size_t)size * sizeof(int));
+    set->size = (size_t)size;
+    return true;
+}
+
+// 释放输入文本；解析失败时先生成带位置的错误信息（需要原文计算字符位置），再抛出
+static void finish_input_text(ErrorContext *error_ctx, int input, char *text,
+                              IntParseStatus status, size_t pos) {
+    char message[256];
+    ErrorCode code = ERROR_NONE;
+    if (status != INT_PARSE_OK) {
+        code = format_parse_error(message, sizeof(message), input == 0 ? "集合1" : "集合2",
+                                  text, status, pos);
+    }
+    g_free(text);
+    
+    if (code != ERROR_NONE) {
+        THROW(error_ctx, code, message);
+    }
+}
+
+// 取出一个输入框的全部文本（调用者用g_free释放），失败时返回NULL
+static char* input_text(int input) {
+    GtkWidget *view = input == 0 ? text_view_input1 : text_view_input2;
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view));
+    if (!buffer) return NULL;
+    
+    GtkTextIter start, end;
+    gtk_text_buffer_get_bounds(buffer, &start, &end);
+    return gtk_text_buffer_get_text(buffer, &start, &end, FALSE);
+}
+
+// 读取一个输入框的文本并解析、排序去重，文本未变时直接从缓存复制
+static void read_text_set(ErrorContext *error_ctx, int input, IntVec *set) {
+    char *text = input_text(input);
+    if (!text) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "无法读取输入缓冲区");
+    }
+    
+    size_t length = strlen(text);
+    input_keys[input] = xxh64(text, length, 0);
+    if (load_cached_set(set, input_keys[input])) {
+        g_free(text);
+        return;
+    }
+    
+    size_t pos = 0;
+    IntParseStatus status = parse_union_set(text, length, set, &pos);
+    
+    finish_input_text(error_ctx, input, text, status, pos);
+    
+    set->size = (size_t)sort_unique(set->data, (int)set->size);
+    set_cache_store(input_keys[input], 0, SET_CACHE_PARSED, set->data, (int)set->size);
+}
+
+// 解码已载入的二进制集合中值域[lo, hi]内的元素
+static void decode_binary_set(ErrorContext *error_ctx, int input, IntVec *set, int lo, int hi) {
+    const SetFile *file = &binary_sets[input];
+    long long capacity = set_file_range_capacity(file, lo, hi);
+    if (!int_vec_reserve(set, (size_t)capacity)) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    set->size = (size_t)set_file_decode_range(file, lo, hi, set->data);
+}
+
+// 读取一个输入的完整集合：二进制文件、实时模式或文本
+static void read_input_set(ErrorContext *error_ctx, int input, IntVec *set) {
+    if (binary_loaded[input]) {
+        decode_binary_set(error_ctx, input, set, INT_MIN, INT_MAX);
+    } else if (live_active) {
+        // 实时模式下集合已常驻内存，直接取出，无需重新解析
+        collect_live_set(error_ctx, input, set);
+    } else {
+        read_text_set(error_ctx, input, set);
+    }
+}
+
+// 输入集合的值域，二进制文件只读块索引；集合为空时返回false
+static bool input_bounds(int input, const IntVec *set, int *min, int *max) {
+    if (binary_loaded[input]) {
+        const SetFile *file = &binary_sets[input];
+        if (file->block_count == 0) return false;
+        *min = file->blocks[0].min;
+        *max = file->blocks[file->block_count - 1].max;
+        return true;
+    }
+    if (set->size == 0) return false;
+    *min = set->data[0];
+    *max = set->data[set->size - 1];
+    return true;
+}
+
+/**
+ * 读取两个输入并解析、排序去重
+ * 参数：
+ *   error_ctx: 错误上下文，失败时直接抛出
+ *   set1, set2: 已用同一区域初始化的输出数组
+ *   overlap_only: 只需要两个集合值域重叠部分时为true（如求交集）
+ * 算法原理：
+ * 1. 文本读取后先计算XXH64哈希，文本未变的输入直接从缓存复制排序去重后的集合；
+ *    其余输入解析后立即释放文本，集合数据全部位于区域中，并存入缓存
+ * 2. 载入了二进制集合文件的输入最后解码：overlap_only时先由块索引和另一输入
+ *    求出两个值域的交，只解码与之相交的块
+ */
+static void read_input_sets(ErrorContext *error_ctx, IntVec *set1, IntVec *set2, bool overlap_only) {
+    IntVec *sets[2] = { set1, set2 };
+    input_keys_valid = false;
+    
+    for (int i = 0; i < 2; i++) {
+        if (!binary_loaded[i]) {
+            read_input_set(error_ctx, i, sets[i]);
+        }
+    }
+    
+    int lo = INT_MIN, hi = INT_MAX;
+    for (int i = 0; overlap_only && i < 2; i++) {
+        int min, max;
+        if (!input_bounds(i, sets[i], &min, &max)) {
+            lo = 1;
+            hi = 0;
+            break;
+        }
+        if (min > lo) lo = min;
+        if (max < hi) hi = max;
+    }
+    
+    for (int i = 0; i < 2; i++) {
+        if (binary_loaded[i]) {
+            decode_binary_set(error_ctx, i, sets[i], lo, hi);
+        }
+    }
+    
+    // 只有两个输入都来自文本时，哈希才能代表集合内容
+    input_keys_valid = !live_active && !binary_loaded[0] && !binary_loaded[1];
+}
+
+// 从区域中分配结果数组，失败时抛出错误
+static int* alloc_result(ErrorContext *error_ctx, Arena *arena, size_t count) {
+    int *out = arena_alloc(arena, count * sizeof(int));
+    if (!out) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    return out;
+}
+
+// 用压缩位图计算一种运算，并展开到调用者提供的输出数组
+static void roaring_result(ErrorContext *error_ctx, Arena *arena,
+                           const RoaringBitmap *a, const RoaringBitmap *b,
+                           RoaringOp op, int *out, int *size) {
+    if (!out) return;
+
+    RoaringBitmap result;
+    roaring_init(&result, arena);
+    if (!roaring_op(a, b, op, &result)) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    *size = roaring_to_array(&result, out);
+}
+
+// 输入被编辑后，在该输入上建立的过滤器与区间语法检查结果失效
+static void on_input_changed(GtkTextBuffer *buffer, gpointer data) {
+    (void)buffer;
+    input_has_ranges[GPOINTER_TO_INT(data)] = -1;
+    if (cached_filter_input == GPOINTER_TO_INT(data)) {
+        bloom_free(&cached_filter);
+        cached_filter_input = -1;
+    }
+}
+
+/**
+ * 取得在指定输入上建立的过滤器，没有可用的缓存时重新建立
+ * 说明：
+ * 二进制输入只解码与另一输入值域相交的部分，编辑另一输入后同一输入解码出的集合会变化，
+ * 因此复用条件是集合内容（元素个数与XXH64哈希）相同，而不只是输入编号
+ */
+static const BloomFilter* get_bloom_filter(ErrorContext *error_ctx, int input, const IntVec *set, bool *reused) {
+    uint64_t hash = xxh64(set->data, set->size * sizeof(int), 0);
+    *reused = cached_filter_input == input && cached_filter_size == set->size &&
+              cached_filter_hash == hash;
+    if (*reused) {
+        return &cached_filter;
+    }
+    
+    if (cached_filter_input != -1) {
+        bloom_free(&cached_filter);
+        cached_filter_input = -1;
+    }
+    if (!bloom_build(&cached_filter, set->data, (int)set->size)) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    cached_filter_input = input;
+    cached_filter_size = set->size;
+    cached_filter_hash = hash;
+    return &cached_filter;
+}
+
+/**
+ * 用布隆过滤器计算规模悬殊的两个集合的运算结果
+ * 参数：
+ *   set1, set2: 有序且无重复的输入集合
+ *   merged: 非NULL的输出数组即为需要计算的结果
+ *   threads: 其余结果归并时使用的线程数
+ * 算法原理：
+ * 1. 交集与“小集合-大集合”只需逐个检查小集合的元素：过滤器一次缓存行访问
+ *    即可排除绝大多数不在大集合中的元素，通过过滤器的再做精确二分查找
+ * 2. 并集、对称差与“大集合-小集合”必须扫描大集合，仍使用有序归并
+ */
+static void bloom_set_results(ErrorContext *error_ctx, const IntVec *set1, const IntVec *set2,
+                              SetMergeResult *merged, int threads) {
+    int big = set1->size >= set2->size ? 0 : 1;
+    const IntVec *ref = big == 0 ? set1 : set2;
+    const IntVec *probe = big == 0 ? set2 : set1;
+    
+    bool reused;
+    const BloomFilter *filter = get_bloom_filter(error_ctx, big, ref, &reused);
+    
+    BloomStats stats = {0};
+    bloom_probe_sorted(filter, probe->data, (int)probe->size, ref->data, (int)ref->size,
+                       merged->intersection_out, &merged->intersection_size,
+                       big == 0 ? merged->b_minus_a_out : merged->a_minus_b_out,
+                       big == 0 ? &merged->b_minus_a_size : &merged->a_minus_b_size, &stats);
+    
+    SetMergeResult rest = {
+        .union_out = merged->union_out,
+        .sym_diff_out = merged->sym_diff_out,
+        .a_minus_b_out = big == 0 ? merged->a_minus_b_out : NULL,
+        .b_minus_a_out = big == 1 ? merged->b_minus_a_out : NULL
+    };
+    if (rest.union_out || rest.sym_diff_out || rest.a_minus_b_out || rest.b_minus_a_out) {
+        set_merge_parallel(set1->data, (int)set1->size, set2->data, (int)set2->size, &rest, threads);
+        merged->union_size = rest.union_size;
+        merged->sym_diff_size = rest.sym_diff_size;
+        if (big == 0) merged->a_minus_b_size = rest.a_minus_b_size;
+        else merged->b_minus_a_size = rest.b_minus_a_size;
+    }
+    
+    long long non_members = stats.probes - stats.members;
+    gchar *line = g_strdup_printf("布隆过滤：过滤器建于集合%d（%s，%zu KB），探测 %lld 次，"
+                                  "通过 %lld 次（通过率 %.2f%%），误判率 %.2f%%",
+                                  big + 1, reused ? "复用" : "新建",
+                                  filter->block_count * BLOOM_BLOCK_WORDS * sizeof(uint64_t) / 1024,
+                                  stats.probes, stats.passed,
+                                  stats.probes ? 100.0 * stats.passed / stats.probes : 0.0,
+                                  non_members ? 100.0 * (stats.passed - stats.members) / non_members : 0.0);
+    gtk_label_set_text(GTK_LABEL(stats_label), line);
+    g_free(line);
+}
+
+/**
+ * 执行merged中请求的各项集合运算
+ * 参数：
+ *   set1, set2: 有序且无重复的输入集合
+ *   merged: 非NULL的输出数组即为需要计算的结果
+ * 算法原理：
+ * 1. 若两个集合的大部分元素落在稠密而不连续的块中，逐元素归并的比较分支难以预测，
+ *    临时建立压缩位图按64位字执行AND/OR/ANDNOT/XOR更快（按运算代价选择，见roaring_is_cheaper）
+ * 2. 启用布隆过滤且两个集合规模悬殊时，小集合的元素先经过滤器筛选
+ * 3. 否则使用有序归并，一次扫描产生所有结果；输入较大时按值域分区，
+ *    由多个线程分别归并
+ */
+static void run_set_operations(ErrorContext *error_ctx, Arena *arena,
+                              const IntVec *set1, const IntVec *set2, SetMergeResult *merged) {
+    int size1 = (int)set1->size, size2 = (int)set2->size;
+    if (!roaring_is_cheaper(set1->data, size1, set2->data, size2)) {
+        int threads = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(thread_spin));
+        int small = size1 < size2 ? size1 : size2;
+        int large = size1 < size2 ? size2 : size1;
+        bool skewed = small > 0 && (long long)small * SET_GALLOP_RATIO <= large;
+        
+        if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(bloom_check)) && skewed) {
+            bloom_set_results(error_ctx, set1, set2, merged, threads);
+            return;
+        }
+        gtk_label_set_text(GTK_LABEL(stats_label), "");
+        set_merge_parallel(set1->data, size1, set2->data, size2, merged, threads);
+        return;
+    }
+    gtk_label_set_text(GTK_LABEL(stats_label), "");
+
+    RoaringBitmap a, b;
+    roaring_init(&a, arena);
+    roaring_init(&b, arena);
+    if (!roaring_from_sorted(&a, set1->data, size1) || !roaring_from_sorted(&b, set2->data, size2)) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+
+    roaring_result(error_ctx, arena, &a, &b, ROARING_OR, merged->union_out, &merged->union_size);
+    roaring_result(error_ctx, arena, &a, &b, ROARING_AND,
+                   merged->intersection_out, &merged->intersection_size);
+    roaring_result(error_ctx, arena, &a, &b, ROARING_ANDNOT,
+                   merged->a_minus_b_out, &merged->a_minus_b_size);
+    roaring_result(error_ctx, arena, &b, &a, ROARING_ANDNOT,
+                   merged->b_minus_a_out, &merged->b_minus_a_size);
+    roaring_result(error_ctx, arena, &a, &b, ROARING_XOR, merged->sym_diff_out, &merged->sym_diff_size);
+}
+
+// 一项运算结果在SetMergeResult中的输出位置
+typedef struct {
+    SetCacheKind kind;
+    int *out;
+    int *size;
+} ResultSlot;
+
+// 列出merged中的全部输出位置，返回个数
+static int result_slots(SetMergeResult *merged, ResultSlot slots[5]) {
+    slots[0] = (ResultSlot){ SET_CACHE_UNION, merged->union_out, &merged->union_size };
+    slots[1] = (ResultSlot){ SET_CACHE_INTERSECTION, merged->intersection_out, &merged->intersection_size };
+    slots[2] = (ResultSlot){ SET_CACHE_A_MINUS_B, merged->a_minus_b_out, &merged->a_minus_b_size };
+    slots[3] = (ResultSlot){ SET_CACHE_B_MINUS_A, merged->b_minus_a_out, &merged->b_minus_a_size };
+    slots[4] = (ResultSlot){ SET_CACHE_SYM_DIFF, merged->sym_diff_out, &merged->sym_diff_size };
+    return 5;
+}
+
+/**
+ * 计算merged中请求的各项集合运算结果
+ * 参数：
+ *   set1, set2: 有序且无重复的输入集合
+ *   merged: 非NULL的输出数组即为需要计算的结果
+ * 算法原理：
+ * 两个输入的文本哈希相同时结果必然相同：请求的结果全部在缓存中时直接复制，
+ * 否则执行运算并把各项结果存入缓存，供之后的相同运算或其他运算复用
+ */
+static void compute_set_results(ErrorContext *error_ctx, Arena *arena,
+                                const IntVec *set1, const IntVec *set2, SetMergeResult *merged) {
+    ResultSlot slots[5];
+    int count = result_slots(merged, slots);
+    
+    bool all_cached = input_keys_valid;
+    for (int i = 0; i < count && all_cached; i++) {
+        int size;
+        if (slots[i].out && !set_cache_lookup(input_keys[0], input_keys[1], slots[i].kind, &size)) {
+            all_cached = false;
+        }
+    }
+    
+    if (all_cached) {
+        for (int i = 0; i < count; i++) {
+            if (!slots[i].out) continue;
+            const int *data = set_cache_lookup(input_keys[0], input_keys[1], slots[i].kind, slots[i].size);
+            memcpy(slots[i].out, data, (size_t)*slots[i].size * sizeof(int));
+        }
+        gtk_label_set_text(GTK_LABEL(stats_label), "结果来自缓存（输入未修改）");
+        return;
+    }
+    
+    run_set_operations(error_ctx, arena, set1, set2, merged);
+    if (input_keys_valid) {
+        for (int i = 0; i < count; i++) {
+            if (slots[i].out) {
+                set_cache_store(input_keys[0], input_keys[1], slots[i].kind, slots[i].out, *slots[i].size);
+            }
+        }
+    }
+}
+
+// 停止并释放正在进行的分块输出任务
+static void cancel_output_job(void) {
+    if (output_source) {
+        g_source_remove(output_source);
+        output_source = 0;
+    }
+    if (output_job) {
+        g_free(output_job->values);
+        g_free(output_job->chunk);
+        g_free(output_job);
+        output_job = NULL;
+    }
+}
+
+/**
+ * 向输出框追加下一块结果
+ * 返回值：
+ *   还有剩余内容时返回G_SOURCE_CONTINUE，全部输出后释放任务并返回G_SOURCE_REMOVE
+ * 算法原理：
+ * 每次只格式化OUTPUT_CHUNK_SIZE个元素并插入到缓冲区末尾，
+ * 格式化缓冲区按块大小预先分配，整个输出过程为O(n)
+ */
+static gboolean output_job_step(gpointer data) {
+    (void)data;
+    OutputJob *job = output_job;
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
+    OutputSection *section = &job->sections[job->current];
+    GtkTextIter end;
+    gtk_text_buffer_get_end_iter(buffer, &end);
+    
+    if (!job->opened) {
+        gtk_text_buffer_insert(buffer, &end, section->title, -1);
+        gtk_text_buffer_insert(buffer, &end, "：{", -1);
+        int_format_cursor_init(&job->cursor, section->values, (size_t)section->count, ", ");
+        job->opened = true;
+    }
+    
+    size_t length = int_format_next_chunk(&job->cursor, job->chunk, OUTPUT_CHUNK_SIZE);
+    gtk_text_buffer_insert(buffer, &end, job->chunk, (gint)length);
+    
+    if (int_format_cursor_done(&job->cursor)) {
+        job->current++;
+        job->opened = false;
+        gtk_text_buffer_insert(buffer, &end, job->current < job->section_count ? "}\n" : "}", -1);
+    }
+    
+    if (job->current < job->section_count) {
+        return G_SOURCE_CONTINUE;
+    }
+    output_source = 0;
+    cancel_output_job();
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * 在输出框中分块显示若干段整数结果
+ * 参数：
+ *   sections: 各段的标题与元素
+ *   count: 段数，不超过OUTPUT_MAX_SECTIONS
+ * 返回值：
+ *   成功返回true，内存不足返回false
+ * 算法原理：
+ * 第一块立即输出，剩余部分交给空闲回调逐块追加；
+ * 新的输出会取消尚未完成的旧任务
+ */
+static bool show_sections(const OutputSection *sections, int count) {
+    cancel_output_job();
+    
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += (size_t)sections[i].count;
+    }
+    
+    OutputJob *job = g_try_malloc0(sizeof(OutputJob));
+    if (!job) return false;
+    job->chunk = g_try_malloc(int_format_bound(OUTPUT_CHUNK_SIZE, 2));
+    job->values = g_try_malloc(total > 0 ? total * sizeof(int) : 1);
+    if (!job->chunk || !job->values) {
+        g_free(job->chunk);
+        g_free(job->values);
+        g_free(job);
+        return false;
+    }
+    
+    int *copy = job->values;
+    for (int i = 0; i < count; i++) {
+        if (sections[i].count > 0) {
+            memcpy(copy, sections[i].values, (size_t)sections[i].count * sizeof(int));
+        }
+        job->sections[i] = sections[i];
+        job->sections[i].values = copy;
+        copy += sections[i].count;
+    }
+    job->section_count = count;
+    output_job = job;
+    
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
+    gtk_text_buffer_set_text(buffer, "", -1);
+    if (output_job_step(NULL) == G_SOURCE_CONTINUE) {
+        output_source = g_idle_add(output_job_step, NULL);
+    }
+    return true;
+}
+
+// 在输出框中显示文本
+static void show_result(const char *text) {
+    cancel_output_job();
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
+    gtk_text_buffer_set_text(buffer, text, -1);
+}
+
+// 从常驻集合中按序取出一个输入的所有元素
+static void collect_live_set(ErrorContext *error_ctx, int input, IntVec *set) {
+    if (!int_vec_reserve(set, live_sets.counts[input].size)) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    set->size = live_sets_copy_input(&live_sets, input, set->data);
+}
+
+// 与解析器一致的分隔符：空白字符与逗号
+static inline bool is_live_delimiter(gunichar c) {
+    return c == ' ' || c == ',' || (c >= '\t' && c <= '\r');
+}
+
+// 把iter向前移到所在记号的起点
+static void move_to_token_start(GtkTextIter *iter) {
+    GtkTextIter prev = *iter;
+    while (gtk_text_iter_backward_char(&prev) && !is_live_delimiter(gtk_text_iter_get_char(&prev))) {
+        *iter = prev;
+    }
+}
+
+// 把iter向后移到所在记号的终点
+static void move_to_token_end(GtkTextIter *iter) {
+    while (!gtk_text_iter_is_end(iter) && !is_live_delimiter(gtk_text_iter_get_char(iter))) {
+        gtk_text_iter_forward_char(iter);
+    }
+}
+
+// 显示实时结果的规模以及最近一次编辑带来的变化
+static void show_live_summary(void) {
+    static const char *names[LIVE_RESULT_COUNT] = { "并集", "交集", "差集(A-B)", "差集(B-A)", "对称差" };
+    GString *text = g_string_new("实时模式：编辑输入后结果立即更新，点击运算按钮可查看完整结果\n");
+    g_string_append_printf(text, "集合1：%zu 个元素，集合2：%zu 个元素\n",
+                           live_sets.counts[0].size, live_sets.counts[1].size);
+    for (int r = 0; r < LIVE_RESULT_COUNT; r++) {
+        g_string_append_printf(text, "%s：%zu 个元素（本次 +%d / -%d）\n", names[r],
+                               live_sets.results[r].size, live_sets.added[r], live_sets.removed[r]);
+    }
+    if (live_sets.invalid_tokens[0] > 0 || live_sets.invalid_tokens[1] > 0) {
+        g_string_append_printf(text, "已忽略无效记号：集合1 %d 个，集合2 %d 个\n",
+                               live_sets.invalid_tokens[0], live_sets.invalid_tokens[1]);
+    }
+    show_result(text->str);
+    g_string_free(text, TRUE);
+}
+
+// 实时模式下两个输入都来自文本框时，运算按钮直接使用常驻的结果
+static bool live_results_ready(void) {
+    return live_active && !binary_loaded[0] && !binary_loaded[1];
+}
+
+/**
+ * 显示实时模式下维护的有序结果
+ * 参数：
+ *   widget: 触发运算的按钮
+ *   results, titles, count: 要显示的结果及其标题
+ * 算法原理：
+ * 各项结果在编辑时已增量维护为有序集合，这里只按块复制，
+ * 耗时与结果大小成正比，无需重新解析、排序或归并
+ */
+static void show_live_results(GtkWidget *widget, const LiveResult *results,
+                              const char *const *titles, int count) {
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    Arena arena;
+    arena_init(&arena, 0);
+    
+    TRY(&error_ctx) {
+        OutputSection sections[OUTPUT_MAX_SECTIONS];
+        for (int i = 0; i < count; i++) {
+            const IntOrderedSet *result = &live_sets.results[results[i]];
+            int *values = alloc_result(&error_ctx, &arena, result->size);
+            sections[i].title = titles[i];
+            sections[i].values = values;
+            sections[i].count = (int)live_sets_copy_result(&live_sets, results[i], values);
+        }
+        if (!show_sections(sections, count)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        }
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        arena_destroy(&arena);
+    });
+}
+
+static void disable_live_mode(void);
+
+// 把[start, end)内的记号加入或移出常驻集合；内存不足时退出实时模式
+static void apply_live_range(GtkTextBuffer *buffer, int input,
+                             const GtkTextIter *start, const GtkTextIter *end, int sign) {
+    char *text = gtk_text_buffer_get_text(buffer, start, end, FALSE);
+    bool ok = text && live_sets_apply_text(&live_sets, input, text, strlen(text), sign);
+    g_free(text);
+    if (!ok) {
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(live_check), FALSE);
+        handle_error(NULL, ERROR_MEMORY_ALLOCATION, "内存不足，已退出实时模式");
+    }
+}
+
+/**
+ * 插入文本前：移出插入点所在记号的旧值
+ * 算法原理：
+ * 插入只会改变插入点所在的那个记号（可能把它拆开或与相邻记号连接），
+ * 因此先按旧文本移出该记号，插入后再按新文本加入同一区间，
+ * 处理量与编辑长度加记号长度成正比，与集合大小无关
+ */
+static void on_live_insert_before(GtkTextBuffer *buffer, GtkTextIter *location,
+                                  gchar *text, gint len, gpointer data) {
+    (void)text;
+    (void)len;
+    int input = GPOINTER_TO_INT(data);
+    GtkTextIter start = *location, end = *location;
+    move_to_token_start(&start);
+    move_to_token_end(&end);
+    live_window_start[input] = gtk_text_iter_get_offset(&start);
+    live_sets_begin_edit(&live_sets);
+    apply_live_range(buffer, input, &start, &end, -1);
+}
+
+// 插入文本后：location已指向插入内容之后，重新加入受影响区间的新值
+static void on_live_insert_after(GtkTextBuffer *buffer, GtkTextIter *location,
+                                 gchar *text, gint len, gpointer data) {
+    (void)text;
+    (void)len;
+    if (!live_active) return;
+    int input = GPOINTER_TO_INT(data);
+    GtkTextIter start, end = *location;
+    gtk_text_buffer_get_iter_at_offset(buffer, &start, live_window_start[input]);
+    move_to_token_end(&end);
+    apply_live_range(buffer, input, &start, &end, 1);
+    if (live_active) show_live_summary();
+}
+
+// 删除文本前：移出与删除区间相交的所有记号
+static void on_live_delete_before(GtkTextBuffer *buffer, GtkTextIter *start_iter,
+                                  GtkTextIter *end_iter, gpointer data) {
+    int input = GPOINTER_TO_INT(data);
+    GtkTextIter start = *start_iter, end = *end_iter;
+    move_to_token_start(&start);
+    move_to_token_end(&end);
+    live_window_start[input] = gtk_text_iter_get_offset(&start);
+    live_sets_begin_edit(&live_sets);
+    apply_live_range(buffer, input, &start, &end, -1);
+}
+
+// 删除文本后：两个迭代器都指向删除点，重新加入拼接后的记号
+static void on_live_delete_after(GtkTextBuffer *buffer, GtkTextIter *start_iter,
+                                 GtkTextIter *end_iter, gpointer data) {
+    (void)end_iter;
+    if (!live_active) return;
+    int input = GPOINTER_TO_INT(data);
+    GtkTextIter start, end = *start_iter;
+    gtk_text_buffer_get_iter_at_offset(buffer, &start, live_window_start[input]);
+    move_to_token_end(&end);
+    apply_live_range(buffer, input, &start, &end, 1);
+    if (live_active) show_live_summary();
+}
+
+// 断开信号并释放常驻集合
+static void disable_live_mode(void) {
+    if (!live_active) return;
+    GtkWidget *views[2] = { text_view_input1, text_view_input2 };
+    for (int i = 0; i < 2; i++) {
+        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(views[i]));
+        for (int h = 0; h < 4; h++) {
+            if (live_handlers[i][h]) {
+                g_signal_handler_disconnect(buffer, live_handlers[i][h]);
+                live_handlers[i][h] = 0;
+            }
+        }
+    }
+    live_sets_free(&live_sets);
+    live_active = false;
+}
+
+/**
+ * 切换实时模式
+ * 参数：
+ *   widget: 实时模式复选框
+ *   data: 用户数据（未使用）
+ * 算法原理：
+ * 开启时完整解析一次两个输入并常驻内存，之后监听缓冲区的
+ * insert-text与delete-range信号，只对受影响的记号做增量更新
+ */
+void perform_live_mode_toggled(GtkWidget *widget, gpointer data) {
+    (void)data;
+    
+    if (!gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget))) {
+        disable_live_mode();
+        return;
+    }
+    if (live_active) return;
+    
+    if (!live_sets_init(&live_sets)) {
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widget), FALSE);
+        handle_error(gtk_widget_get_toplevel(widget), ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        return;
+    }
+    live_active = true;
+    
+    GtkWidget *views[2] = { text_view_input1, text_view_input2 };
+    for (int i = 0; i < 2 && live_active; i++) {
+        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(views[i]));
+        GtkTextIter start, end;
+        gtk_text_buffer_get_bounds(buffer, &start, &end);
+        apply_live_range(buffer, i, &start, &end, 1);
+    }
+    if (!live_active) return;
+    
+    for (int i = 0; i < 2; i++) {
+        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(views[i]));
+        gpointer input = GINT_TO_POINTER(i);
+        live_handlers[i][0] = g_signal_connect(buffer, "insert-text", G_CALLBACK(on_live_insert_before), input);
+        live_handlers[i][1] = g_signal_connect_after(buffer, "insert-text", G_CALLBACK(on_live_insert_after), input);
+        live_handlers[i][2] = g_signal_connect(buffer, "delete-range", G_CALLBACK(on_live_delete_before), input);
+        live_handlers[i][3] = g_signal_connect_after(buffer, "delete-range", G_CALLBACK(on_live_delete_after), input);
+    }
+    live_sets_begin_edit(&live_sets);
+    show_live_summary();
+}
+
+// 文本中是否含有区间记号（数字后紧跟'-'，如“1-1000000”）
+static bool text_has_ranges(const char *text) {
+    for (const char *p = strchr(text, '-'); p; p = strchr(p + 1, '-')) {
+        if (p > text && isdigit((unsigned char)p[-1])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 两个文本输入中是否有一个使用了区间语法；载入二进制文件的输入不检查
+// 每个输入只在编辑后的第一次运算时扫描一遍文本，结果缓存到下一次编辑
+static bool inputs_have_ranges(void) {
+    for (int i = 0; i < 2; i++) {
+        if (binary_loaded[i]) continue;
+        if (input_has_ranges[i] < 0) {
+            char *text = input_text(i);
+            if (!text) continue;
+            input_has_ranges[i] = text_has_ranges(text);
+            g_free(text);
+        }
+        if (input_has_ranges[i]) return true;
+    }
+    return false;
+}
+
+// 区间解析的批缓冲区，第k个区间为[range_bounds[2k], range_bounds[2k+1]]
+static int range_bounds[2 * INTERVAL_BATCH_SIZE];
+
+// 解析含区间语法的文本，追加到区间集合，返回值与parse_union_set相同
+static IntParseStatus parse_interval_set(const char *input, size_t length, IntervalSet *set, size_t *error_pos) {
+    size_t pos = 0;
+    IntParseStatus status;
+    
+    do {
+        size_t count = 0;
+        status = int_parse_ranges(input, length, &pos, range_bounds, INTERVAL_BATCH_SIZE, &count);
+        if (!interval_set_reserve(set, set->size + count)) {
+            return INT_PARSE_FULL;
+        }
+        for (size_t k = 0; k < count; k++) {
+            set->data[set->size++] = (Interval){ range_bounds[2 * k], range_bounds[2 * k + 1] };
+        }
+    } while (status == INT_PARSE_FULL);
+    
+    *error_pos = pos;
+    return status;
+}
+
+// 读取一个输入为规范化的区间集合；二进制文件先解码再压缩为连续段
+static void read_interval_set(ErrorContext *error_ctx, int input, IntervalSet *set) {
+    if (binary_loaded[input]) {
+        IntVec values;
+        if (!int_vec_init(&values, set->arena, 0)) {
+            THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        decode_binary_set(error_ctx, input, &values, INT_MIN, INT_MAX);
+        if (!interval_set_from_sorted(set, values.data, values.size)) {
+            THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        return;
+    }
+    
+    char *text = input_text(input);
+    if (!text) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "无法读取输入缓冲区");
+    }
+    
+    size_t pos = 0;
+    IntParseStatus status = parse_interval_set(text, strlen(text), set, &pos);
+    
+    finish_input_text(error_ctx, input, text, status, pos);
+    interval_set_normalize(set);
+}
+
+/**
+ * 区间模式下执行集合运算并显示结果
+ * 参数：
+ *   widget: GTK部件指针
+ *   ops, titles, count: 需要计算的运算及各自的结果标题
+ * 算法原理：
+ * 1. 输入解析为区间列表后排序、合并重叠与相邻的区间
+ * 2. 每种运算扫描一遍两侧区间的端点，结果直接以区间形式输出
+ * 时间复杂度：O(r log r)，r为区间个数，与区间内的元素个数无关
+ */
+static void perform_interval_operation(GtkWidget *widget, const IntervalOp *ops,
+                                       const char *const *titles, int count) {
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    Arena arena;
+    arena_init(&arena, 0);
+    char *text = NULL;
+    
+    TRY(&error_ctx) {
+        IntervalSet a, b, results[OUTPUT_MAX_SECTIONS];
+        if (!interval_set_init(&a, &arena, 0) || !interval_set_init(&b, &arena, 0)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        read_interval_set(&error_ctx, 0, &a);
+        read_interval_set(&error_ctx, 1, &b);
+        
+        size_t bound = 1;
+        for (int i = 0; i < count; i++) {
+            if (!interval_set_init(&results[i], &arena, 0) ||
+                !interval_set_op(&a, &b, ops[i], &results[i])) {
+                THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+            }
+            bound += strlen(titles[i]) + interval_set_format_bound(results[i].size) + 64;
+        }
+        
+        text = g_try_malloc(bound);
+        if (!text) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        }
+        char *p = text;
+        for (int i = 0; i < count; i++) {
+            p += g_snprintf(p, bound - (size_t)(p - text), "%s：{", titles[i]);
+            p += interval_set_format(&results[i], p);
+            p += g_snprintf(p, bound - (size_t)(p - text), "}（%lld 个元素）%s",
+                            interval_set_count(&results[i]), i + 1 < count ? "\n" : "");
+        }
+        show_result(text);
+        
+        gchar *line = g_strdup_printf("区间模式：集合1 %zu 个区间，集合2 %zu 个区间", a.size, b.size);
+        gtk_label_set_text(GTK_LABEL(stats_label), line);
+        g_free(line);
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        g_free(text);
+        arena_destroy(&arena);
+    });
+}
+
+// 字符串模式的记号分隔符，与整数输入相同：空白与逗号
+static inline bool is_string_delimiter(char c) {
+    return c == ' ' || c == ',' || (c >= '\t' && c <= '\r');
+}
+
+// 把一个输入框中的记号驻留到字符串池，得到排序去重后的编号集合
+static void intern_input_set(ErrorContext *error_ctx, StringPool *pool, int input, IntVec *ids) {
+    if (binary_loaded[input]) {
+        THROW(error_ctx, ERROR_INVALID_OPERATION, "二进制集合文件只能用于整数集合，请先卸载");
+    }
+    char *text = input_text(input);
+    if (!text) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "无法读取输入缓冲区");
+    }
+    
+    bool ok = true;
+    const char *p = text;
+    while (ok) {
+        while (*p && is_string_delimiter(*p)) p++;
+        if (!*p) break;
+        const char *start = p;
+        while (*p && !is_string_delimiter(*p)) p++;
+        int id = string_pool_intern(pool, start, (size_t)(p - start));
+        ok = id >= 0 && int_vec_push(ids, id);
+    }
+    g_free(text);
+    
+    if (!ok) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    ids->size = (size_t)sort_unique(ids->data, (int)ids->size);
+}
+
+// 取出一种运算在归并结果中的输出位置
+static int** merge_output(SetMergeResult *merged, IntervalOp op, int **size) {
+    switch (op) {
+        case INTERVAL_UNION:        *size = &merged->union_size;        return &merged->union_out;
+        case INTERVAL_INTERSECTION: *size = &merged->intersection_size; return &merged->intersection_out;
+        case INTERVAL_A_MINUS_B:    *size = &merged->a_minus_b_size;    return &merged->a_minus_b_out;
+        case INTERVAL_B_MINUS_A:    *size = &merged->b_minus_a_size;    return &merged->b_minus_a_out;
+        default:                    *size = &merged->sym_diff_size;     return &merged->sym_diff_out;
+    }
+}
+
+/**
+ * 字符串模式下执行集合运算并显示结果
+ * 参数：
+ *   widget: GTK部件指针
+ *   ops, titles, count: 需要计算的运算及各自的结果标题
+ * 算法原理：
+ * 1. 两个输入的记号驻留到同一个字符串池：字符首尾相接存放在连续的字符区，
+ *    每个不同的字符串只保存一份，按首次出现的顺序编号，不为单个记号分配内存
+ * 2. 同一字符串在两个输入中编号相同，集合运算直接在32位编号上做并行归并，
+ *    与整数集合共用同一组内核
+ * 3. 结果按编号（即首次出现的顺序）输出对应的字符串
+ */
+static void perform_string_operation(GtkWidget *widget, const IntervalOp *ops,
+                                     const char *const *titles, int count) {
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    Arena arena;
+    arena_init(&arena, 0);
+    GString *text = NULL;
+    
+    TRY(&error_ctx) {
+        StringPool pool;
+        IntVec a, b;
+        if (!string_pool_init(&pool, &arena, 0) ||
+            !int_vec_init(&a, &arena, 0) || !int_vec_init(&b, &arena, 0)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        intern_input_set(&error_ctx, &pool, 0, &a);
+        intern_input_set(&error_ctx, &pool, 1, &b);
+        
+        SetMergeResult merged = { 0 };
+        for (int i = 0; i < count; i++) {
+            int *size;
+            *merge_output(&merged, ops[i], &size) = alloc_result(&error_ctx, &arena, a.size + b.size);
+        }
+        int threads = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(thread_spin));
+        set_merge_parallel(a.data, (int)a.size, b.data, (int)b.size, &merged, threads);
+        
+        text = g_string_sized_new(pool.chars_size + 64);
+        for (int i = 0; i < count; i++) {
+            int *size;
+            const int *ids = *merge_output(&merged, ops[i], &size);
+            g_string_append_printf(text, "%s：{", titles[i]);
+            for (int j = 0; j < *size; j++) {
+                if (j > 0) g_string_append(text, ", ");
+                g_string_append_len(text, string_pool_get(&pool, ids[j]),
+                                    (gssize)string_pool_length(&pool, ids[j]));
+            }
+            g_string_append_printf(text, "}（%d 个元素）%s", *size, i + 1 < count ? "\n" : "");
+        }
+        show_result(text->str);
+        
+        gchar *line = g_strdup_printf("字符串模式：集合1 %zu 个、集合2 %zu 个不同记号，驻留 %d 个字符串共 %zu 字节",
+                                      a.size, b.size, pool.count, pool.chars_size);
+        gtk_label_set_text(GTK_LABEL(stats_label), line);
+        g_free(line);
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        if (text) g_string_free(text, TRUE);
+        arena_destroy(&arena);
+    });
+}
+
+// 当前是否为字符串模式
+static bool string_mode_active(void) {
+    return gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(string_check));
+}
+
+/**
+ * 执行集合并集运算
+ * 参数：
+ *   widget: GTK部件指针
+ *   data: 用户数据（未使用）
+ * 算法原理：
+ * 1. 获取两个输入集合，分别排序去重
+ * 2. 对两个有序集合做一次归并，输出天然有序
+ * 时间复杂度：O(n log n + m log m)，归并本身为O(n+m)
+ * 内存：所有缓冲区来自同一区域，结束时一次性释放
+ */
+void perform_set_union(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    (void)data;
+    
+    static const IntervalOp ops[] = { INTERVAL_UNION };
+    static const LiveResult live_results[] = { LIVE_UNION };
+    static const char *const titles[] = { "并集结果" };
+    if (string_mode_active()) {
+        perform_string_operation(widget, ops, titles, 1);
+        return;
+    }
+    // 输入含区间语法时按区间列表运算
+    if (inputs_have_ranges()) {
+        perform_interval_operation(widget, ops, titles, 1);
+        return;
+    }
+    // 实时模式下结果已增量维护
+    if (live_results_ready()) {
+        show_live_results(widget, live_results, titles, 1);
+        return;
+    }
+    
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    Arena arena;
+    arena_init(&arena, 0);
+    IntVec set1, set2;
+    
+    TRY(&error_ctx) {
+        if (!int_vec_init(&set1, &arena, 0) || !int_vec_init(&set2, &arena, 0)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        read_input_sets(&error_ctx, &set1, &set2, false);
+        
+        // 合并两个集合
+        SetMergeResult merged = {
+            .union_out = alloc_result(&error_ctx, &arena, set1.size + set2.size)
+        };
+        compute_set_results(&error_ctx, &arena, &set1, &set2, &merged);
+        
+        // 显示结果
+        OutputSection section = { "并集结果", merged.union_out, merged.union_size };
+        if (!show_sections(&section, 1)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        }
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        arena_destroy(&arena);
+    });
+}
+
+void perform_set_intersection(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    (void)data;
+    
+    static const IntervalOp ops[] = { INTERVAL_INTERSECTION };
+    static const LiveResult live_results[] = { LIVE_INTERSECTION };
+    static const char *const titles[] = { "交集结果" };
+    if (string_mode_active()) {
+        perform_string_operation(widget, ops, titles, 1);
+        return;
+    }
+    // 输入含区间语法时按区间列表运算
+    if (inputs_have_ranges()) {
+        perform_interval_operation(widget, ops, titles, 1);
+        return;
+    }
+    // 实时模式下结果已增量维护
+    if (live_results_ready()) {
+        show_live_results(widget, live_results, titles, 1);
+        return;
+    }
+    
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    Arena arena;
+    arena_init(&arena, 0);
+    IntVec set1, set2;
+    
+    TRY(&error_ctx) {
+        if (!int_vec_init(&set1, &arena, 0) || !int_vec_init(&set2, &arena, 0)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        read_input_sets(&error_ctx, &set1, &set2, true);
+        
+        // 计算交集
+        size_t capacity = set1.size < set2.size ? set1.size : set2.size;
+        SetMergeResult merged = {
+            .intersection_out = alloc_result(&error_ctx, &arena, capacity)
+        };
+        compute_set_results(&error_ctx, &arena, &set1, &set2, &merged);
+        
+        // 显示结果
+        OutputSection section = { "交集结果", merged.intersection_out, merged.intersection_size };
+        if (!show_sections(&section, 1)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        }
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        arena_destroy(&arena);
+    });
+}
+
+void perform_set_difference_both(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    (void)data;
+    
+    static const IntervalOp ops[] = { INTERVAL_A_MINUS_B, INTERVAL_B_MINUS_A, INTERVAL_SYM_DIFF };
+    static const LiveResult live_results[] = { LIVE_A_MINUS_B, LIVE_B_MINUS_A, LIVE_SYM_DIFF };
+    static const char *const titles[] = { "差集(A-B)结果", "差集(B-A)结果", "对称差结果" };
+    if (string_mode_active()) {
+        perform_string_operation(widget, ops, titles, 3);
+        return;
+    }
+    // 输入含区间语法时按区间列表运算
+    if (inputs_have_ranges()) {
+        perform_interval_operation(widget, ops, titles, 3);
+        return;
+    }
+    // 实时模式下结果已增量维护
+    if (live_results_ready()) {
+        show_live_results(widget, live_results, titles, 3);
+        return;
+    }
+    
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    Arena arena;
+    arena_init(&arena, 0);
+    IntVec set1, set2;
+    
+    TRY(&error_ctx) {
+        if (!int_vec_init(&set1, &arena, 0) || !int_vec_init(&set2, &arena, 0)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        read_input_sets(&error_ctx, &set1, &set2, false);
+        
+        // 一次归并同时计算 A-B、B-A 和对称差
+        SetMergeResult merged = {
+            .a_minus_b_out = alloc_result(&error_ctx, &arena, set1.size),
+            .b_minus_a_out = alloc_result(&error_ctx, &arena, set2.size),
+            .sym_diff_out = alloc_result(&error_ctx, &arena, set1.size + set2.size)
+        };
+        compute_set_results(&error_ctx, &arena, &set1, &set2, &merged);
+        
+        // 显示结果
+        OutputSection sections[] = {
+            { "差集(A-B)结果", merged.a_minus_b_out, merged.a_minus_b_size },
+            { "差集(B-A)结果", merged.b_minus_a_out, merged.b_minus_a_size },
+            { "对称差结果", merged.sym_diff_out, merged.sym_diff_size }
+        };
+        if (!show_sections(sections, 3)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        }
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        arena_destroy(&arena);
+    });
+}
+
+// 名称由字母、数字、下划线与非ASCII字符组成，不能以数字开头
+static inline bool is_set_name_char(unsigned char c, bool first) {
+    if (c >= 0x80 || c == '_' || isalpha(c)) return true;
+    return !first && isdigit(c);
+}
+
+// 解析行首的“名称 =”“名称:”或“名称：”前缀，返回前缀的字节数（没有前缀时为0）
+static size_t parse_set_name(const char *line, size_t length, size_t *name_start, size_t *name_length) {
+    size_t i = 0;
+    while (i < length && isspace((unsigned char)line[i])) i++;
+    size_t start = i;
+    while (i < length && is_set_name_char((unsigned char)line[i], i == start)) i++;
+    if (i == start) return 0;
+    size_t end = i;
+    while (i < length && isspace((unsigned char)line[i])) i++;
+    
+    if (i < length && (line[i] == '=' || line[i] == ':')) {
+        i++;
+    } else if (i + 3 <= length && memcmp(line + i, "：", 3) == 0) {
+        i += 3;
+    } else {
+        return 0;
+    }
+    *name_start = start;
+    *name_length = end - start;
+    return i;
+}
+
+/**
+ * 读取多集合输入框，每个非空行为一个集合
+ * 参数：
+ *   error_ctx: 错误上下文
+ *   arena: 集合及名称所在的区域分配器
+ *   count: 输出集合个数
+ *   names: 输出各集合的名称，可为NULL；行首写“名称 =”或“名称:”时取该名称，
+ *          否则按顺序命名为S1、S2……；需要名称时允许一个集合也没有
+ * 返回值：
+ *   排序去重后的集合数组
+ */
+static IntVec* read_multi_sets(ErrorContext *error_ctx, Arena *arena, int *count, char ***names) {
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_multi));
+    if (!buffer) {
+        THROW(error_ctx, ERROR_INVALID_OPERATION, "无法获取输入缓冲区");
+    }
+    
+    GtkTextIter start, end;
+    gtk_text_buffer_get_bounds(buffer, &start, &end);
+    char *text = gtk_text_buffer_get_text(buffer, &start, &end, FALSE);
+    if (!text) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    
+    // 行数是集合个数的上界
+    int lines = 1;
+    for (const char *p = text; *p; p++) {
+        if (*p == '\n') lines++;
+    }
+    
+    IntVec *sets = arena_alloc(arena, (size_t)lines * sizeof(IntVec));
+    char **set_names = arena_alloc(arena, (size_t)lines * sizeof(char*));
+    char message[256];
+    ErrorCode code = sets && set_names ? ERROR_NONE : ERROR_MEMORY_ALLOCATION;
+    g_strlcpy(message, "内存分配失败", sizeof(message));
+    
+    int k = 0;
+    int line_number = 0;
+    const char *line = text;
+    while (code == ERROR_NONE && *line) {
+        const char *newline = strchr(line, '\n');
+        size_t length = newline ? (size_t)(newline - line) : strlen(line);
+        line_number++;
+        
+        size_t name_start = 0, name_length = 0;
+        size_t prefix = parse_set_name(line, length, &name_start, &name_length);
+        
+        size_t error_pos = 0;
+        IntParseStatus status = INT_PARSE_FULL;
+        if (int_vec_init(&sets[k], arena, 0)) {
+            status = parse_union_set(line + prefix, length - prefix, &sets[k], &error_pos);
+            error_pos += prefix;
+        }
+        if (status != INT_PARSE_OK) {
+            char name[32];
+            g_snprintf(name, sizeof(name), "第%d行", line_number);
+            code = format_parse_error(message, sizeof(message), name, line, status, error_pos);
+        } else if (sets[k].size > 0 || prefix > 0) {
+            // 未命名的空行不构成集合；命名的空集合可以在表达式中引用
+            sets[k].size = (size_t)sort_unique(sets[k].data, (int)sets[k].size);
+            set_names[k] = prefix > 0 ? arena_alloc(arena, name_length + 1) : arena_alloc(arena, 16);
+            if (!set_names[k]) {
+                code = ERROR_MEMORY_ALLOCATION;
+                g_strlcpy(message, "内存分配失败", sizeof(message));
+            } else if (prefix > 0) {
+                memcpy(set_names[k], line + name_start, name_length);
+                set_names[k][name_length] = '\0';
+            } else {
+                g_snprintf(set_names[k], 16, "S%d", k + 1);
+            }
+            k++;
+        }
+        
+        line = newline ? newline + 1 : line + length;
+    }
+    g_free(text);
+    
+    if (code != ERROR_NONE) {
+        THROW(error_ctx, code, message);
+    }
+    if (k == 0 && !names) {
+        THROW(error_ctx, ERROR_INVALID_INPUT, "请至少输入一个集合（每行一个）");
+    }
+    
+    *count = k;
+    if (names) *names = set_names;
+    return sets;
+}
 
 /**
- * 解析输入字符串为集合
+ * 执行多集合运算
  * 参数：
- *   input: 输入字符串，格式为以空格或逗号分隔的整数
- *   set: 输出数组，用于存储解析后的整数
- * 返回值：
- *   成功返回解析得到的整数个数，失败返回-1
+ *   widget: GTK部件指针
+ *   data: 运算类型（MultiSetOp）
  * 算法原理：
- * 1. 跳过所有空白字符和逗号
- * 2. 使用strtol函数将字符串转换为整数
- * 3. 检查转换是否成功
- * 4. 将成功转换的整数存入数组
+ * 并集、交集与“至少出现在t个集合中”统一为阈值运算（t=1、t=K、t），
+ * 对K个有序集合做一次败者树多路归并，时间复杂度O(N log K)
  */
-static int parse_union_set(const char* input, int* set) {
-    int count = 0;
-    const unsigned char* p = (const unsigned char*)input;
+void perform_multi_set_operation(GtkWidget *widget, gpointer data) {
+    MultiSetOp op = (MultiSetOp)GPOINTER_TO_INT(data);
     
-    while (*p) {
-        // 跳过空白字符和逗号
-        while (*p && (isspace(*p) || *p == ',')) {
-            p++;
-        }
+    ErrorContext error_ctx;
+    init_error_context(&error_ctx);
+    
+    Arena arena;
+    arena_init(&arena, 0);
+    
+    TRY(&error_ctx) {
+        int k = 0;
+        IntVec *sets = read_multi_sets(&error_ctx, &arena, &k, NULL);
         
-        if (!*p) break;
+        int threshold = 1;
+        const char *title = "多集合并集结果";
+        if (op == MULTI_SET_INTERSECTION) {
+            threshold = k;
+            title = "多集合交集结果";
+        } else if (op == MULTI_SET_AT_LEAST) {
+            threshold = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(threshold_spin));
+            title = "至少出现在t个集合中的元素";
+            if (threshold > k) {
+                THROW(&error_ctx, ERROR_INVALID_INPUT, "t不能大于集合个数");
+            }
+        }
         
-        // 转换字符串为整数
-        char* end;
-        int num = strtol((const char*)p, &end, 10);
+        const int **values = arena_alloc(&arena, (size_t)k * sizeof(int*));
+        int *sizes = arena_alloc(&arena, (size_t)k * sizeof(int));
+        if (!values || !sizes) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        for (int i = 0; i < k; i++) {
+            values[i] = sets[i].data;
+            sizes[i] = (int)sets[i].size;
+        }
         
-        // 检查转换是否成功
-        if ((const char*)p == end) {
-            return -1;  // 转换失败
+        int *result = alloc_result(&error_ctx, &arena, set_kway_capacity(sizes, k, threshold));
+        int result_size = set_kway_threshold(values, sizes, k, threshold, result);
+        if (result_size < 0) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
         }
         
-        set[count++] = num;
-        p = (const unsigned char*)end;
+        OutputSection section = { title, result, result_size };
+        if (!show_sections(&section, 1)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        }
     }
-    
-    return count;
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        arena_destroy(&arena);
+    });
 }
 
+// 表达式求值时可引用的集合：多集合输入框中的各行，以及集合1、集合2（名称A、B）
+typedef struct {
+    ErrorContext *error_ctx;
+    Arena *arena;
+    IntVec *sets;
+    char **names;
+    int count;
+    IntVec inputs[2];
+    bool input_read[2];
+} ExprWorkspace;
+
 /**
- * 检查数组中是否包含某个元素
- * 参数：
- *   arr: 要搜索的数组
- *   size: 数组大小
- *   value: 要查找的值
- * 返回值：
- *   找到返回true，否则返回false
- * 算法原理：
- * 使用线性搜索，遍历数组查找指定值
- * 时间复杂度：O(n)
+ * 按名称查找集合，供表达式求值器回调
+ * 说明：
+ * 多集合输入框中的同名集合优先；A、B只在表达式确实引用时才读取和解析。
+ * 读取失败时直接抛出，求值器的全部数据都在区域中，跳出后由调用者统一释放
  */
-static bool contains(const int arr[], int size, int value) {
-    for (int i = 0; i < size; i++) {
-        if (arr[i] == value) {
+static bool resolve_expr_set(void *user_data, const char *name, ExprSet *set) {
+    ExprWorkspace *ws = user_data;
+    for (int i = 0; i < ws->count; i++) {
+        if (strcmp(ws->names[i], name) == 0) {
+            set->values = ws->sets[i].data;
+            set->size = (int)ws->sets[i].size;
             return true;
         }
     }
-    return false;
-}
-
-/**
- * 将整数数组转换为字符串
- * 参数：
- *   arr: 要转换的数组
- *   size: 数组大小
- * 返回值：
- *   转换后的字符串，调用者负责释放内存
- * 算法原理：
- * 1. 为每个数字分配足够的空间（最多12字符，包括符号、数字和分隔符）
- * 2. 使用snprintf安全地转换每个数字
- * 3. 用逗号和空格分隔每个数字
- */
-static char* array_to_string(const int arr[], int size) {
-    char* result = malloc(size * 12 + 1);  // 每个数字最多10位，加上逗号和空格
-    if (!result) return NULL;
     
-    result[0] = '\0';
-    for (int i = 0; i < size; i++) {
-        char temp[12];
-        snprintf(temp, sizeof(temp), "%d", arr[i]);
-        strcat(result, temp);
-        if (i < size - 1) {
-            strcat(result, ", ");
+    int input = strcmp(name, "A") == 0 ? 0 : strcmp(name, "B") == 0 ? 1 : -1;
+    if (input < 0) return false;
+    if (!ws->input_read[input]) {
+        if (!int_vec_init(&ws->inputs[input], ws->arena, 0)) {
+            THROW(ws->error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
         }
+        read_input_set(ws->error_ctx, input, &ws->inputs[input]);
+        ws->input_read[input] = true;
     }
-    return result;
+    set->values = ws->inputs[input].data;
+    set->size = (int)ws->inputs[input].size;
+    return true;
 }
 
 /**
- * 执行集合并集运算
+ * 计算集合表达式
  * 参数：
  *   widget: GTK部件指针
  *   data: 用户数据（未使用）
  * 算法原理：
- * 1. 获取两个输入集合
- * 2. 将第一个集合的所有元素添加到结果中
- * 3. 检查第二个集合的每个元素，如果不在结果中则添加
- * 4. 对结果进行排序
- * 时间复杂度：O(n log n)，主要来自排序步骤
+ * 表达式如 (A ∪ B) ∩ (C − D)，集合名称取自多集合输入框（行首“名称 =”），
+ * A、B默认指集合1、集合2。求值器先合并公共子表达式并按规模估计规划运算顺序，
+ * 交集从最小的运算对象开始、中间结果为空即停止，共享同一对运算对象的运算合并为一次归并；
+ * 规划结果与执行统计显示在统计标签中
  */
-void perform_set_union(GtkWidget *widget, gpointer data) {
-    (void)widget;
+void perform_set_expression(GtkWidget *widget, gpointer data) {
     (void)data;
     
     ErrorContext error_ctx;
     init_error_context(&error_ctx);
     
-    GtkTextBuffer *buffer1 = NULL, *buffer2 = NULL;
-    char *set1_text = NULL, *set2_text = NULL;
-    int *set1 = NULL, *set2 = NULL;
-    char *result_str = NULL;
-    gchar *display = NULL;
+    Arena arena;
+    arena_init(&arena, 0);
     
     TRY(&error_ctx) {
-        buffer1 = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input1));
-        buffer2 = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input2));
-        
-        if (!buffer1 || !buffer2) {
-            THROW(&error_ctx, ERROR_INVALID_OPERATION, "无法获取输入缓冲区");
-        }
-        
-        GtkTextIter start, end;
-        gtk_text_buffer_get_bounds(buffer1, &start, &end);
-        set1_text = gtk_text_buffer_get_text(buffer1, &start, &end, FALSE);
+        const char *expression = gtk_entry_get_text(GTK_ENTRY(expression_entry));
+        ExprWorkspace ws = { .error_ctx = &error_ctx, .arena = &arena };
         
-        gtk_text_buffer_get_bounds(buffer2, &start, &end);
-        set2_text = gtk_text_buffer_get_text(buffer2, &start, &end, FALSE);
+        // 多集合输入框可以为空，此时表达式只能引用A、B
+        ws.sets = read_multi_sets(&error_ctx, &arena, &ws.count, &ws.names);
         
-        if (!set1_text || !set2_text) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        int threads = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(thread_spin));
+        gint64 begin = g_get_monotonic_time();
+        SetExprResult result;
+        char plan[512];
+        char message[256];
+        if (set_expr_evaluate(expression, resolve_expr_set, &ws, &arena, threads, &result,
+                              plan, sizeof(plan), message, sizeof(message)) != 0) {
+            THROW(&error_ctx, ERROR_INVALID_INPUT, message);
         }
+        double ms = (double)(g_get_monotonic_time() - begin) / 1000.0;
         
-        set1 = malloc(MAX_SET_SIZE * sizeof(int));
-        set2 = malloc(MAX_SET_SIZE * sizeof(int));
+        char line[768];
+        g_snprintf(line, sizeof(line), "执行计划：%s\n%d个节点，%d遍归并，%d个结果共享归并，"
+                   "%d个运算对象因中间结果为空而跳过，耗时 %.1f 毫秒",
+                   plan, result.node_count, result.merge_passes, result.fused, result.skipped, ms);
+        gtk_label_set_text(GTK_LABEL(stats_label), line);
         
-        if (!set1 || !set2) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        OutputSection section = { "表达式结果", result.values, result.size };
+        if (!show_sections(&section, 1)) {
+            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
         }
-        
-        int size1 = parse_union_set(set1_text, set1);
-        int size2 = parse_union_set(set2_text, set2);
-        
-        if (size1 < 0 || size2 < 0) {
-            THROW(&error_ctx, ERROR_INVALID_INPUT, "无效输入 - 请输入有效的集合");
+    }
+    CATCH(&error_ctx) {
+        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    }
+    FINALLY({
+        arena_destroy(&arena);
+    });
+}
+
+// 把一个输入流式加入草图：文本按批解析（支持区间语法），二进制文件逐块解码
+// 遇到超过SKETCH_RANGE_LIMIT的长区间时停止并返回false
+static bool sketch_input(ErrorContext *error_ctx, int input, SetSketch *sketch) {
+    if (binary_loaded[input]) {
+        const SetFile *file = &binary_sets[input];
+        int block_values[SET_FILE_BLOCK_VALUES];
+        for (size_t b = 0; b < file->block_count; b++) {
+            int n = set_file_decode_block(file, b, block_values);
+            set_sketch_add(sketch, block_values, (size_t)n);
         }
-        
-        // 合并两个集合
-        int result_size = 0;
-        for (int i = 0; i < size1; i++) {
-            result[result_size++] = set1[i];
+        return true;
+    }
+    
+    char *text = input_text(input);
+    if (!text) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "无法读取输入缓冲区");
+    }
+    
+    size_t length = strlen(text);
+    size_t pos = 0;
+    IntParseStatus status;
+    bool sketched = true;
+    do {
+        size_t count = 0;
+        status = int_parse_ranges(text, length, &pos, range_bounds, INTERVAL_BATCH_SIZE, &count);
+        for (size_t k = 0; k < count && sketched; k++) {
+            sketched = set_sketch_add_range(sketch, range_bounds[2 * k], range_bounds[2 * k + 1]);
         }
-        for (int i = 0; i < size2; i++) {
-            if (!contains(result, result_size, set2[i])) {
-                result[result_size++] = set2[i];
+    } while (status == INT_PARSE_FULL && sketched);
+    
+    if (!sketched) {
+        g_free(text);
+        return false;
+    }
+    finish_input_text(error_ctx, input, text, status, pos);
+    return true;
+}
+
+// 在区间集合末尾追加[lo, hi]，与最后一个区间相邻时直接延长
+static bool append_interval(IntervalSet *set, int lo, int hi) {
+    if (set->size > 0 && set->data[set->size - 1].hi < INT_MAX && set->data[set->size - 1].hi + 1 == lo) {
+        set->data[set->size - 1].hi = hi;
+        return true;
+    }
+    if (!interval_set_reserve(set, set->size + 1)) return false;
+    set->data[set->size++] = (Interval){ lo, hi };
+    return true;
+}
+
+/**
+ * 为草图页的精确计算读取一个输入的区间列表
+ * 返回值：
+ *   区间个数超过SKETCH_EXACT_MAX_INTERVALS时立即停止并返回false
+ * 说明：
+ * 二进制文件逐块解码并直接压缩为连续段，文本按批解析，
+ * 内存只与读入的区间个数有关，不会整体展开输入
+ */
+static bool read_sketch_intervals(ErrorContext *error_ctx, int input, IntervalSet *set) {
+    if (binary_loaded[input]) {
+        const SetFile *file = &binary_sets[input];
+        int block_values[SET_FILE_BLOCK_VALUES];
+        for (size_t b = 0; b < file->block_count; b++) {
+            int n = set_file_decode_block(file, b, block_values);
+            for (int k = 0; k < n; k++) {
+                if (!append_interval(set, block_values[k], block_values[k])) {
+                    THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+                }
             }
+            if (set->size > SKETCH_EXACT_MAX_INTERVALS) return false;
         }
-        
-        // 对结果排序
-        sort_array(result, result_size);
-        
-        // 显示结果
-        result_str = array_to_string(result, result_size);
-        if (!result_str) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
+        return true;
+    }
+    
+    char *text = input_text(input);
+    if (!text) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "无法读取输入缓冲区");
+    }
+    
+    size_t length = strlen(text);
+    size_t pos = 0;
+    IntParseStatus status;
+    do {
+        size_t count = 0;
+        status = int_parse_ranges(text, length, &pos, range_bounds, INTERVAL_BATCH_SIZE, &count);
+        if (set->size + count > SKETCH_EXACT_MAX_INTERVALS) {
+            g_free(text);
+            return false;
         }
-        
-        display = g_strdup_printf("并集结果：{%s}", result_str);
-        if (!display) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成显示字符串");
+        if (!interval_set_reserve(set, set->size + count)) {
+            g_free(text);
+            THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
         }
-        
-        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
-        gtk_text_buffer_set_text(buffer, display, -1);
+        for (size_t k = 0; k < count; k++) {
+            set->data[set->size++] = (Interval){ range_bounds[2 * k], range_bounds[2 * k + 1] };
+        }
+    } while (status == INT_PARSE_FULL);
+    
+    finish_input_text(error_ctx, input, text, status, pos);
+    interval_set_normalize(set);
+    return true;
+}
+
+/**
+ * 输入含长区间时，按区间列表精确求出草图页需要的各项结果
+ * 参数：
+ *   arena: 区间列表所用的区域
+ *   items: 输出两个输入的元素个数（区间已合并，即不同元素个数）
+ * 返回值：
+ *   任一输入超过SKETCH_EXACT_MAX_INTERVALS个区间时返回false，不给出结果
+ * 算法原理：
+ * 与区间模式相同，解析为规范化的区间列表后求并与交，
+ * 只计算区间端点，耗时与区间长度无关，结果没有误差；
+ * 区间个数设有上限，内存仍与输入规模无关
+ */
+static bool interval_estimate(ErrorContext *error_ctx, Arena *arena, SketchEstimate *out, long long items[2]) {
+    IntervalSet sets[2], united, common;
+    for (int i = 0; i < 2; i++) {
+        if (!interval_set_init(&sets[i], arena, 0)) {
+            THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
+        }
+        if (!read_sketch_intervals(error_ctx, i, &sets[i])) {
+            return false;
+        }
+        items[i] = interval_set_count(&sets[i]);
     }
-    CATCH(&error_ctx) {
-        handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
+    if (!interval_set_init(&united, arena, 0) || !interval_set_init(&common, arena, 0) ||
+        !interval_set_op(&sets[0], &sets[1], INTERVAL_UNION, &united) ||
+        !interval_set_op(&sets[0], &sets[1], INTERVAL_INTERSECTION, &common)) {
+        THROW(error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
     }
-    FINALLY({
-        g_free(set1_text);
-        g_free(set2_text);
-        free(set1);
-        free(set2);
-        free(result_str);
-        g_free(display);
-    });
+    
+    memset(out, 0, sizeof(*out));
+    out->exact = true;
+    out->card_a = (double)items[0];
+    out->card_b = (double)items[1];
+    out->card_union = (double)interval_set_count(&united);
+    out->card_intersection = (double)interval_set_count(&common);
+    out->jaccard = out->card_union > 0 ? out->card_intersection / out->card_union : 0.0;
+    return true;
 }
 
-void perform_set_intersection(GtkWidget *widget, gpointer data) {
-    (void)widget;
+/**
+ * 用草图估算两个集合的基数与相似度
+ * 参数：
+ *   widget: GTK部件指针
+ *   data: 用户数据（未使用）
+ * 算法原理：
+ * 输入逐批流过HyperLogLog（估算基数）与bottom-k MinHash（估算Jaccard相似度），
+ * 不构造、不排序、不输出任何集合，内存占用是与输入大小无关的常数；
+ * |A∪B|由合并后的HyperLogLog估算，|A∩B| ≈ J * |A∪B|。
+ * 区间只在长度不超过SKETCH_RANGE_LIMIT时逐个哈希，出现更长的区间时
+ * 改用区间列表精确计算，耗时只与区间个数有关；
+ * 区间个数超过SKETCH_EXACT_MAX_INTERVALS时拒绝估算，请改用区间模式
+ */
+void perform_set_sketch(GtkWidget *widget, gpointer data) {
     (void)data;
     
     ErrorContext error_ctx;
     init_error_context(&error_ctx);
     
-    GtkTextBuffer *buffer1 = NULL, *buffer2 = NULL;
-    char *set1_text = NULL, *set2_text = NULL;
-    int *set1 = NULL, *set2 = NULL;
-    char *result_str = NULL;
-    gchar *display = NULL;
+    SetSketch *sketches = g_try_malloc(2 * sizeof(SetSketch));
+    gchar *report = NULL;
+    Arena arena;
+    arena_init(&arena, 0);
     
     TRY(&error_ctx) {
-        buffer1 = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input1));
-        buffer2 = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input2));
-        
-        if (!buffer1 || !buffer2) {
-            THROW(&error_ctx, ERROR_INVALID_OPERATION, "无法获取输入缓冲区");
-        }
-        
-        GtkTextIter start, end;
-        gtk_text_buffer_get_bounds(buffer1, &start, &end);
-        set1_text = gtk_text_buffer_get_text(buffer1, &start, &end, FALSE);
-        
-        gtk_text_buffer_get_bounds(buffer2, &start, &end);
-        set2_text = gtk_text_buffer_get_text(buffer2, &start, &end, FALSE);
-        
-        if (!set1_text || !set2_text) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
-        }
-        
-        set1 = malloc(MAX_SET_SIZE * sizeof(int));
-        set2 = malloc(MAX_SET_SIZE * sizeof(int));
-        
-        if (!set1 || !set2) {
+        if (!sketches) {
             THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
         }
-        
-        int size1 = parse_union_set(set1_text, set1);
-        int size2 = parse_union_set(set2_text, set2);
-        
-        if (size1 < 0 || size2 < 0) {
-            THROW(&error_ctx, ERROR_INVALID_INPUT, "无效输入 - 请输入有效的集合");
+        gint64 start = g_get_monotonic_time();
+        bool sketched = true;
+        for (int i = 0; i < 2 && sketched; i++) {
+            set_sketch_init(&sketches[i]);
+            sketched = sketch_input(&error_ctx, i, &sketches[i]);
         }
         
-        // 计算交集
-        int result_size = 0;
-        for (int i = 0; i < size1; i++) {
-            if (contains(set2, size2, set1[i])) {
-                result[result_size++] = set1[i];
+        // 含长区间时逐个哈希太慢，改按区间列表精确计算
+        SketchEstimate e;
+        long long items[2];
+        const char *note;
+        if (sketched) {
+            set_sketch_estimate(&sketches[0], &sketches[1], &e);
+            items[0] = sketches[0].items;
+            items[1] = sketches[1].items;
+            note = e.exact ? "：两个集合都很小，结果精确" : "";
+        } else {
+            if (!interval_estimate(&error_ctx, &arena, &e, items)) {
+                THROW(&error_ctx, ERROR_INVALID_INPUT,
+                      "输入含长区间且区间过多（超过2^20个），无法估算；请改用区间模式计算");
             }
+            note = "：输入含长区间，已按区间列表精确计算";
         }
+        double ms = (double)(g_get_monotonic_time() - start) / 1000.0;
         
-        // 对结果排序
-        sort_array(result, result_size);
-        
-        // 显示结果
-        result_str = array_to_string(result, result_size);
-        if (!result_str) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
-        }
-        
-        display = g_strdup_printf("交集结果：{%s}", result_str);
-        if (!display) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成显示字符串");
-        }
-        
-        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
-        gtk_text_buffer_set_text(buffer, display, -1);
+        report = g_strdup_printf("草图估算（HyperLogLog 2^%d 个寄存器，MinHash k=%d，草图共 %zu KB）%s\n"
+                                 "|A| ≈ %.0f（±%.0f），输入 %lld 个元素\n"
+                                 "|B| ≈ %.0f（±%.0f），输入 %lld 个元素\n"
+                                 "|A∪B| ≈ %.0f（±%.0f）\n"
+                                 "|A∩B| ≈ %.0f（±%.0f）\n"
+                                 "Jaccard(A, B) ≈ %.4f（±%.4f）\n"
+                                 "误差为95%%置信区间的半宽，耗时 %.1f 毫秒",
+                                 HLL_PRECISION, MINHASH_K, 2 * sizeof(SetSketch) / 1024,
+                                 note,
+                                 e.card_a, e.card_error_a, items[0],
+                                 e.card_b, e.card_error_b, items[1],
+                                 e.card_union, e.union_error,
+                                 e.card_intersection, e.intersection_error,
+                                 e.jaccard, e.jaccard_error, ms);
+        show_result(report);
     }
     CATCH(&error_ctx) {
         handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
     }
     FINALLY({
-        g_free(set1_text);
-        g_free(set2_text);
-        free(set1);
-        free(set2);
-        free(result_str);
-        g_free(display);
+        g_free(sketches);
+        g_free(report);
+        arena_destroy(&arena);
     });
 }
 
-void perform_set_difference_both(GtkWidget *widget, gpointer data) {
-    (void)widget;
+/**
+ * 运行集合运算内核的性能测试并显示报告
+ * 参数：
+ *   widget: GTK部件指针
+ *   data: 用户数据（未使用）
+ * 说明：
+ * 测试需要数秒，在工作线程中运行；期间按钮不可用，界面保持响应
+ */
+void perform_set_benchmark(GtkWidget *widget, gpointer data) {
+    (void)data;
+    background_report_start(widget, set_benchmark_report,
+                            gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(thread_spin)),
+                            show_result, "正在运行性能测试…");
+}
+
+// 后台大文件运算的任务：运算在工作线程中进行，结果经g_idle_add回到主线程显示
+typedef struct {
+    gchar *path_a;
+    gchar *path_b;
+    gchar *out_path;
+    ExternalOp op;
+    ExternalOptions options;
+    GtkWidget *button;          // 运算期间不可用
+    ExternalStats stats;
+    int status;
+    double seconds;
+    char message[256];
+} ExternalJob;
+
+// 工作线程：执行外部集合运算
+static void external_work(gpointer data) {
+    ExternalJob *job = data;
+    gint64 start = g_get_monotonic_time();
+    job->status = external_set_operation(job->path_a, job->path_b, job->out_path, job->op,
+                                         &job->options, &job->stats,
+                                         job->message, sizeof(job->message));
+    job->seconds = (double)(g_get_monotonic_time() - start) / 1e6;
+}
+
+// 主线程：显示统计或错误，恢复按钮并释放任务
+static gboolean external_finished_idle(gpointer data) {
+    ExternalJob *job = data;
+    gtk_widget_set_sensitive(job->button, TRUE);
+    if (job->status == 0) {
+        gchar *display = g_strdup_printf("大文件运算完成，结果已写入：%s\n"
+                                         "A：%lld 个元素（%d 个有序段）\n"
+                                         "B：%lld 个元素（%d 个有序段）\n"
+                                         "结果：%lld 个元素，耗时 %.2f 秒",
+                                         job->out_path, job->stats.count_a, job->stats.runs_a,
+                                         job->stats.count_b, job->stats.runs_b,
+                                         job->stats.count_out, job->seconds);
+        show_result(display);
+        g_free(display);
+    } else {
+        handle_error(gtk_widget_get_toplevel(job->button), ERROR_SYSTEM, job->message);
+    }
+    g_free(job->path_a);
+    g_free(job->path_b);
+    g_free(job->out_path);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * 对两个整数文件执行外部集合运算
+ * 参数：
+ *   widget: GTK部件指针
+ *   data: 用户数据（未使用）
+ * 算法原理：
+ * 输入文件以mmap映射，经外部排序与多路归并得到有序去重流，
+ * 运算结果直接写入用户选择的输出文件，内存占用受预算限制；
+ * 输出格式与输入格式相同，输出框只显示统计信息
+ * 说明：
+ * 大文件运算可能需要数分钟，在工作线程中运行；期间按钮不可用，界面保持响应
+ */
+void perform_external_set_operation(GtkWidget *widget, gpointer data) {
     (void)data;
     
+    gchar *path_a = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(file_chooser_a));
+    gchar *path_b = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(file_chooser_b));
+    
+    if (!path_a || !path_b) {
+        handle_error(gtk_widget_get_toplevel(widget), ERROR_INVALID_INPUT, "请先选择集合A和集合B的输入文件");
+        g_free(path_a);
+        g_free(path_b);
+        return;
+    }
+    
+    // 用户取消保存时不做任何操作
+    gchar *out_path = choose_output_file(gtk_widget_get_toplevel(widget), "保存运算结果");
+    if (!out_path) {
+        g_free(path_a);
+        g_free(path_b);
+        return;
+    }
+    
+    ExternalFormat format = (ExternalFormat)gtk_combo_box_get_active(GTK_COMBO_BOX(file_format_combo));
+    ExternalJob *job = g_new0(ExternalJob, 1);
+    job->path_a = path_a;
+    job->path_b = path_b;
+    job->out_path = out_path;
+    job->op = (ExternalOp)gtk_combo_box_get_active(GTK_COMBO_BOX(file_op_combo));
+    job->options.input_format = format;
+    job->options.output_format = format;
+    job->options.memory_budget = EXTERNAL_DEFAULT_MEMORY_BUDGET;
+    job->button = widget;
+    
+    if (!background_task_start(external_work, external_finished_idle, job)) {
+        handle_error(gtk_widget_get_toplevel(widget), ERROR_SYSTEM, "无法创建工作线程");
+        g_free(path_a);
+        g_free(path_b);
+        g_free(out_path);
+        g_free(job);
+        return;
+    }
+    gtk_widget_set_sensitive(widget, FALSE);
+    show_result("正在执行大文件运算…");
+}
+
+// 弹出打开对话框选择输入文件，取消时返回NULL
+static gchar* choose_input_file(GtkWidget *parent, const char *title) {
+    GtkWidget *dialog = gtk_file_chooser_dialog_new(title,
+                                                    GTK_WINDOW(parent),
+                                                    GTK_FILE_CHOOSER_ACTION_OPEN,
+                                                    "取消", GTK_RESPONSE_CANCEL,
+                                                    "打开", GTK_RESPONSE_ACCEPT,
+                                                    NULL);
+
+    gchar *filename = NULL;
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+    }
+    gtk_widget_destroy(dialog);
+    return filename;
+}
+
+// 卸载输入上的二进制集合，恢复文本输入
+static void unload_binary_set(int input) {
+    if (!binary_loaded[input]) return;
+    set_file_close(&binary_sets[input]);
+    binary_loaded[input] = false;
+    on_input_changed(NULL, GINT_TO_POINTER(input));
+    gtk_widget_set_sensitive(input == 0 ? text_view_input1 : text_view_input2, TRUE);
+    gtk_label_set_text(GTK_LABEL(binary_labels[input]), "");
+}
+
+/**
+ * 为一个输入载入二进制集合文件
+ * 参数：
+ *   widget: GTK部件指针
+ *   data: 输入下标（0或1）
+ * 说明：
+ * 文件只映射并检查索引，运算时才按需解码；载入期间文本框变为只读
+ */
+void perform_binary_set_load(GtkWidget *widget, gpointer data) {
+    int input = GPOINTER_TO_INT(data);
+    GtkWidget *parent = gtk_widget_get_toplevel(widget);
+    
+    gchar *path = choose_input_file(parent, input == 0 ? "载入集合1" : "载入集合2");
+    if (!path) return;
+    
+    SetFile file;
+    char message[256];
+    if (set_file_open(&file, path, message, sizeof(message)) != 0) {
+        handle_error(parent, ERROR_SYSTEM, message);
+        g_free(path);
+        return;
+    }
+    
+    unload_binary_set(input);
+    binary_sets[input] = file;
+    binary_loaded[input] = true;
+    on_input_changed(NULL, data);
+    gtk_widget_set_sensitive(input == 0 ? text_view_input1 : text_view_input2, FALSE);
+    
+    gchar *name = g_path_get_basename(path);
+    gchar *line = g_strdup_printf("已载入 %s：%lld 个元素，%zu 块，%.2f 位/元素",
+                                  name, file.count, file.block_count,
+                                  file.count ? file.map_size * 8.0 / file.count : 0.0);
+    gtk_label_set_text(GTK_LABEL(binary_labels[input]), line);
+    g_free(line);
+    g_free(name);
+    g_free(path);
+}
+
+// 卸载二进制集合，data为输入下标
+void perform_binary_set_unload(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    unload_binary_set(GPOINTER_TO_INT(data));
+}
+
+/**
+ * 把一个输入的集合保存为二进制集合文件
+ * 参数：
+ *   widget: GTK部件指针
+ *   data: 输入下标（0或1）
+ * 算法原理：
+ * 集合按升序分块，块内差值按位紧密打包并记录每块的最小、最大值，
+ * 之后载入时无需经过文本解析
+ */
+void perform_binary_set_save(GtkWidget *widget, gpointer data) {
+    int input = GPOINTER_TO_INT(data);
+    
     ErrorContext error_ctx;
     init_error_context(&error_ctx);
     
-    GtkTextBuffer *buffer1 = NULL, *buffer2 = NULL;
-    char *set1_text = NULL, *set2_text = NULL;
-    int *set1 = NULL, *set2 = NULL;
-    char *result_str_ab = NULL, *result_str_ba = NULL;
-    gchar *display = NULL;
-    int result_ab[MAX_SET_SIZE], result_ba[MAX_SET_SIZE];
+    Arena arena;
+    arena_init(&arena, 0);
+    IntVec set;
+    gchar *path = NULL;
     
     TRY(&error_ctx) {
-        // 获取输入
-        buffer1 = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input1));
-        buffer2 = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input2));
-        
-        if (!buffer1 || !buffer2) {
-            THROW(&error_ctx, ERROR_INVALID_OPERATION, "无法获取输入缓冲区");
-        }
-        
-        GtkTextIter start, end;
-        gtk_text_buffer_get_bounds(buffer1, &start, &end);
-        set1_text = gtk_text_buffer_get_text(buffer1, &start, &end, FALSE);
-        
-        gtk_text_buffer_get_bounds(buffer2, &start, &end);
-        set2_text = gtk_text_buffer_get_text(buffer2, &start, &end, FALSE);
-        
-        if (!set1_text || !set2_text) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
-        }
-        
-        set1 = malloc(MAX_SET_SIZE * sizeof(int));
-        set2 = malloc(MAX_SET_SIZE * sizeof(int));
-        
-        if (!set1 || !set2) {
+        if (!int_vec_init(&set, &arena, 0)) {
             THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "内存分配失败");
         }
+        read_input_set(&error_ctx, input, &set);
         
-        int size1 = parse_union_set(set1_text, set1);
-        int size2 = parse_union_set(set2_text, set2);
-        
-        if (size1 < 0 || size2 < 0) {
-            THROW(&error_ctx, ERROR_INVALID_INPUT, "无效输入 - 请输入有效的集合");
-        }
-        
-        // 计算 A-B
-        int result_size_ab = 0;
-        for (int i = 0; i < size1; i++) {
-            if (!contains(set2, size2, set1[i])) {
-                result_ab[result_size_ab++] = set1[i];
-            }
-        }
-        
-        // 计算 B-A
-        int result_size_ba = 0;
-        for (int i = 0; i < size2; i++) {
-            if (!contains(set1, size1, set2[i])) {
-                result_ba[result_size_ba++] = set2[i];
+        // 用户取消保存时不做任何操作
+        path = choose_output_file(gtk_widget_get_toplevel(widget), "保存为二进制集合文件");
+        if (path) {
+            char message[256];
+            size_t file_size;
+            if (set_file_save(path, set.data, (int)set.size, &file_size, message, sizeof(message)) != 0) {
+                THROW(&error_ctx, ERROR_SYSTEM, message);
             }
+            gchar *line = g_strdup_printf("集合%d已保存：%zu 个元素，%zu 字节，%.2f 位/元素",
+                                          input + 1, set.size, file_size,
+                                          set.size ? file_size * 8.0 / set.size : 0.0);
+            gtk_label_set_text(GTK_LABEL(stats_label), line);
+            g_free(line);
         }
-        
-        // 对结果排序
-        sort_array(result_ab, result_size_ab);
-        sort_array(result_ba, result_size_ba);
-        
-        // 生成结果字符串
-        result_str_ab = array_to_string(result_ab, result_size_ab);
-        result_str_ba = array_to_string(result_ba, result_size_ba);
-        
-        if (!result_str_ab || !result_str_ba) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成结果字符串");
-        }
-        
-        display = g_strdup_printf("差集(A-B)结果：{%s}\n差集(B-A)结果：{%s}", 
-                                result_str_ab, result_str_ba);
-        if (!display) {
-            THROW(&error_ctx, ERROR_MEMORY_ALLOCATION, "无法生成显示字符串");
-        }
-        
-        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_output));
-        gtk_text_buffer_set_text(buffer, display, -1);
     }
     CATCH(&error_ctx) {
         handle_error(gtk_widget_get_toplevel(widget), error_ctx.code, error_ctx.message);
     }
     FINALLY({
-        g_free(set1_text);
-        g_free(set2_text);
-        free(set1);
-        free(set2);
-        free(result_str_ab);
-        free(result_str_ba);
-        g_free(display);
+        g_free(path);
+        arena_destroy(&arena);
     });
 }
 
+// 创建一个输入区域：文本框及二进制集合文件的载入、保存按钮
+static GtkWidget* create_input_frame(const char *title, int input, GtkWidget **text_view) {
+    GtkWidget *frame = gtk_frame_new(title);
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_container_add(GTK_CONTAINER(frame), box);
+
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_box_pack_start(GTK_BOX(box), scroll, TRUE, TRUE, 0);
+    *text_view = gtk_text_view_new();
+    gtk_container_add(GTK_CONTAINER(scroll), *text_view);
+
+    GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    gtk_box_pack_start(GTK_BOX(box), button_box, FALSE, FALSE, 0);
+
+    GtkWidget *load_button = gtk_button_new_with_label("载入二进制...");
+    GtkWidget *save_button = gtk_button_new_with_label("保存为二进制...");
+    GtkWidget *unload_button = gtk_button_new_with_label("卸载");
+    binary_labels[input] = gtk_label_new("");
+
+    gtk_box_pack_start(GTK_BOX(button_box), load_button, FALSE, FALSE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), save_button, FALSE, FALSE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), unload_button, FALSE, FALSE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), binary_labels[input], FALSE, FALSE, 5);
+
+    g_signal_connect(load_button, "clicked", G_CALLBACK(perform_binary_set_load), GINT_TO_POINTER(input));
+    g_signal_connect(save_button, "clicked", G_CALLBACK(perform_binary_set_save), GINT_TO_POINTER(input));
+    g_signal_connect(unload_button, "clicked", G_CALLBACK(perform_binary_set_unload), GINT_TO_POINTER(input));
+
+    return frame;
+}
+
+// 创建多集合模式区域
+static GtkWidget* create_multi_set_frame(void) {
+    GtkWidget *frame = gtk_frame_new("多集合模式（每行一个集合，可写作“C = 1, 2, 3”命名）");
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_container_set_border_width(GTK_CONTAINER(box), 5);
+    gtk_container_add(GTK_CONTAINER(frame), box);
+
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_widget_set_size_request(scroll, -1, 80);
+    gtk_box_pack_start(GTK_BOX(box), scroll, TRUE, TRUE, 0);
+    text_view_multi = gtk_text_view_new();
+    gtk_container_add(GTK_CONTAINER(scroll), text_view_multi);
+
+    GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    gtk_box_pack_start(GTK_BOX(box), button_box, FALSE, FALSE, 0);
+
+    GtkWidget *union_button = gtk_button_new_with_label("多集合并集");
+    GtkWidget *intersection_button = gtk_button_new_with_label("多集合交集");
+    GtkWidget *at_least_button = gtk_button_new_with_label("至少出现在t个集合中");
+    threshold_spin = gtk_spin_button_new_with_range(1, 1000000, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(threshold_spin), 2);
+
+    gtk_box_pack_start(GTK_BOX(button_box), union_button, TRUE, TRUE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), intersection_button, TRUE, TRUE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), at_least_button, TRUE, TRUE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), gtk_label_new("t："), FALSE, FALSE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), threshold_spin, FALSE, FALSE, 5);
+
+    g_signal_connect(union_button, "clicked", G_CALLBACK(perform_multi_set_operation),
+                     GINT_TO_POINTER(MULTI_SET_UNION));
+    g_signal_connect(intersection_button, "clicked", G_CALLBACK(perform_multi_set_operation),
+                     GINT_TO_POINTER(MULTI_SET_INTERSECTION));
+    g_signal_connect(at_least_button, "clicked", G_CALLBACK(perform_multi_set_operation),
+                     GINT_TO_POINTER(MULTI_SET_AT_LEAST));
+
+    // 集合表达式：A、B指集合1、集合2，其余名称取自上面的各行
+    GtkWidget *expr_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    gtk_box_pack_start(GTK_BOX(box), expr_box, FALSE, FALSE, 0);
+
+    expression_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(expression_entry), "如 (A ∪ B) ∩ (C − D)，也可写作 (A | B) & (C - D)");
+    GtkWidget *expr_button = gtk_button_new_with_label("计算表达式");
+
+    gtk_box_pack_start(GTK_BOX(expr_box), gtk_label_new("表达式："), FALSE, FALSE, 5);
+    gtk_box_pack_start(GTK_BOX(expr_box), expression_entry, TRUE, TRUE, 5);
+    gtk_box_pack_start(GTK_BOX(expr_box), expr_button, FALSE, FALSE, 5);
+
+    g_signal_connect(expr_button, "clicked", G_CALLBACK(perform_set_expression), NULL);
+    g_signal_connect(expression_entry, "activate", G_CALLBACK(perform_set_expression), NULL);
+
+    return frame;
+}
+
+// 创建大文件模式区域
+static GtkWidget* create_file_mode_frame(void) {
+    GtkWidget *frame = gtk_frame_new("大文件模式（mmap + 外部排序）");
+    GtkWidget *grid = gtk_grid_new();
+    gtk_grid_set_row_spacing(GTK_GRID(grid), 5);
+    gtk_grid_set_column_spacing(GTK_GRID(grid), 10);
+    gtk_container_set_border_width(GTK_CONTAINER(grid), 5);
+    gtk_container_add(GTK_CONTAINER(frame), grid);
+
+    file_chooser_a = gtk_file_chooser_button_new("选择集合A文件", GTK_FILE_CHOOSER_ACTION_OPEN);
+    file_chooser_b = gtk_file_chooser_button_new("选择集合B文件", GTK_FILE_CHOOSER_ACTION_OPEN);
+
+    // 选项顺序与 ExternalFormat / ExternalOp 枚举一致
+    file_format_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_format_combo), "文本");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_format_combo), "int32二进制");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_format_combo), "int64二进制");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(file_format_combo), 0);
+
+    file_op_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_op_combo), "并集");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_op_combo), "交集");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_op_combo), "差集(A-B)");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_op_combo), "差集(B-A)");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(file_op_combo), "对称差");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(file_op_combo), 0);
+
+    GtkWidget *run_button = gtk_button_new_with_label("运行并保存结果...");
+    g_signal_connect(run_button, "clicked", G_CALLBACK(perform_external_set_operation), NULL);
+
+    gtk_grid_attach(GTK_GRID(grid), gtk_label_new("集合A："), 0, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), file_chooser_a, 1, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), gtk_label_new("集合B："), 2, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), file_chooser_b, 3, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), gtk_label_new("格式："), 0, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), file_format_combo, 1, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), gtk_label_new("运算："), 2, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), file_op_combo, 3, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), run_button, 4, 0, 1, 2);
+
+    return frame;
+}
+
 GtkWidget* create_union_page(void) {
     GtkWidget *page = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
     gtk_container_set_border_width(GTK_CONTAINER(page), 15);
@@ -402,27 +2183,15 @@ GtkWidget* create_union_page(void) {
     gtk_box_pack_start(GTK_BOX(page), title, FALSE, FALSE, 10);
 
     // 创建说明文本
-    GtkWidget *description = gtk_label_new("输入两个集合进行并集、交集、差集运算");
+    GtkWidget *description = gtk_label_new("输入两个集合进行并集、交集、差集运算（支持区间写法，如 1-1000000；勾选“字符串集合”可对单词运算）");
     gtk_style_context_add_class(gtk_widget_get_style_context(description), "description");
     gtk_box_pack_start(GTK_BOX(page), description, FALSE, FALSE, 5);
 
     // 创建输入区域1
-    GtkWidget *input_frame1 = gtk_frame_new("集合1");
-    gtk_box_pack_start(GTK_BOX(page), input_frame1, TRUE, TRUE, 5);
-
-    GtkWidget *input_scroll1 = gtk_scrolled_window_new(NULL, NULL);
-    gtk_container_add(GTK_CONTAINER(input_frame1), input_scroll1);
-    text_view_input1 = gtk_text_view_new();
-    gtk_container_add(GTK_CONTAINER(input_scroll1), text_view_input1);
+    gtk_box_pack_start(GTK_BOX(page), create_input_frame("集合1", 0, &text_view_input1), TRUE, TRUE, 5);
 
     // 创建输入区域2
-    GtkWidget *input_frame2 = gtk_frame_new("集合2");
-    gtk_box_pack_start(GTK_BOX(page), input_frame2, TRUE, TRUE, 5);
-
-    GtkWidget *input_scroll2 = gtk_scrolled_window_new(NULL, NULL);
-    gtk_container_add(GTK_CONTAINER(input_frame2), input_scroll2);
-    text_view_input2 = gtk_text_view_new();
-    gtk_container_add(GTK_CONTAINER(input_scroll2), text_view_input2);
+    gtk_box_pack_start(GTK_BOX(page), create_input_frame("集合2", 1, &text_view_input2), TRUE, TRUE, 5);
 
     // 创建按钮区域
     GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
@@ -431,14 +2200,50 @@ GtkWidget* create_union_page(void) {
     GtkWidget *union_button = gtk_button_new_with_label("并集");
     GtkWidget *intersection_button = gtk_button_new_with_label("交集");
     GtkWidget *difference_button = gtk_button_new_with_label("差集(A-B和B-A)");
+    GtkWidget *sketch_button = gtk_button_new_with_label("草图估算");
+    GtkWidget *benchmark_button = gtk_button_new_with_label("性能测试");
 
     gtk_box_pack_start(GTK_BOX(button_box), union_button, TRUE, TRUE, 5);
     gtk_box_pack_start(GTK_BOX(button_box), intersection_button, TRUE, TRUE, 5);
     gtk_box_pack_start(GTK_BOX(button_box), difference_button, TRUE, TRUE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), sketch_button, TRUE, TRUE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), benchmark_button, TRUE, TRUE, 5);
+
+    // 线程数默认等于处理器个数，输入较小时仍按单线程归并
+    thread_spin = gtk_spin_button_new_with_range(1, SET_PARALLEL_MAX_THREADS, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(thread_spin), set_parallel_default_threads());
+    gtk_box_pack_start(GTK_BOX(button_box), gtk_label_new("线程数："), FALSE, FALSE, 5);
+    gtk_box_pack_start(GTK_BOX(button_box), thread_spin, FALSE, FALSE, 5);
+
+    live_check = gtk_check_button_new_with_label("实时模式");
+    gtk_box_pack_start(GTK_BOX(button_box), live_check, FALSE, FALSE, 5);
+    g_signal_connect(live_check, "toggled", G_CALLBACK(perform_live_mode_toggled), NULL);
+
+    bloom_check = gtk_check_button_new_with_label("布隆过滤");
+    gtk_box_pack_start(GTK_BOX(button_box), bloom_check, FALSE, FALSE, 5);
+
+    string_check = gtk_check_button_new_with_label("字符串集合");
+    gtk_box_pack_start(GTK_BOX(button_box), string_check, FALSE, FALSE, 5);
+
+    // 布隆过滤统计
+    stats_label = gtk_label_new("");
+    gtk_box_pack_start(GTK_BOX(page), stats_label, FALSE, FALSE, 0);
+    g_signal_connect(gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input1)), "changed",
+                     G_CALLBACK(on_input_changed), GINT_TO_POINTER(0));
+    g_signal_connect(gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view_input2)), "changed",
+                     G_CALLBACK(on_input_changed), GINT_TO_POINTER(1));
 
     g_signal_connect(union_button, "clicked", G_CALLBACK(perform_set_union), NULL);
     g_signal_connect(intersection_button, "clicked", G_CALLBACK(perform_set_intersection), NULL);
     g_signal_connect(difference_button, "clicked", G_CALLBACK(perform_set_difference_both), NULL);
+    g_signal_connect(sketch_button, "clicked", G_CALLBACK(perform_set_sketch), NULL);
+    g_signal_connect(benchmark_button, "clicked", G_CALLBACK(perform_set_benchmark), NULL);
+
+    // 创建多集合模式区域
+    gtk_box_pack_start(GTK_BOX(page), create_multi_set_frame(), FALSE, FALSE, 5);
+
+    // 创建大文件模式区域
+    gtk_box_pack_start(GTK_BOX(page), create_file_mode_frame(), FALSE, FALSE, 5);
 
     // 创建输出区域
     GtkWidget *output_frame = gtk_frame_new("运算结果");
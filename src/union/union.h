@@ -3,8 +3,6 @@
 
 #include <gtk/gtk.h>
 
-#define MAX_SET_SIZE 1000
-
 // 声明全局变量
 extern GtkWidget *text_view_input1;
 extern GtkWidget *text_view_input2;
@@ -14,6 +12,15 @@ extern GtkWidget *text_view_output;
 void perform_set_union(GtkWidget *widget, gpointer data);
 void perform_set_intersection(GtkWidget *widget, gpointer data);
 void perform_set_difference_both(GtkWidget *widget, gpointer data);
+void perform_live_mode_toggled(GtkWidget *widget, gpointer data);
+void perform_multi_set_operation(GtkWidget *widget, gpointer data);
+void perform_set_expression(GtkWidget *widget, gpointer data);
+void perform_set_sketch(GtkWidget *widget, gpointer data);
+void perform_set_benchmark(GtkWidget *widget, gpointer data);
+void perform_external_set_operation(GtkWidget *widget, gpointer data);
+void perform_binary_set_load(GtkWidget *widget, gpointer data);
+void perform_binary_set_unload(GtkWidget *widget, gpointer data);
+void perform_binary_set_save(GtkWidget *widget, gpointer data);
 GtkWidget* create_union_page(void);
 
 #endif
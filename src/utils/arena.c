@@ -0,0 +1,106 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGNMENT 16
+
+// 向上对齐到 ARENA_ALIGNMENT
+static size_t align_up(size_t n) {
+    return (n + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// 块头之后的数据区起始地址
+static unsigned char* block_data(ArenaBlock *block) {
+    return (unsigned char*)block + align_up(sizeof(ArenaBlock));
+}
+
+// 初始化区域分配器，block_size为0时使用默认值
+void arena_init(Arena *arena, size_t block_size) {
+    arena->head = NULL;
+    arena->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+}
+
+// 申请一个至少能容纳size字节的新块并挂到链表头部
+static ArenaBlock* new_block(Arena *arena, size_t size) {
+    size_t capacity = arena->block_size;
+    if (capacity < size) {
+        capacity = size;
+    }
+
+    ArenaBlock *block = malloc(align_up(sizeof(ArenaBlock)) + capacity);
+    if (!block) return NULL;
+
+    block->next = arena->head;
+    block->capacity = capacity;
+    block->used = 0;
+    arena->head = block;
+    return block;
+}
+
+/**
+ * 从区域中分配内存
+ * 参数：
+ *   arena: 区域分配器
+ *   size: 需要的字节数
+ * 返回值：
+ *   16字节对齐的内存地址，失败返回NULL；内存不需要单独释放
+ * 算法原理：
+ * 在当前块中顺序切分（指针碰撞），空间不足时申请新块，
+ * 超过默认块大小的请求独占一个块
+ */
+void* arena_alloc(Arena *arena, size_t size) {
+    size = align_up(size ? size : 1);
+
+    ArenaBlock *block = arena->head;
+    if (!block || block->capacity - block->used < size) {
+        block = new_block(arena, size);
+        if (!block) return NULL;
+    }
+
+    void *ptr = block_data(block) + block->used;
+    block->used += size;
+    return ptr;
+}
+
+/**
+ * 扩大一次已有的分配
+ * 参数：
+ *   ptr: 之前由arena_alloc/arena_grow返回的地址（可以为NULL）
+ *   old_size: 原大小
+ *   new_size: 新大小
+ * 返回值：
+ *   新的地址（内容已保留），失败返回NULL且原内存保持不变
+ * 算法原理：
+ * 如果ptr恰好是当前块中的最后一次分配且剩余空间足够，则原地扩展；
+ * 否则重新分配并复制，旧空间随区域一起释放
+ */
+void* arena_grow(Arena *arena, void *ptr, size_t old_size, size_t new_size) {
+    if (!ptr) {
+        return arena_alloc(arena, new_size);
+    }
+
+    ArenaBlock *block = arena->head;
+    size_t old_aligned = align_up(old_size ? old_size : 1);
+    size_t new_aligned = align_up(new_size);
+    if (block && (unsigned char*)ptr + old_aligned == block_data(block) + block->used &&
+        block->used - old_aligned + new_aligned <= block->capacity) {
+        block->used = block->used - old_aligned + new_aligned;
+        return ptr;
+    }
+
+    void *fresh = arena_alloc(arena, new_size);
+    if (!fresh) return NULL;
+    memcpy(fresh, ptr, old_size);
+    return fresh;
+}
+
+// 释放区域中的全部内存
+void arena_destroy(Arena *arena) {
+    ArenaBlock *block = arena->head;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+}
@@ -0,0 +1,27 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// 内存块链表节点，数据区紧跟在结构体之后
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t capacity;
+    size_t used;
+} ArenaBlock;
+
+// 区域分配器：一次运算中的所有缓冲区都从这里分配，结束时整体释放
+typedef struct {
+    ArenaBlock *head;       // 当前正在使用的块
+    size_t block_size;      // 新块的默认大小
+} Arena;
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+// 函数声明
+void arena_init(Arena *arena, size_t block_size);
+void* arena_alloc(Arena *arena, size_t size);
+void* arena_grow(Arena *arena, void *ptr, size_t old_size, size_t new_size);
+void arena_destroy(Arena *arena);
+
+#endif
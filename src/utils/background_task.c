@@ -0,0 +1,96 @@
+#include "background_task.h"
+#include "error_handler.h"
+#include <pthread.h>
+
+// 一个后台任务：工作线程执行work，结束后把done交给主循环
+typedef struct {
+    BackgroundWork work;
+    GSourceFunc done;
+    gpointer data;
+} BackgroundTask;
+
+static void* background_worker(void *arg) {
+    BackgroundTask *task = arg;
+    task->work(task->data);
+    g_idle_add(task->done, task->data);
+    g_free(task);
+    return NULL;
+}
+
+/**
+ * 在分离的工作线程中执行耗时任务
+ * 参数：
+ *   work: 工作线程中执行的函数
+ *   done: work返回后在主线程中执行的空闲回调，负责更新界面并释放data
+ *   data: 传给两者的数据
+ * 返回值：
+ *   线程创建成功返回true；失败返回false，此时work与done都不会执行
+ * 说明：
+ * 空闲回调按加入顺序执行，work中经g_idle_add发出的进度回调都排在done之前
+ */
+bool background_task_start(BackgroundWork work, GSourceFunc done, gpointer data) {
+    BackgroundTask *task = g_new0(BackgroundTask, 1);
+    task->work = work;
+    task->done = done;
+    task->data = data;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, background_worker, task) != 0) {
+        g_free(task);
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+// 后台生成的报告：生成期间按钮不可用
+typedef struct {
+    GtkWidget *button;
+    ReportBuilder build;
+    int threads;
+    ReportSink show;
+    gchar *report;
+} ReportJob;
+
+static void report_work(gpointer data) {
+    ReportJob *job = data;
+    job->report = job->build(job->threads);
+}
+
+static gboolean report_done(gpointer data) {
+    ReportJob *job = data;
+    gtk_widget_set_sensitive(job->button, TRUE);
+    if (job->report) {
+        job->show(job->report);
+    } else {
+        handle_error(gtk_widget_get_toplevel(job->button), ERROR_MEMORY_ALLOCATION, "内存分配失败");
+    }
+    g_free(job->report);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * 在工作线程中生成报告（如性能测试），完成后在主线程中显示
+ * 参数：
+ *   button: 触发的按钮，生成期间不可用
+ *   build, threads: 生成报告的函数及其参数
+ *   show: 显示报告的函数
+ *   running_text: 生成期间显示的提示
+ */
+void background_report_start(GtkWidget *button, ReportBuilder build, int threads,
+                             ReportSink show, const char *running_text) {
+    ReportJob *job = g_new0(ReportJob, 1);
+    job->button = button;
+    job->build = build;
+    job->threads = threads;
+    job->show = show;
+
+    if (!background_task_start(report_work, report_done, job)) {
+        g_free(job);
+        handle_error(gtk_widget_get_toplevel(button), ERROR_SYSTEM, "无法创建工作线程");
+        return;
+    }
+    gtk_widget_set_sensitive(button, FALSE);
+    show(running_text);
+}
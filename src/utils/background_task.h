@@ -0,0 +1,21 @@
+#ifndef BACKGROUND_TASK_H
+#define BACKGROUND_TASK_H
+
+#include <gtk/gtk.h>
+#include <stdbool.h>
+
+// 在工作线程中执行的任务，不能调用任何GTK函数
+typedef void (*BackgroundWork)(gpointer data);
+
+// 在工作线程中生成文本报告，threads为可使用的线程数；内存不足时返回NULL
+typedef gchar* (*ReportBuilder)(int threads);
+
+// 在主线程中显示文本
+typedef void (*ReportSink)(const char *text);
+
+// 函数声明
+bool background_task_start(BackgroundWork work, GSourceFunc done, gpointer data);
+void background_report_start(GtkWidget *button, ReportBuilder build, int threads,
+                             ReportSink show, const char *running_text);
+
+#endif
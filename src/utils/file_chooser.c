@@ -0,0 +1,28 @@
+#include "file_chooser.h"
+
+/**
+ * 弹出保存对话框选择输出文件
+ * 参数：
+ *   parent: 对话框的父窗口
+ *   title: 对话框标题
+ * 返回值：
+ *   选中的路径（由调用者g_free），取消时返回NULL
+ * 说明：
+ * 选中已存在的文件时先确认覆盖
+ */
+gchar* choose_output_file(GtkWidget *parent, const char *title) {
+    GtkWidget *dialog = gtk_file_chooser_dialog_new(title,
+                                                    GTK_WINDOW(parent),
+                                                    GTK_FILE_CHOOSER_ACTION_SAVE,
+                                                    "取消", GTK_RESPONSE_CANCEL,
+                                                    "保存", GTK_RESPONSE_ACCEPT,
+                                                    NULL);
+    gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER(dialog), TRUE);
+
+    gchar *filename = NULL;
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+    }
+    gtk_widget_destroy(dialog);
+    return filename;
+}
@@ -0,0 +1,9 @@
+#ifndef FILE_CHOOSER_H
+#define FILE_CHOOSER_H
+
+#include <gtk/gtk.h>
+
+// 函数声明
+gchar* choose_output_file(GtkWidget *parent, const char *title);
+
+#endif
@@ -0,0 +1,142 @@
+#include "int_format.h"
+#include <stdint.h>
+#include <string.h>
+
+// 00~99的两位数字表，每次查表输出两位
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 十进制位数
+static inline int count_digits(uint64_t v) {
+    int digits = 1;
+    for (;;) {
+        if (v < 10) return digits;
+        if (v < 100) return digits + 1;
+        if (v < 1000) return digits + 2;
+        if (v < 10000) return digits + 3;
+        v /= 10000;
+        digits += 4;
+    }
+}
+
+/**
+ * 把无符号整数写到dst，返回写入结束的位置（不写'\0'）
+ * 算法原理：
+ * 先求出位数以确定末尾位置，再从低位向高位每次除以100，
+ * 通过查表一次写出两位数字，除法次数减半
+ */
+static inline char* format_unsigned(char *dst, uint64_t v) {
+    int digits = count_digits(v);
+    char *end = dst + digits;
+    char *p = end;
+    while (v >= 100) {
+        unsigned pair = (unsigned)(v % 100) * 2;
+        v /= 100;
+        p -= 2;
+        p[0] = digit_pairs[pair];
+        p[1] = digit_pairs[pair + 1];
+    }
+    if (v >= 10) {
+        p -= 2;
+        p[0] = digit_pairs[v * 2];
+        p[1] = digit_pairs[v * 2 + 1];
+    } else {
+        *--p = (char)('0' + v);
+    }
+    return end;
+}
+
+// 格式化int，dst至少需要INT_FORMAT_MAX_CHARS字节，返回写入结束的位置
+char* int_format_int(char *dst, int value) {
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0) {
+        *dst++ = '-';
+        magnitude = 0u - magnitude;
+    }
+    return format_unsigned(dst, magnitude);
+}
+
+// 格式化long long，dst至少需要INT64_FORMAT_MAX_CHARS字节，返回写入结束的位置
+char* int_format_int64(char *dst, long long value) {
+    uint64_t magnitude = (uint64_t)value;
+    if (value < 0) {
+        *dst++ = '-';
+        magnitude = 0u - magnitude;
+    }
+    return format_unsigned(dst, magnitude);
+}
+
+// 格式化count个整数（含分隔符和结尾'\0'）所需的最大字节数
+size_t int_format_bound(size_t count, size_t separator_length) {
+    return count * (INT_FORMAT_MAX_CHARS + separator_length) + 1;
+}
+
+/**
+ * 把整数数组用分隔符连接成字符串
+ * 参数：
+ *   dst: 输出缓冲区，至少int_format_bound(count, strlen(separator))字节
+ *   values, count: 输入数组
+ *   separator: 分隔符
+ * 返回值：
+ *   写入的字符数（不含'\0'）
+ * 算法原理：
+ * 用一个游标顺序写入预先按上界分配好的缓冲区，总时间O(n)，
+ * 避免strcat每次从头扫描已有字符串造成的O(n²)
+ */
+size_t int_format_join(char *dst, const int *values, size_t count, const char *separator) {
+    IntFormatCursor cursor;
+    int_format_cursor_init(&cursor, values, count, separator);
+    return int_format_next_chunk(&cursor, dst, count);
+}
+
+void int_format_cursor_init(IntFormatCursor *cursor, const int *values, size_t count,
+                            const char *separator) {
+    cursor->values = values;
+    cursor->count = count;
+    cursor->pos = 0;
+    cursor->separator = separator;
+    cursor->separator_length = strlen(separator);
+}
+
+/**
+ * 输出下一段最多max_values个元素
+ * 参数：
+ *   cursor: 格式化游标
+ *   dst: 输出缓冲区，至少int_format_bound(max_values, 分隔符长度)字节
+ *   max_values: 本段最多输出的元素个数
+ * 返回值：
+ *   写入的字符数（不含'\0'）
+ * 说明：
+ * 除第一段外，每段以分隔符开头，各段依次拼接即为完整结果
+ */
+size_t int_format_next_chunk(IntFormatCursor *cursor, char *dst, size_t max_values) {
+    size_t end = cursor->count - cursor->pos < max_values ? cursor->count : cursor->pos + max_values;
+    const char *separator = cursor->separator;
+    size_t separator_length = cursor->separator_length;
+    char *p = dst;
+
+    for (size_t i = cursor->pos; i < end; i++) {
+        if (i > 0) {
+            memcpy(p, separator, separator_length);
+            p += separator_length;
+        }
+        p = int_format_int(p, cursor->values[i]);
+    }
+    *p = '\0';
+
+    cursor->pos = end;
+    return (size_t)(p - dst);
+}
+
+bool int_format_cursor_done(const IntFormatCursor *cursor) {
+    return cursor->pos >= cursor->count;
+}
@@ -0,0 +1,31 @@
+#ifndef INT_FORMAT_H
+#define INT_FORMAT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// 一个int格式化后的最大字符数（"-2147483648"）
+#define INT_FORMAT_MAX_CHARS 11
+// 一个long long格式化后的最大字符数（"-9223372036854775808"）
+#define INT64_FORMAT_MAX_CHARS 20
+
+// 分块格式化游标：每次输出下一段元素，用于逐步填充输出框
+typedef struct {
+    const int *values;
+    size_t count;
+    size_t pos;                 // 下一个待输出元素的下标
+    const char *separator;
+    size_t separator_length;
+} IntFormatCursor;
+
+// 函数声明
+char* int_format_int(char *dst, int value);
+char* int_format_int64(char *dst, long long value);
+size_t int_format_bound(size_t count, size_t separator_length);
+size_t int_format_join(char *dst, const int *values, size_t count, const char *separator);
+void int_format_cursor_init(IntFormatCursor *cursor, const int *values, size_t count,
+                            const char *separator);
+size_t int_format_next_chunk(IntFormatCursor *cursor, char *dst, size_t max_values);
+bool int_format_cursor_done(const IntFormatCursor *cursor);
+
+#endif
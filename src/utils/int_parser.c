@@ -0,0 +1,302 @@
+#include "int_parser.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// 字符分类：分隔符为空白字符与逗号
+#define CLASS_DELIMITER 1
+#define CLASS_DIGIT     2
+
+static const unsigned char char_class[256] = {
+    ['\t'] = CLASS_DELIMITER, ['\n'] = CLASS_DELIMITER, ['\v'] = CLASS_DELIMITER,
+    ['\f'] = CLASS_DELIMITER, ['\r'] = CLASS_DELIMITER, [' '] = CLASS_DELIMITER,
+    [','] = CLASS_DELIMITER,
+    ['0'] = CLASS_DIGIT, ['1'] = CLASS_DIGIT, ['2'] = CLASS_DIGIT, ['3'] = CLASS_DIGIT,
+    ['4'] = CLASS_DIGIT, ['5'] = CLASS_DIGIT, ['6'] = CLASS_DIGIT, ['7'] = CLASS_DIGIT,
+    ['8'] = CLASS_DIGIT, ['9'] = CLASS_DIGIT,
+};
+
+#if defined(__SSE2__)
+// 16字节中属于分隔符的位置掩码：' '、','以及 '\t'..'\r'（连续区间，用无符号比较一次判断）
+static inline int delimiter_mask(__m128i v) {
+    __m128i ws = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(ws, _mm_set1_epi8('\r' - '\t')), ws);
+    __m128i space = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i comma = _mm_cmpeq_epi8(v, _mm_set1_epi8(','));
+    return _mm_movemask_epi8(_mm_or_si128(in_range, _mm_or_si128(space, comma)));
+}
+
+// 16字节中属于数字的位置掩码
+static inline int digit_mask(__m128i v) {
+    __m128i d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d));
+}
+#endif
+
+// 跳过连续的分隔符，返回第一个非分隔符的位置
+static inline size_t skip_delimiters(const unsigned char *p, size_t i, size_t n) {
+#if defined(__SSE2__)
+    while (i + 16 <= n) {
+        int mask = delimiter_mask(_mm_loadu_si128((const __m128i*)(p + i)));
+        if (mask != 0xFFFF) {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+        i += 16;
+    }
+#endif
+    while (i < n && (char_class[p[i]] & CLASS_DELIMITER)) i++;
+    return i;
+}
+
+// 扫描连续的数字，返回第一个非数字的位置
+static inline size_t scan_digits(const unsigned char *p, size_t i, size_t n) {
+#if defined(__SSE2__)
+    while (i + 16 <= n) {
+        int mask = digit_mask(_mm_loadu_si128((const __m128i*)(p + i)));
+        if (mask != 0xFFFF) {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+        i += 16;
+    }
+#endif
+    while (i < n && (char_class[p[i]] & CLASS_DIGIT)) i++;
+    return i;
+}
+
+/**
+ * 把8个ASCII数字一次转换为整数（SWAR）
+ * 算法原理：
+ * 把8字节看作一个64位整数，三轮“乘加-移位”依次把相邻的
+ * 1位、2位、4位数字合并为2位、4位、8位数，整个过程没有分支
+ */
+static inline uint64_t parse_eight_digits(const unsigned char *p) {
+    uint64_t chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+    chunk -= 0x3030303030303030ULL;
+    chunk = ((chunk * 10) + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+    chunk = ((chunk * 100) + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+    chunk = (chunk * 10000) + (chunk >> 32);
+    return chunk & 0xFFFFFFFFULL;
+}
+
+// 累加数字串 p[0..ndigits) 的值，调用者保证结果不超过uint64范围
+static inline uint64_t accumulate_digits(const unsigned char *p, size_t ndigits) {
+    uint64_t acc = 0;
+    size_t k = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; k + 8 <= ndigits; k += 8) {
+        acc = acc * 100000000ULL + parse_eight_digits(p + k);
+    }
+#endif
+    for (; k < ndigits; k++) {
+        acc = acc * 10 + (uint64_t)(p[k] - '0');
+    }
+    return acc;
+}
+
+/**
+ * 解析一个以分隔符（或terminator）结尾的整数
+ * 参数：
+ *   p, n: 文本及长度
+ *   i: 记号起点（已跳过分隔符）
+ *   wide: true按int64解析，false按int32解析
+ *   terminator: 除分隔符外允许紧跟在数字之后的字符，0表示没有
+ *   value: 输出值
+ *   end: 成功时为记号之后的位置，失败时为出错位置
+ * 算法原理：
+ * 1. 数字区间由SIMD扫描一次确定，之后累加不再逐字符判断
+ * 2. 去掉前导0后，位数不超过安全位数（int32为9位、int64为18位）时不可能溢出，
+ *    只有恰好多一位时才需要与上限比较
+ */
+static inline IntParseStatus parse_number(const unsigned char *p, size_t i, size_t n, bool wide,
+                                          unsigned char terminator, long long *value, size_t *end) {
+    size_t start = i;
+    bool negative = false;
+    if (p[i] == '-' || p[i] == '+') {
+        negative = p[i] == '-';
+        i++;
+    }
+
+    size_t digits_end = scan_digits(p, i, n);
+    if (digits_end == i) {
+        *end = i;
+        return INT_PARSE_INVALID_CHAR;
+    }
+    if (digits_end < n && !(char_class[p[digits_end]] & CLASS_DELIMITER) &&
+        (terminator == 0 || p[digits_end] != terminator)) {
+        *end = digits_end;
+        return INT_PARSE_INVALID_CHAR;
+    }
+
+    while (digits_end - i > 1 && p[i] == '0') i++;
+    size_t ndigits = digits_end - i;
+    size_t safe_digits = wide ? 18 : 9;
+    if (ndigits > safe_digits + 1) {
+        *end = start;
+        return INT_PARSE_OVERFLOW;
+    }
+
+    uint64_t magnitude = accumulate_digits(p + i, ndigits);
+    uint64_t limit = wide ? (uint64_t)INT64_MAX : (uint64_t)INT32_MAX;
+    if (magnitude > limit + (negative ? 1 : 0)) {
+        *end = start;
+        return INT_PARSE_OVERFLOW;
+    }
+
+    *value = negative ? (long long)(0 - magnitude) : (long long)magnitude;
+    *end = digits_end;
+    return INT_PARSE_OK;
+}
+
+// 解析一个以分隔符结尾的整数
+static inline IntParseStatus parse_token(const unsigned char *p, size_t i, size_t n, bool wide,
+                                         long long *value, size_t *end) {
+    return parse_number(p, i, n, wide, 0, value, end);
+}
+
+/**
+ * 批量解析以空白或逗号分隔的有符号整数（int32）
+ * 参数：
+ *   text, length: 输入文本（不要求以'\0'结尾）
+ *   pos: 输入为起始位置；返回INT_PARSE_OK时为length，
+ *        返回INT_PARSE_FULL时为下一个记号的起点，出错时为出错的字节偏移
+ *   out, capacity: 输出数组及容量
+ *   count: 本次写入的整数个数
+ * 返回值：
+ *   IntParseStatus
+ * 算法原理：
+ * 分隔符与数字的分类每次处理16字节（SSE2），数字累加每次处理8位（SWAR），
+ * 同一个解析器可以分批调用以控制输出缓冲区大小
+ */
+IntParseStatus int_parse_batch(const char *text, size_t length, size_t *pos,
+                               int *out, size_t capacity, size_t *count) {
+    const unsigned char *p = (const unsigned char*)text;
+    size_t i = skip_delimiters(p, *pos, length);
+    size_t k = 0;
+
+    while (i < length) {
+        if (k == capacity) {
+            *pos = i;
+            *count = k;
+            return INT_PARSE_FULL;
+        }
+
+        long long value;
+        size_t end;
+        IntParseStatus status = parse_token(p, i, length, false, &value, &end);
+        if (status != INT_PARSE_OK) {
+            *pos = end;
+            *count = k;
+            return status;
+        }
+        out[k++] = (int)value;
+        i = skip_delimiters(p, end, length);
+    }
+
+    *pos = length;
+    *count = k;
+    return INT_PARSE_OK;
+}
+
+// 批量解析int64，参数与返回值同int_parse_batch
+IntParseStatus int_parse_batch64(const char *text, size_t length, size_t *pos,
+                                 long long *out, size_t capacity, size_t *count) {
+    const unsigned char *p = (const unsigned char*)text;
+    size_t i = skip_delimiters(p, *pos, length);
+    size_t k = 0;
+
+    while (i < length) {
+        if (k == capacity) {
+            *pos = i;
+            *count = k;
+            return INT_PARSE_FULL;
+        }
+
+        size_t end;
+        IntParseStatus status = parse_token(p, i, length, true, &out[k], &end);
+        if (status != INT_PARSE_OK) {
+            *pos = end;
+            *count = k;
+            return status;
+        }
+        k++;
+        i = skip_delimiters(p, end, length);
+    }
+
+    *pos = length;
+    *count = k;
+    return INT_PARSE_OK;
+}
+
+/**
+ * 批量解析以空白或逗号分隔的整数或区间（int32）
+ * 参数：
+ *   text, length, pos, count: 同int_parse_batch
+ *   out, capacity: 输出数组及可容纳的区间个数，第k个区间为[out[2k], out[2k+1]]
+ * 返回值：
+ *   IntParseStatus；区间下界大于上界时返回INT_PARSE_EMPTY_RANGE
+ * 说明：
+ * 记号为单个整数a（即区间[a, a]）或“a-b”，数字后紧跟的'-'表示区间，
+ * 因此“-5--1”为[-5, -1]，而“1 -5”仍是两个整数
+ */
+IntParseStatus int_parse_ranges(const char *text, size_t length, size_t *pos,
+                                int *out, size_t capacity, size_t *count) {
+    const unsigned char *p = (const unsigned char*)text;
+    size_t i = skip_delimiters(p, *pos, length);
+    size_t k = 0;
+
+    while (i < length) {
+        if (k == capacity) {
+            *pos = i;
+            *count = k;
+            return INT_PARSE_FULL;
+        }
+
+        long long lo, hi;
+        size_t end;
+        IntParseStatus status = parse_number(p, i, length, false, '-', &lo, &end);
+        hi = lo;
+        if (status == INT_PARSE_OK && end < length && p[end] == '-') {
+            end++;
+            status = end < length ? parse_token(p, end, length, false, &hi, &end) : INT_PARSE_INVALID_CHAR;
+            if (status == INT_PARSE_OK && hi < lo) {
+                end = i;
+                status = INT_PARSE_EMPTY_RANGE;
+            }
+        }
+        if (status != INT_PARSE_OK) {
+            *pos = end;
+            *count = k;
+            return status;
+        }
+        out[2 * k] = (int)lo;
+        out[2 * k + 1] = (int)hi;
+        k++;
+        i = skip_delimiters(p, end, length);
+    }
+
+    *pos = length;
+    *count = k;
+    return INT_PARSE_OK;
+}
+
+// 长度为length的文本最多包含的整数个数（每个整数至少1位数字加1个分隔符）
+size_t int_parse_max_tokens(size_t length) {
+    return length / 2 + 1;
+}
+
+// 解析结果的描述
+const char* int_parse_status_string(IntParseStatus status) {
+    switch (status) {
+        case INT_PARSE_OK:           return "解析成功";
+        case INT_PARSE_INVALID_CHAR: return "无效字符";
+        case INT_PARSE_OVERFLOW:     return "数值溢出";
+        case INT_PARSE_FULL:         return "数字个数超出上限";
+        case INT_PARSE_EMPTY_RANGE:  return "区间下界大于上界";
+        default:                     return "未知错误";
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef INT_PARSER_H
+#define INT_PARSER_H
+
+#include <stddef.h>
+
+// 解析结果
+typedef enum {
+    INT_PARSE_OK = 0,
+    INT_PARSE_INVALID_CHAR,     // 出现了数字、正负号与分隔符以外的字符
+    INT_PARSE_OVERFLOW,         // 数值超出目标类型范围
+    INT_PARSE_FULL,             // 输出数组已满，文本尚未解析完
+    INT_PARSE_EMPTY_RANGE       // 区间“a-b”中a大于b
+} IntParseStatus;
+
+// 函数声明
+IntParseStatus int_parse_batch(const char *text, size_t length, size_t *pos,
+                               int *out, size_t capacity, size_t *count);
+IntParseStatus int_parse_batch64(const char *text, size_t length, size_t *pos,
+                                 long long *out, size_t capacity, size_t *count);
+IntParseStatus int_parse_ranges(const char *text, size_t length, size_t *pos,
+                                int *out, size_t capacity, size_t *count);
+size_t int_parse_max_tokens(size_t length);
+const char* int_parse_status_string(IntParseStatus status);
+
+#endif
@@ -0,0 +1,45 @@
+#include "int_vec.h"
+
+#define INT_VEC_MIN_CAPACITY 64
+
+// 初始化数组并预留capacity个元素的空间
+bool int_vec_init(IntVec *vec, Arena *arena, size_t capacity) {
+    vec->data = NULL;
+    vec->size = 0;
+    vec->capacity = 0;
+    vec->arena = arena;
+    return int_vec_reserve(vec, capacity < INT_VEC_MIN_CAPACITY ? INT_VEC_MIN_CAPACITY : capacity);
+}
+
+/**
+ * 确保容量至少为capacity
+ * 算法原理：
+ * 容量不足时按2倍增长，从区域中扩展；
+ * 若数组位于区域末尾则原地扩展，否则复制到新位置
+ * 均摊时间复杂度：O(1)每个元素
+ */
+bool int_vec_reserve(IntVec *vec, size_t capacity) {
+    if (capacity <= vec->capacity) return true;
+
+    size_t new_capacity = vec->capacity ? vec->capacity : INT_VEC_MIN_CAPACITY;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    int *data = arena_grow(vec->arena, vec->data,
+                           vec->capacity * sizeof(int), new_capacity * sizeof(int));
+    if (!data) return false;
+
+    vec->data = data;
+    vec->capacity = new_capacity;
+    return true;
+}
+
+// 在末尾追加一个元素
+bool int_vec_push(IntVec *vec, int value) {
+    if (vec->size == vec->capacity && !int_vec_reserve(vec, vec->size + 1)) {
+        return false;
+    }
+    vec->data[vec->size++] = value;
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef INT_VEC_H
+#define INT_VEC_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// 从区域分配器按几何级数增长的整数数组
+typedef struct {
+    int *data;
+    size_t size;
+    size_t capacity;
+    Arena *arena;
+} IntVec;
+
+// 函数声明
+bool int_vec_init(IntVec *vec, Arena *arena, size_t capacity);
+bool int_vec_reserve(IntVec *vec, size_t capacity);
+bool int_vec_push(IntVec *vec, int value);
+
+#endif
@@ -0,0 +1,130 @@
+#include "loser_tree.h"
+#include <stdlib.h>
+
+/**
+ * 初始化K个来源的败者树
+ * 参数：
+ *   lt: 败者树
+ *   k: 来源个数（至少为1）
+ * 返回值：
+ *   成功返回true，内存不足返回false
+ * 说明：
+ * 初始化后所有来源均视为已取完，调用loser_tree_set设置各来源的首个键后再loser_tree_build
+ */
+bool loser_tree_init(LoserTree *lt, int k) {
+    lt->k = k;
+    lt->tree = malloc(2 * (size_t)k * sizeof(int));
+    lt->keys = malloc((size_t)k * sizeof(long long));
+    lt->exhausted = malloc((size_t)k * sizeof(bool));
+    lt->active = 0;
+    if (k <= 0 || !lt->tree || !lt->keys || !lt->exhausted) {
+        loser_tree_free(lt);
+        return false;
+    }
+    for (int i = 0; i < k; i++) {
+        lt->keys[i] = 0;
+        lt->exhausted[i] = true;
+    }
+    return true;
+}
+
+void loser_tree_free(LoserTree *lt) {
+    free(lt->tree);
+    free(lt->keys);
+    free(lt->exhausted);
+    lt->tree = NULL;
+    lt->keys = NULL;
+    lt->exhausted = NULL;
+    lt->k = 0;
+    lt->active = 0;
+}
+
+// 建树前设置来源的首个键
+void loser_tree_set(LoserTree *lt, int source, long long key) {
+    if (lt->exhausted[source]) lt->active++;
+    lt->keys[source] = key;
+    lt->exhausted[source] = false;
+}
+
+// 建树前把来源标记为空
+void loser_tree_set_exhausted(LoserTree *lt, int source) {
+    if (!lt->exhausted[source]) lt->active--;
+    lt->exhausted[source] = true;
+}
+
+// 来源a是否应排在来源b之前：已取完的来源视为无穷大，键相同时下标小者优先
+static inline bool beats(const LoserTree *lt, int a, int b) {
+    if (lt->exhausted[a]) return false;
+    if (lt->exhausted[b]) return true;
+    if (lt->keys[a] != lt->keys[b]) return lt->keys[a] < lt->keys[b];
+    return a < b;
+}
+
+/**
+ * 自底向上建树
+ * 算法原理：
+ * 叶子i位于结点k+i，结点n的子结点为2n和2n+1（对任意k都构成一棵完全二叉树）；
+ * 每个内部结点比较左右子树的胜者，胜者上传、败者留在该结点。
+ * 内部结点n的胜者暂存在tree[k+n]，子结点编号大于父结点，因此倒序计算即可
+ * 时间复杂度：O(k)
+ */
+void loser_tree_build(LoserTree *lt) {
+    int k = lt->k;
+    int *tree = lt->tree;
+
+    if (k == 1) {
+        tree[0] = 0;
+        return;
+    }
+
+    for (int n = k - 1; n >= 1; n--) {
+        int left = 2 * n, right = 2 * n + 1;
+        int lw = left >= k ? left - k : tree[k + left];
+        int rw = right >= k ? right - k : tree[k + right];
+        if (beats(lt, lw, rw)) {
+            tree[k + n] = lw;
+            tree[n] = rw;
+        } else {
+            tree[k + n] = rw;
+            tree[n] = lw;
+        }
+    }
+    tree[0] = tree[k + 1];
+}
+
+// 当前冠军的来源下标，全部取完时返回-1
+int loser_tree_winner(const LoserTree *lt) {
+    return lt->active > 0 ? lt->tree[0] : -1;
+}
+
+// 当前最小键，调用前须保证loser_tree_winner不为-1
+long long loser_tree_top(const LoserTree *lt) {
+    return lt->keys[lt->tree[0]];
+}
+
+// 沿冠军叶子到根的路径重赛
+static inline void replay(LoserTree *lt) {
+    int *tree = lt->tree;
+    int w = tree[0];
+    for (int n = (w + lt->k) / 2; n >= 1; n /= 2) {
+        if (beats(lt, tree[n], w)) {
+            int t = tree[n];
+            tree[n] = w;
+            w = t;
+        }
+    }
+    tree[0] = w;
+}
+
+// 用冠军来源的下一个键替换当前冠军并重赛
+void loser_tree_replace(LoserTree *lt, long long key) {
+    lt->keys[lt->tree[0]] = key;
+    replay(lt);
+}
+
+// 冠军来源已取完，移出比赛并重赛
+void loser_tree_pop(LoserTree *lt) {
+    lt->exhausted[lt->tree[0]] = true;
+    lt->active--;
+    replay(lt);
+}
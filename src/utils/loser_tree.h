@@ -0,0 +1,31 @@
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+
+#include <stdbool.h>
+
+/**
+ * 败者树（锦标赛树），用于K路归并
+ * 每个内部结点保存该场比赛的败者，tree[0]保存总冠军，
+ * 冠军取出后只需沿其叶子到根的路径重赛一次，比较次数为 ceil(log2 K)
+ * 键相同时下标小的来源获胜，因此相等的键按来源顺序依次输出
+ */
+typedef struct {
+    int k;
+    int *tree;              // tree[0]为冠军，tree[1..k-1]为各内部结点的败者；tree[k+1..2k-1]暂存建树时内部结点的胜者
+    long long *keys;        // 各来源当前的键
+    bool *exhausted;        // 各来源是否已经取完
+    int active;             // 尚未取完的来源个数
+} LoserTree;
+
+// 函数声明
+bool loser_tree_init(LoserTree *lt, int k);
+void loser_tree_free(LoserTree *lt);
+void loser_tree_set(LoserTree *lt, int source, long long key);
+void loser_tree_set_exhausted(LoserTree *lt, int source);
+void loser_tree_build(LoserTree *lt);
+int loser_tree_winner(const LoserTree *lt);
+long long loser_tree_top(const LoserTree *lt);
+void loser_tree_replace(LoserTree *lt, long long key);
+void loser_tree_pop(LoserTree *lt);
+
+#endif
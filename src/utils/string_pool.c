@@ -0,0 +1,146 @@
+#include "string_pool.h"
+#include "xxhash.h"
+#include <string.h>
+#include <limits.h>
+
+#define STRING_POOL_MIN_CAPACITY 64
+// 字符区的初始容量按平均每个字符串的字节数估计
+#define STRING_POOL_AVG_LENGTH 8
+
+// 把区域中的数组扩展到new_count个元素（原地扩展或复制）
+static void* grow_array(Arena *arena, void *data, size_t old_count, size_t new_count, size_t element_size) {
+    return arena_grow(arena, data, old_count * element_size, new_count * element_size);
+}
+
+// 建立容量为table_size（2的幂）的空哈希表，并重新插入已有的全部编号
+static bool rebuild_table(StringPool *pool, size_t table_size) {
+    int32_t *table = arena_alloc(pool->arena, table_size * sizeof(int32_t));
+    if (!table) return false;
+    memset(table, 0xFF, table_size * sizeof(int32_t));
+
+    size_t mask = table_size - 1;
+    for (int id = 0; id < pool->count; id++) {
+        size_t slot = pool->hashes[id] & mask;
+        while (table[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = id;
+    }
+    pool->table = table;
+    pool->table_mask = mask;
+    return true;
+}
+
+/**
+ * 初始化驻留池
+ * 参数：
+ *   pool: 驻留池
+ *   arena: 字符、编号表与哈希表所在的区域
+ *   expected: 预计的不同字符串个数，用于预留空间
+ * 返回值：
+ *   成功返回true，内存不足返回false
+ */
+bool string_pool_init(StringPool *pool, Arena *arena, int expected) {
+    memset(pool, 0, sizeof(*pool));
+    pool->arena = arena;
+
+    int capacity = expected > STRING_POOL_MIN_CAPACITY ? expected : STRING_POOL_MIN_CAPACITY;
+    size_t table_size = 1;
+    while (table_size < (size_t)capacity * 2) {
+        table_size *= 2;
+    }
+
+    pool->chars_capacity = (size_t)capacity * STRING_POOL_AVG_LENGTH;
+    pool->chars = arena_alloc(arena, pool->chars_capacity);
+    pool->offsets = arena_alloc(arena, (size_t)capacity * sizeof(uint32_t));
+    pool->hashes = arena_alloc(arena, (size_t)capacity * sizeof(uint32_t));
+    pool->capacity = capacity;
+    if (!pool->chars || !pool->offsets || !pool->hashes) return false;
+    return rebuild_table(pool, table_size);
+}
+
+// 确保还能再放入一个长度为length的字符串
+static bool reserve_one(StringPool *pool, size_t length) {
+    size_t need = pool->chars_size + length + 1;
+    if (need > UINT32_MAX) return false;
+    if (need > pool->chars_capacity) {
+        size_t capacity = pool->chars_capacity * 2;
+        while (capacity < need) {
+            capacity *= 2;
+        }
+        char *chars = grow_array(pool->arena, pool->chars, pool->chars_capacity, capacity, 1);
+        if (!chars) return false;
+        pool->chars = chars;
+        pool->chars_capacity = capacity;
+    }
+
+    if (pool->count == pool->capacity) {
+        if (pool->capacity > INT_MAX / 2) return false;
+        int capacity = pool->capacity * 2;
+        uint32_t *offsets = grow_array(pool->arena, pool->offsets, (size_t)pool->capacity,
+                                       (size_t)capacity, sizeof(uint32_t));
+        if (!offsets) return false;
+        pool->offsets = offsets;
+        uint32_t *hashes = grow_array(pool->arena, pool->hashes, (size_t)pool->capacity,
+                                      (size_t)capacity, sizeof(uint32_t));
+        if (!hashes) return false;
+        pool->hashes = hashes;
+        pool->capacity = capacity;
+    }
+
+    // 保持装载因子不超过1/2
+    if ((size_t)(pool->count + 1) * 2 > pool->table_mask + 1) {
+        return rebuild_table(pool, (pool->table_mask + 1) * 2);
+    }
+    return true;
+}
+
+/**
+ * 驻留一个字符串
+ * 参数：
+ *   pool: 驻留池
+ *   text, length: 字符串（不要求以'\0'结尾）
+ * 返回值：
+ *   字符串的编号；首次出现的字符串得到下一个编号，内存不足时返回-1
+ * 算法原理：
+ * XXH64哈希后在开放寻址表中线性探测，先比较保存的哈希值，相等时才比较内容；
+ * 新字符串追加到连续的字符区末尾，不为单个字符串单独分配内存
+ * 均摊时间复杂度：O(length)
+ */
+int string_pool_intern(StringPool *pool, const char *text, size_t length) {
+    uint32_t hash = (uint32_t)xxh64(text, length, 0);
+    size_t slot = hash & pool->table_mask;
+    for (int32_t id; (id = pool->table[slot]) >= 0; slot = (slot + 1) & pool->table_mask) {
+        if (pool->hashes[id] == hash && string_pool_length(pool, id) == length &&
+            memcmp(pool->chars + pool->offsets[id], text, length) == 0) {
+            return id;
+        }
+    }
+
+    if (!reserve_one(pool, length)) return -1;
+    // 哈希表重建后原来的空槽位置失效，重新探测
+    slot = hash & pool->table_mask;
+    while (pool->table[slot] >= 0) {
+        slot = (slot + 1) & pool->table_mask;
+    }
+
+    int id = pool->count++;
+    pool->offsets[id] = (uint32_t)pool->chars_size;
+    pool->hashes[id] = hash;
+    memcpy(pool->chars + pool->chars_size, text, length);
+    pool->chars[pool->chars_size + length] = '\0';
+    pool->chars_size += length + 1;
+    pool->table[slot] = id;
+    return id;
+}
+
+// 编号为id的字符串（以'\0'结尾）
+const char* string_pool_get(const StringPool *pool, int id) {
+    return pool->chars + pool->offsets[id];
+}
+
+// 编号为id的字符串的字节数
+size_t string_pool_length(const StringPool *pool, int id) {
+    size_t end = id + 1 < pool->count ? pool->offsets[id + 1] : pool->chars_size;
+    return end - pool->offsets[id] - 1;
+}
@@ -0,0 +1,29 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 字符串驻留池：每个不同的字符串只保存一份，并分配一个从0开始的连续编号
+typedef struct {
+    char *chars;                // 全部字符串首尾相接（各自以'\0'结尾）
+    size_t chars_size;
+    size_t chars_capacity;
+    uint32_t *offsets;          // 编号为id的字符串从chars + offsets[id]开始
+    uint32_t *hashes;           // 各字符串的哈希值，扩容与查找时免去重新计算和多余的比较
+    int count;
+    int capacity;
+    int32_t *table;             // 开放寻址哈希表，存放编号，-1表示空槽
+    size_t table_mask;
+    Arena *arena;
+} StringPool;
+
+// 函数声明
+bool string_pool_init(StringPool *pool, Arena *arena, int expected);
+int string_pool_intern(StringPool *pool, const char *text, size_t length);
+const char* string_pool_get(const StringPool *pool, int id);
+size_t string_pool_length(const StringPool *pool, int id);
+
+#endif
@@ -0,0 +1,11 @@
+#include "xorshift.h"
+
+// xorshift32 伪随机数，性能测试用它生成数据，保证各平台上的测试数据一致
+uint32_t xorshift32_next(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
@@ -0,0 +1,9 @@
+#ifndef XORSHIFT_H
+#define XORSHIFT_H
+
+#include <stdint.h>
+
+// 函数声明
+uint32_t xorshift32_next(uint32_t *state);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef XXHASH_H
+#define XXHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 函数声明
+uint64_t xxh64(const void *input, size_t length, uint64_t seed);
+
+#endif